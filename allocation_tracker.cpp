@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "allocation_tracker.h"
+
+#if defined(OSX)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+std::atomic<bool> AllocationTracker::enabled(false);
+
+// Tags are told apart by their address, so a name used in several places may take several slots. The report merges
+// them by name. Slot 0 is for allocations without a tag, and for all tags once the table is full.
+constexpr int maxTags = 2048;
+static std::atomic<const char*> tagNames[maxTags];
+
+static int getTagIndex(const char* tag) {
+  if (!tag)
+    return 0;
+  auto hash = (reinterpret_cast<uintptr_t>(tag) >> 3) * 2654435761u;
+  for (int i = 0; i < maxTags - 1; ++i) {
+    int index = 1 + (hash + i) % (maxTags - 1);
+    const char* current = tagNames[index].load(std::memory_order_acquire);
+    if (current == tag)
+      return index;
+    if (!current) {
+      if (tagNames[index].compare_exchange_strong(current, tag))
+        return index;
+      if (current == tag)
+        return index;
+    }
+  }
+  return 0;
+}
+
+struct ThreadStats {
+  ThreadStats() {
+    for (int i = 0; i < maxTags; ++i) {
+      allocations[i].store(0);
+      bytes[i].store(0);
+    }
+  }
+  std::atomic<long long> allocations[maxTags];
+  std::atomic<long long> bytes[maxTags];
+  std::atomic<long long> frees{0};
+  std::atomic<long long> freedBytes{0};
+};
+
+// Threads that don't fit into the registry share the last slot.
+constexpr int maxThreads = 256;
+static std::atomic<ThreadStats*> threadStats[maxThreads];
+static std::atomic<int> numThreads{0};
+
+static thread_local long long numAllocations = 0;
+static thread_local const char* currentTag = nullptr;
+static thread_local int currentTagIndex = 0;
+
+long long AllocationTracker::getCount() {
+  return numAllocations;
+}
+
+void AllocationTracker::setEnabled(bool e) {
+  enabled.store(e, std::memory_order_relaxed);
+}
+
+const char* AllocationTracker::setTag(const char* tag) {
+  auto ret = currentTag;
+  currentTag = tag;
+  currentTagIndex = getTagIndex(tag);
+  return ret;
+}
+
+void AllocationTracker::writeReport(std::ostream& out) {
+  map<string, pair<long long, long long>> byTag;
+  long long allocatedBytes = 0;
+  long long freedBytes = 0;
+  for (int thread = 0; thread < min(maxThreads, numThreads.load()); ++thread)
+    if (auto stats = threadStats[thread].load(std::memory_order_acquire)) {
+      long long threadAllocations = 0;
+      long long threadBytes = 0;
+      for (int i = 0; i < maxTags; ++i)
+        if (auto count = stats->allocations[i].load(std::memory_order_relaxed)) {
+          auto name = tagNames[i].load(std::memory_order_acquire);
+          auto& elem = byTag[name ? name : "(untagged)"];
+          auto bytes = stats->bytes[i].load(std::memory_order_relaxed);
+          elem.first += count;
+          elem.second += bytes;
+          threadAllocations += count;
+          threadBytes += bytes;
+        }
+      out << "thread\t" << thread << "\t" << threadAllocations << "\t" << threadBytes << "\t"
+          << stats->frees.load() << "\t" << stats->freedBytes.load() << "\n";
+      allocatedBytes += threadBytes;
+      freedBytes += stats->freedBytes.load();
+    }
+  for (auto& elem : byTag)
+    out << "allocations\t" << elem.first << "\t" << elem.second.first << "\t" << elem.second.second << "\n";
+  out << "allocated\t" << allocatedBytes << "\n";
+  out << "freed\t" << freedBytes << "\n";
+}
+
+#ifndef RELEASE
+
+static size_t getAllocatedSize(void* ptr) {
+#if defined(_MSC_VER)
+  return _msize(ptr);
+#elif defined(OSX)
+  return malloc_size(ptr);
+#else
+  return malloc_usable_size(ptr);
+#endif
+}
+
+static thread_local ThreadStats* myStats = nullptr;
+
+static ThreadStats* getSharedStats() {
+  static ThreadStats stats;
+  return &stats;
+}
+
+// The stats are allocated with malloc, because this is called from operator new.
+static ThreadStats& getMyStats() {
+  if (!myStats) {
+    int index = numThreads.fetch_add(1);
+    if (index < maxThreads - 1) {
+      myStats = new (malloc(sizeof(ThreadStats))) ThreadStats();
+      threadStats[index].store(myStats, std::memory_order_release);
+    } else {
+      myStats = getSharedStats();
+      threadStats[maxThreads - 1].store(myStats, std::memory_order_release);
+    }
+  }
+  return *myStats;
+}
+
+static void recordAllocation(void* ptr) {
+  auto& stats = getMyStats();
+  stats.allocations[currentTagIndex].fetch_add(1, std::memory_order_relaxed);
+  stats.bytes[currentTagIndex].fetch_add(getAllocatedSize(ptr), std::memory_order_relaxed);
+}
+
+static void recordFree(void* ptr) {
+  auto& stats = getMyStats();
+  stats.frees.fetch_add(1, std::memory_order_relaxed);
+  stats.freedBytes.fetch_add(getAllocatedSize(ptr), std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+  ++numAllocations;
+  void* ret = malloc(size > 0 ? size : 1);
+  if (!ret)
+    throw std::bad_alloc();
+  if (AllocationTracker::isEnabled())
+    recordAllocation(ret);
+  return ret;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr && AllocationTracker::isEnabled())
+    recordFree(ptr);
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  operator delete(ptr);
+}
+
+#endif
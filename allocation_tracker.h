@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <iosfwd>
+
+/* Hooks the global operator new and delete, except in release builds, where it counts nothing. Every thread always
+   counts its own allocations, which is cheap and lets a piece of code measure how much it allocates. When tracking
+   is enabled, every thread also keeps the number of allocations and allocated bytes per tag. The tag is the name of
+   the innermost profiler scope, so PROFILE_BLOCK names tell where the memory is allocated. Freed blocks are counted
+   per thread, but they include blocks allocated before tracking was enabled, so they are reported separately and
+   not subtracted from the allocations. */
+class AllocationTracker {
+  public:
+  // Number of allocations made by the calling thread so far. Always 0 in release builds.
+  static long long getCount();
+
+  static bool isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+  }
+  static void setEnabled(bool);
+
+  // Sets the tag of the calling thread's allocations and returns the previous one. Only pass string literals.
+  static const char* setTag(const char*);
+
+  // Writes the totals of every thread as "thread<TAB>index<TAB>allocations<TAB>bytes<TAB>frees<TAB>freed bytes",
+  // one line per tag as "allocations<TAB>tag<TAB>count<TAB>bytes" and the total allocated and freed bytes.
+  static void writeReport(std::ostream&);
+
+  private:
+  static std::atomic<bool> enabled;
+};
@@ -0,0 +1,172 @@
+#include "stdafx.h"
+#include "bit_table.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int popCount(unsigned long long w) {
+#ifdef _MSC_VER
+  return int(__popcnt64(w));
+#else
+  return __builtin_popcountll(w);
+#endif
+}
+
+static int countTrailingZeros(unsigned long long w) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward64(&index, w);
+  return int(index);
+#else
+  return __builtin_ctzll(w);
+#endif
+}
+
+BitTable::BitTable() : BitTable(Rectangle(0, 0)) {
+}
+
+BitTable::BitTable(Rectangle b, bool value) : bounds(b), wordsPerColumn((b.height() + 63) / 64),
+    words(b.width() * wordsPerColumn, value ? ~Word(0) : 0) {
+  if (value)
+    clearPadding();
+}
+
+const Rectangle& BitTable::getBounds() const {
+  return bounds;
+}
+
+bool BitTable::get(Vec2 pos) const {
+  CHECK(pos.inRectangle(bounds));
+  int y = pos.y - bounds.top();
+  return (words[(pos.x - bounds.left()) * wordsPerColumn + y / 64] >> (y % 64)) & 1;
+}
+
+void BitTable::set(Vec2 pos, bool value) {
+  CHECK(pos.inRectangle(bounds));
+  int y = pos.y - bounds.top();
+  auto& word = words[(pos.x - bounds.left()) * wordsPerColumn + y / 64];
+  if (value)
+    word |= Word(1) << (y % 64);
+  else
+    word &= ~(Word(1) << (y % 64));
+}
+
+BitTable& BitTable::operator &= (const BitTable& other) {
+  CHECK(bounds == other.bounds);
+  for (int i : All(words))
+    words[i] &= other.words[i];
+  return *this;
+}
+
+BitTable& BitTable::operator |= (const BitTable& other) {
+  CHECK(bounds == other.bounds);
+  for (int i : All(words))
+    words[i] |= other.words[i];
+  return *this;
+}
+
+void BitTable::invert() {
+  for (auto& word : words)
+    word = ~word;
+  clearPadding();
+}
+
+int BitTable::count() const {
+  int ret = 0;
+  for (auto word : words)
+    ret += popCount(word);
+  return ret;
+}
+
+vector<Vec2> BitTable::getAllSet() const {
+  vector<Vec2> ret;
+  for (int x : Range(bounds.width()))
+    for (int i : Range(wordsPerColumn))
+      for (Word word = words[x * wordsPerColumn + i]; word != 0; word &= word - 1)
+        ret.push_back(Vec2(bounds.left() + x, bounds.top() + i * 64 + countTrailingZeros(word)));
+  return ret;
+}
+
+BitTable::Word BitTable::getWord(int column, int firstBit) const {
+  if (column < 0 || column >= bounds.width() || firstBit >= bounds.height() || firstBit <= -64)
+    return 0;
+  auto getColumnWord = [&](int index) -> Word {
+    return index >= 0 && index < wordsPerColumn ? words[column * wordsPerColumn + index] : 0;
+  };
+  int index = firstBit >= 0 ? firstBit / 64 : -1;
+  int shift = firstBit - index * 64;
+  Word ret = getColumnWord(index) >> shift;
+  if (shift > 0)
+    ret |= getColumnWord(index + 1) << (64 - shift);
+  return ret;
+}
+
+BitTable BitTable::getShifted(Rectangle newBounds, Vec2 offset) const {
+  BitTable ret(newBounds);
+  for (int x : Range(newBounds.width())) {
+    int column = newBounds.left() + x + offset.x - bounds.left();
+    for (int i : Range(ret.wordsPerColumn))
+      ret.words[x * ret.wordsPerColumn + i] = getWord(column, newBounds.top() + i * 64 + offset.y - bounds.top());
+  }
+  ret.clearPadding();
+  return ret;
+}
+
+void BitTable::clearPadding() {
+  if (int used = bounds.height() % 64)
+    for (int x : Range(bounds.width()))
+      words[(x + 1) * wordsPerColumn - 1] &= (Word(1) << used) - 1;
+}
+
+// Adds the tables word by word into four bit-sliced counters and turns them into the result using the function.
+template <typename Fun>
+BitTable BitTable::countWords(const vector<BitTable>& tables, Fun fun) {
+  CHECK(!tables.empty() && tables.size() < 16);
+  BitTable ret(tables[0].bounds);
+  for (int i : All(ret.words)) {
+    Word counter[4] = {0, 0, 0, 0};
+    for (auto& table : tables) {
+      CHECK(table.bounds == ret.bounds);
+      Word carry = table.words[i];
+      for (auto& bit : counter) {
+        Word nextCarry = bit & carry;
+        bit ^= carry;
+        carry = nextCarry;
+      }
+    }
+    ret.words[i] = fun(counter);
+  }
+  ret.clearPadding();
+  return ret;
+}
+
+BitTable BitTable::countAtLeast(const vector<BitTable>& tables, int count) {
+  if (count <= 0)
+    return BitTable(tables[0].bounds, true);
+  if (count > tables.size())
+    return BitTable(tables[0].bounds, false);
+  return countWords(tables, [count](const Word* counter) {
+    Word ret = 0;
+    Word equalSoFar = ~Word(0);
+    for (int bit = 3; bit >= 0; --bit)
+      if ((count >> bit) & 1)
+        equalSoFar &= counter[bit];
+      else {
+        ret |= equalSoFar & counter[bit];
+        equalSoFar &= ~counter[bit];
+      }
+    return ret | equalSoFar;
+  });
+}
+
+BitTable BitTable::countEquals(const vector<BitTable>& tables, int count) {
+  if (count < 0 || count > tables.size())
+    return BitTable(tables[0].bounds, false);
+  return countWords(tables, [count](const Word* counter) {
+    Word ret = ~Word(0);
+    for (int bit : Range(4))
+      ret &= ((count >> bit) & 1) ? counter[bit] : ~counter[bit];
+    return ret;
+  });
+}
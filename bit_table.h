@@ -0,0 +1,42 @@
+#pragma once
+
+#include "util.h"
+
+/* A boolean value for every position of a rectangle, packed 64 to a machine word. Every column is stored
+   separately, so iterating over the set positions follows the order of Rectangle iteration. The whole-table
+   operations work on entire words, which makes combining and counting large areas cheap. */
+class BitTable {
+  public:
+  BitTable();
+  BitTable(Rectangle bounds, bool value = false);
+
+  const Rectangle& getBounds() const;
+  bool get(Vec2) const;
+  void set(Vec2, bool);
+
+  // Both tables must have the same bounds.
+  BitTable& operator &= (const BitTable&);
+  BitTable& operator |= (const BitTable&);
+  void invert();
+
+  int count() const;
+  vector<Vec2> getAllSet() const;
+
+  // Returns a table with the given bounds, in which the value at pos is copied from pos + offset in this table,
+  // or is false if that position is outside of it.
+  BitTable getShifted(Rectangle bounds, Vec2 offset) const;
+
+  // Counts for every position in how many of the tables it's set. All tables must have the same bounds.
+  static BitTable countAtLeast(const vector<BitTable>&, int count);
+  static BitTable countEquals(const vector<BitTable>&, int count);
+
+  private:
+  typedef unsigned long long Word;
+  Word getWord(int column, int firstBit) const;
+  void clearPadding();
+  template <typename Fun>
+  static BitTable countWords(const vector<BitTable>&, Fun);
+  Rectangle bounds;
+  int wordsPerColumn;
+  std::vector<Word> words;
+};
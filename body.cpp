@@ -1018,7 +1018,7 @@ RICH_ENUM(BodyType,
 );
 
 struct BodyTypeReader {
-  static Body* body;
+  static thread_local Body* body;
   void serialize(PrettyInputArchive& ar1, unsigned v) {
     BodyType type;
     BodySize size;
@@ -1051,7 +1051,7 @@ struct BodyTypeReader {
   }
 };
 
-Body* BodyTypeReader::body = nullptr;
+thread_local Body* BodyTypeReader::body = nullptr;
 
 template <>
 void Body::serialize(PrettyInputArchive& ar1, unsigned v) {
@@ -20,6 +20,16 @@ class CallCache {
       return insertValue(key, gen(std::forward<Args>(args)...));
   }
 
+  // Like get(), but the key is a precomputed hash of the arguments, e.g. a GameInfo change stamp.
+  template <typename... Args, typename Generator>
+  Value getStamped(Generator gen, int id, int stamp, Args&&...args) {
+    Key key = {id, stamp};
+    if (auto elem = getValue(key))
+      return *elem;
+    else
+      return insertValue(key, gen(std::forward<Args>(args)...));
+  }
+
   int getSize() const {
     return cache.size();
   }
@@ -39,7 +39,7 @@ vector<OptionId> CampaignBuilder::getCampaignOptions(CampaignType type) const {
       return {OptionId::LESSER_VILLAINS, OptionId::ALLIES};
     case CampaignType::FREE_PLAY:
       if (getPlayerRole() == PlayerRole::ADVENTURER)
-        return {OptionId::MAIN_VILLAINS, OptionId::LESSER_VILLAINS, OptionId::ALLIES};
+        return {OptionId::MAIN_VILLAINS, OptionId::LESSER_VILLAINS, OptionId::ALLIES, OptionId::BACKGROUND_SIMULATION};
       else
         return {
           OptionId::MAIN_VILLAINS,
@@ -47,6 +47,7 @@ vector<OptionId> CampaignBuilder::getCampaignOptions(CampaignType type) const {
           OptionId::ALLIES,
           OptionId::ENDLESS_ENEMIES,
           OptionId::ENEMY_AGGRESSION,
+          OptionId::BACKGROUND_SIMULATION,
         };
     case CampaignType::SINGLE_KEEPER:
       return {};
@@ -379,6 +380,7 @@ optional<CampaignSetup> CampaignBuilder::prepareCampaign(function<optional<Retir
             case OptionId::INFLUENCE_SIZE:
             case OptionId::ENDLESS_ENEMIES:
             case OptionId::ENEMY_AGGRESSION:
+            case OptionId::BACKGROUND_SIMULATION:
               break;
             default:
               updateMap = true;
@@ -56,6 +56,8 @@
 #include "game_event.h"
 #include "view_object.h"
 #include "content_factory.h"
+#include "debug_checks.h"
+#include "memory_report.h"
 
 template <class Archive>
 void Collective::serialize(Archive& ar, const unsigned int version) {
@@ -180,6 +182,7 @@ void Collective::addCreature(Creature* c, EnumSet<MinionTrait> traits) {
   populationGroups.push_back({c});
   for (MinionTrait t : traits)
     byTrait[t].push_back(c);
+  ++creaturesVersion;
   updateCreatureStatus(c);
   for (Item* item : c->getEquipment().getItems())
     CHECK(minionEquipment->tryToOwn(c, item));
@@ -203,6 +206,7 @@ void Collective::removeCreature(Creature* c) {
   for (MinionTrait t : ENUM_ALL(MinionTrait))
     if (byTrait[t].contains(c))
       byTrait[t].removeElement(c);
+  ++creaturesVersion;
   updateCreatureStatus(c);
 }
 
@@ -301,6 +305,14 @@ const vector<Creature*>& Collective::getCreatures() const {
   return creatures;
 }
 
+void Collective::addMemoryUsage(MemoryReport& report) const {
+  report.add("creatures", getMemoryUsage(creatures));
+  report.add("known tiles", getNodeMemoryUsage(knownTiles->getAll()) +
+      getNodeMemoryUsage(knownTiles->getBorderTiles()));
+  report.add("territory", getNodeMemoryUsage(territory->getAllAsSet()) + getMemoryUsage(territory->getAll()));
+  report.add("tasks", taskMap->getAllTasks().size() * sizeof(Task));
+}
+
 void Collective::setMinionActivity(Creature* c, MinionActivity activity) {
   auto current = getCurrentActivity(c);
   if (current.activity != activity) {
@@ -499,13 +511,20 @@ bool Collective::hasTrait(const Creature* c, MinionTrait t) const {
 void Collective::setTrait(Creature* c, MinionTrait t) {
   if (!hasTrait(c, t)) {
     byTrait[t].push_back(c);
+    ++creaturesVersion;
     updateCreatureStatus(c);
   }
 }
 
 void Collective::removeTrait(Creature* c, MinionTrait t) {
-  if (byTrait[t].removeElementMaybe(c))
+  if (byTrait[t].removeElementMaybe(c)) {
+    ++creaturesVersion;
     updateCreatureStatus(c);
+  }
+}
+
+int Collective::getCreaturesVersion() const {
+  return creaturesVersion;
 }
 
 void Collective::addMoraleForKill(const Creature* killer, const Creature* victim) {
@@ -582,7 +601,7 @@ void Collective::onEvent(const GameEvent& event) {
       [&](const TrapTriggered& info) {
         if (auto trap = constructions->getTrap(info.pos)) {
           trap->reset();
-          if (trap->getType() == FurnitureType("SURPRISE_TRAP"))
+          if (trap->getType() == CONTENT_ID(FurnitureType, "SURPRISE_TRAP"))
             handleSurprise(info.pos);
         }
       },
@@ -706,8 +725,8 @@ GlobalTime Collective::getGlobalTime() const {
   return getGame()->getGlobalTime();
 }
 
-int Collective::numResource(ResourceId id) const {
-  int ret = credit[id];
+int Collective::countStoredResource(ResourceId id) const {
+  int ret = 0;
   if (auto itemIndex = config->getResourceInfo(id).itemIndex)
     if (auto storage = config->getResourceInfo(id).storageId)
       for (auto& pos : getStoragePositions(*storage))
@@ -715,6 +734,24 @@ int Collective::numResource(ResourceId id) const {
   return ret;
 }
 
+int Collective::getStoredResource(ResourceId id) const {
+  // The count only changes when items are moved in the model or the storage positions change.
+  auto version = make_pair(model->getItemsVersion(), zones->getVersion() + constructions->getBuiltPositionsVersion());
+  auto& cached = storedResourceCache[id];
+  if (!cached || cached->version != version)
+    cached = StoredResourceCount{version, countStoredResource(id)};
+  else if (DebugChecks::isEnabled()) {
+    auto count = countStoredResource(id);
+    CHECK(cached->count == count) << "Cached count of " << EnumInfo<ResourceId>::getString(id) << " is "
+        << cached->count << ", actual " << count;
+  }
+  return cached->count;
+}
+
+int Collective::numResource(ResourceId id) const {
+  return credit[id] + getStoredResource(id);
+}
+
 int Collective::numResourcePlusDebt(ResourceId id) const {
   return numResource(id) - getDebt(id);
 }
@@ -1117,9 +1154,9 @@ const PositionSet& Collective::getStoragePositions(StorageId storage) const {
     case StorageId::EQUIPMENT:
       return zones->getPositions(ZoneId::STORAGE_EQUIPMENT);
     case StorageId::GOLD:
-      return constructions->getBuiltPositions(FurnitureType("TREASURE_CHEST"));
+      return constructions->getBuiltPositions(CONTENT_ID(FurnitureType, "TREASURE_CHEST"));
     case StorageId::CORPSES:
-      return constructions->getBuiltPositions(FurnitureType("GRAVE"));
+      return constructions->getBuiltPositions(CONTENT_ID(FurnitureType, "GRAVE"));
   }
 }
 
@@ -1198,11 +1235,11 @@ void Collective::onAppliedSquare(Creature* c, pair<Position, FurnitureLayer> pos
     double efficiency = furniture->getUsageTime().getVisibleDouble() * getEfficiency(c);
     if (furniture->isRequiresLight())
       efficiency *= pos.first.getLightingEfficiency();
-    if (furniture->getType() == FurnitureType("WHIPPING_POST"))
+    if (furniture->getType() == CONTENT_ID(FurnitureType, "WHIPPING_POST"))
       taskMap->addTask(Task::whipping(pos.first, c), pos.first, MinionActivity::WORKING);
-    if (furniture->getType() == FurnitureType("GALLOWS"))
+    if (furniture->getType() == CONTENT_ID(FurnitureType, "GALLOWS"))
       taskMap->addTask(Task::kill(this, c), pos.first, MinionActivity::WORKING);
-    if (furniture->getType() == FurnitureType("TORTURE_TABLE"))
+    if (furniture->getType() == CONTENT_ID(FurnitureType, "TORTURE_TABLE"))
       taskMap->addTask(Task::torture(this, c), pos.first, MinionActivity::WORKING);
     if (auto usage = furniture->getUsageType()) {
       auto increaseLevel = [&] (ExperienceType exp) {
@@ -1284,7 +1321,7 @@ double Collective::getDangerLevel() const {
     double ret = 0;
     for (const Creature* c : getCreatures(MinionTrait::FIGHTER))
       ret += c->getDifficultyPoints();
-    ret += constructions->getBuiltCount(FurnitureType("IMPALED_HEAD")) * 150;
+    ret += constructions->getBuiltCount(CONTENT_ID(FurnitureType, "IMPALED_HEAD")) * 150;
     dangerLevelCache = ret;
   }
   return *dangerLevelCache;
@@ -51,6 +51,7 @@ class Immigration;
 class Quarters;
 class PositionMatching;
 class MinionActivities;
+class MemoryReport;
 
 class Collective : public TaskCallback, public UniqueEntity<Collective>, public EventListener<Collective> {
   public:
@@ -90,12 +91,15 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   SERIALIZATION_DECL(Collective)
 
   const vector<Creature*>& getCreatures() const;
+  void addMemoryUsage(MemoryReport&) const;
   bool isConquered() const;
 
   const vector<Creature*>& getCreatures(MinionTrait) const;
   bool hasTrait(const Creature*, MinionTrait) const;
   void setTrait(Creature* c, MinionTrait);
   void removeTrait(Creature* c, MinionTrait);
+  // Changes whenever a creature is added, removed or gets or loses a trait.
+  int getCreaturesVersion() const;
 
   bool hasTradeItems() const;
   vector<Item*> getTradeItems() const;
@@ -250,6 +254,14 @@ class Collective : public TaskCallback, public UniqueEntity<Collective>, public
   bool isItemNeeded(const Item*) const;
   void addProducesMessage(const Creature*, const vector<PItem>&);
   int getDebt(ResourceId id) const;
+  int countStoredResource(ResourceId) const;
+  int getStoredResource(ResourceId) const;
+  struct StoredResourceCount {
+    pair<int, int> version;
+    int count;
+  };
+  mutable EnumMap<ResourceId, optional<StoredResourceCount>> storedResourceCache;
+  int creaturesVersion = 0;
 
   PPositionMatching SERIAL(positionMatching);
   HeapAllocated<MinionEquipment> SERIAL(minionEquipment);
@@ -64,6 +64,18 @@ CollectiveBuilder& CollectiveBuilder::addArea(const vector<Vec2>& v) {
   return *this;
 }
 
+CollectiveBuilder::Checkpoint CollectiveBuilder::getCheckpoint() const {
+  return Checkpoint{creatures.size(), squares.size(), centralPoint};
+}
+
+void CollectiveBuilder::rollback(const Checkpoint& checkpoint) {
+  while (creatures.size() > checkpoint.numCreatures)
+    creatures.pop_back();
+  while (squares.size() > checkpoint.numSquares)
+    squares.pop_back();
+  centralPoint = checkpoint.centralPoint;
+}
+
 optional<CollectiveName> CollectiveBuilder::generateName() const {
   if (!creatures.empty()) {
     CollectiveName ret;
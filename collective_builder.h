@@ -31,6 +31,15 @@ class CollectiveBuilder {
   PCollective build(const ContentFactory*) const;
   bool hasCreatures() const;
 
+  // Used by LevelBuilder to undo the changes made by a failed LevelMaker.
+  struct Checkpoint {
+    int numCreatures;
+    int numSquares;
+    optional<Vec2> centralPoint;
+  };
+  Checkpoint getCheckpoint() const;
+  void rollback(const Checkpoint&);
+
   private:
   optional<CollectiveName> getCollectiveName();
   WModel model = nullptr;
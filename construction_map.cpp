@@ -81,6 +81,7 @@ void ConstructionMap::onFurnitureDestroyed(Position pos, FurnitureLayer layer) {
   if (auto info = furniture[layer].getReferenceMaybe(pos)) {
     addDebt(info->getCost());
     furniturePositions[info->getFurnitureType()].erase(pos);
+    ++builtPositionsVersion;
     info->reset();
   }
 }
@@ -90,9 +91,10 @@ void ConstructionMap::addFurniture(Position pos, const FurnitureInfo& info, Furn
   allFurniture.push_back({pos, layer});
   furniture[layer].set(pos, info);
   pos.setNeedsRenderAndMemoryUpdate(true);
-  if (info.isBuilt(pos, layer))
+  if (info.isBuilt(pos, layer)) {
     furniturePositions[info.getFurnitureType()].insert(pos);
-  else {
+    ++builtPositionsVersion;
+  } else {
     ++unbuiltCounts[info.getFurnitureType()];
     addDebt(info.getCost());
   }
@@ -118,6 +120,10 @@ const PositionSet& ConstructionMap::getBuiltPositions(FurnitureType type) const
     return empty;
 }
 
+int ConstructionMap::getBuiltPositionsVersion() const {
+  return builtPositionsVersion;
+}
+
 const vector<pair<Position, FurnitureLayer>>& ConstructionMap::getAllFurniture() const {
   return allFurniture;
 }
@@ -127,6 +133,7 @@ void ConstructionMap::onConstructed(Position pos, FurnitureType type) {
   if (!containsFurniture(pos, layer))
     addFurniture(pos, FurnitureInfo::getBuilt(type), layer);
   furniturePositions[type].insert(pos);
+  ++builtPositionsVersion;
   --unbuiltCounts[type];
   if (furniture[layer].contains(pos)) { // why this if?
     auto& info = furniture[layer].getOrInit(pos);
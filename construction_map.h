@@ -61,6 +61,8 @@ class ConstructionMap {
   int getBuiltCount(FurnitureType) const;
   int getTotalCount(FurnitureType) const;
   const PositionSet& getBuiltPositions(FurnitureType) const;
+  // Changes whenever the result of getBuiltPositions() may have changed.
+  int getBuiltPositionsVersion() const;
   void onConstructed(Position, FurnitureType);
   void clearUnsupportedFurniturePlans();
 
@@ -85,5 +87,6 @@ class ConstructionMap {
   PositionMap<TrapInfo> SERIAL(traps);
   vector<Position> SERIAL(allTraps);
   EnumMap<CollectiveResourceId, int> SERIAL(debt);
+  int builtPositionsVersion = 0;
   void addDebt(const CostInfo&);
 };
@@ -182,7 +182,8 @@ optional<string> ContentFactory::readItems(const GameConfig* config, KeyVerifier
   return none;
 }
 
-optional<string> ContentFactory::readData(NameGenerator nameGenerator, const GameConfig* config) {
+optional<string> ContentFactory::readData(NameGenerator nameGenerator, const GameConfig* config,
+    map<string, set<string>>* keys) {
   KeyVerifier keyVerifier;
   if (auto error = config->readObject(technology, GameConfigId::TECHNOLOGY, &keyVerifier))
     return *error;
@@ -235,9 +236,12 @@ optional<string> ContentFactory::readData(NameGenerator nameGenerator, const Gam
         return "No resource distribution found for depth " + toString(depth) + ". Please fix resources config.";
     }
   }
+  ContentIdLiterals::verify(&keyVerifier);
   auto errors = keyVerifier.verify();
   if (!errors.empty())
     return errors.front();
+  if (keys)
+    *keys = keyVerifier.getKeys();
   return none;
 }
 
@@ -19,7 +19,8 @@ class KeyVerifier;
 
 class ContentFactory {
   public:
-  optional<string> readData(NameGenerator, const GameConfig*);
+  // If keys is given, it receives the keys of the parsed content, see KeyVerifier::getKeys.
+  optional<string> readData(NameGenerator, const GameConfig*, map<string, set<string>>* keys = nullptr);
   FurnitureFactory SERIAL(furniture);
   array<vector<ZLevelInfo>, 3> SERIAL(zLevels);
   vector<ResourceDistribution> SERIAL(resources);
@@ -35,6 +36,11 @@ class ContentFactory {
   GameIntros SERIAL(gameIntros);
   PlayerCreaturesInfo SERIAL(playerCreatures);
   map<CustomItemId, ItemAttributes> SERIAL(items);
+  // Attributes of the item types, shared by all their items without a prefix. They are filled by ItemType::get
+  // and not serialized. The items of a game are created by one thread at a time.
+  mutable unordered_map<CustomItemId, shared_ptr<const ItemAttributes>, CustomHash<CustomItemId>>
+      sharedCustomItemAttributes;
+  mutable unordered_map<string, shared_ptr<const ItemAttributes>> sharedItemAttributes;
   void merge(ContentFactory);
 
   CreatureFactory& getCreatures();
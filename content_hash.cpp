@@ -0,0 +1,39 @@
+#include "stdafx.h"
+#include "content_hash.h"
+#include "file_path.h"
+#include "directory_path.h"
+
+void ContentHash::addBytes(const char* data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= (unsigned char) data[i];
+    hash *= 1099511628211ULL;
+  }
+}
+
+void ContentHash::add(const string& s) {
+  addBytes(s.data(), s.size() + 1);
+}
+
+void ContentHash::add(const FilePath& file) {
+  add(file.getFileName());
+  if (auto contents = file.readContents())
+    add(*contents);
+}
+
+void ContentHash::addDirectory(const DirectoryPath& dir) {
+  auto files = dir.getFiles();
+  sort(files.begin(), files.end(),
+      [](const FilePath& f1, const FilePath& f2) { return strcmp(f1.getFileName(), f2.getFileName()) < 0; });
+  for (auto& file : files)
+    add(file);
+  auto subdirs = dir.getSubDirs();
+  sort(subdirs.begin(), subdirs.end());
+  for (auto& subdir : subdirs) {
+    add(subdir);
+    addDirectory(dir.subdirectory(subdir));
+  }
+}
+
+unsigned long long ContentHash::get() const {
+  return hash;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "util.h"
+
+class FilePath;
+class DirectoryPath;
+
+/* FNV-1a hash of strings and files, used as the key of caches stored in the user directory. Unlike
+   combineHash it doesn't depend on the standard library implementation, so it's stable between runs. */
+class ContentHash {
+  public:
+  void add(const string&);
+  // Adds the name and contents of the file.
+  void add(const FilePath&);
+  // Adds all files and subdirectories, sorted by name.
+  void addDirectory(const DirectoryPath&);
+  unsigned long long get() const;
+
+  private:
+  void addBytes(const char*, size_t);
+  unsigned long long hash = 14695981039346656037ULL;
+};
@@ -9,6 +9,7 @@
 #include "creature_id.h"
 #include "spell_school_id.h"
 #include "custom_item_id.h"
+#include "key_verifier.h"
 #include <cassert>
 
 static const char* staticsInitialized = nullptr;
@@ -18,15 +19,26 @@ void setInitializedStatics() {
 }
 
 
+// Content can be loaded by several threads at once, e.g. when battles are simulated in parallel. The strings are
+// kept in a deque, so they don't move when new ids are added.
+static std::mutex idsMutex;
+
 template<typename T>
-vector<string>& ContentId<T>::getAllIds() {
-  static vector<string> ret;
+deque<string>& ContentId<T>::getAllIds() {
+  static deque<string> ret;
   assert(staticsInitialized && !strcmp(staticsInitialized, "initialized"));
   return ret;
 }
 
+template <typename T>
+const string& ContentId<T>::getIdString(InternalId id) {
+  std::lock_guard<std::mutex> lock(idsMutex);
+  return getAllIds()[id];
+}
+
 template <typename T>
 int ContentId<T>::getId(const char* text) {
+  std::lock_guard<std::mutex> lock(idsMutex);
   static unordered_map<string, int> ids;
   static int generatedId = 0;
   if (!ids.count(text)) {
@@ -76,7 +88,7 @@ int ContentId<T>::getHash() const {
 
 template <typename T>
 const char* ContentId<T>::data() const {
-  return getAllIds()[id].data();
+  return getIdString(id).data();
 }
 
 template <typename T>
@@ -89,30 +101,116 @@ std::ostream& operator <<(std::ostream& d, ContentId<T> id) {
   return d << id.data();
 }
 
+static vector<pair<std::type_index, const char*>>& getLiterals() {
+  static vector<pair<std::type_index, const char*>> ret;
+  return ret;
+}
+
+bool ContentIdLiterals::add(const std::type_info& type, const char* name) {
+  getLiterals().push_back(make_pair(std::type_index(type), name));
+  return true;
+}
+
+void ContentIdLiterals::verify(KeyVerifier* keyVerifier) {
+  for (auto& elem : getLiterals())
+    keyVerifier->verifyContentId(elem.first, elem.second);
+}
+
+vector<string> ContentIdLiterals::verify(const map<string, set<string>>& keys) {
+  vector<string> ret;
+  for (auto& elem : getLiterals()) {
+    auto typeKeys = getReferenceMaybe(keys, elem.first.name());
+    if (!typeKeys || !typeKeys->count(elem.second))
+      ret.push_back(elem.first.name() + " not found: \""_s + elem.second + "\"");
+  }
+  return ret;
+}
+
+static thread_local ContentIdTable* currentTable = nullptr;
+
+ContentIdTable::ContentIdTable(const void* archive) : archive(archive), previous(currentTable) {
+  currentTable = this;
+}
+
+ContentIdTable::~ContentIdTable() {
+  currentTable = previous;
+}
+
+ContentIdTable* ContentIdTable::get(const void* archive) {
+  for (auto table = currentTable; table; table = table->previous)
+    if (table->archive == archive)
+      return table;
+  return nullptr;
+}
+
+int ContentIdTable::getNewTypeIndex() {
+  static atomic<int> numTypes(0);
+  return numTypes++;
+}
+
+ContentIdTable::TypeTable& ContentIdTable::getTypeTable(int typeIndex) {
+  if (typeIndex >= typeTables.size())
+    typeTables.resize(typeIndex + 1);
+  return typeTables[typeIndex];
+}
+
+template <typename T>
+int ContentId<T>::getTypeIndex() {
+  static const int index = ContentIdTable::getNewTypeIndex();
+  return index;
+}
+
 template <typename T>
 template <class Archive>
-void ContentId<T>::serialize(Archive& ar1, const unsigned int) {
-  if (Archive::is_loading::value) {
+void ContentId<T>::serializeId(Archive& ar1, InternalId& id) {
+  if (auto table = ContentIdTable::get(&ar1)) {
+    auto& typeTable = table->getTypeTable(getTypeIndex());
+    int index;
+    if (Archive::is_loading::value) {
+      ar1(index);
+      if (index == typeTable.loadedIds.size()) {
+        string s;
+        ar1(s);
+        typeTable.loadedIds.push_back(getId(s.data()));
+      }
+      if (index < 0 || index >= typeTable.loadedIds.size())
+        throw cereal::Exception("Bad content id index: " + toString(index));
+      id = typeTable.loadedIds[index];
+    } else {
+      // Stores the table index plus one, so that zero marks ids that weren't written yet.
+      auto& indexes = typeTable.savedIndexes;
+      if (id >= indexes.size())
+        indexes.resize(id + 1);
+      bool firstOccurrence = indexes[id] == 0;
+      if (firstOccurrence)
+        indexes[id] = ++typeTable.numSaved;
+      index = indexes[id] - 1;
+      ar1(index);
+      if (firstOccurrence) {
+        string s = getIdString(id);
+        ar1(s);
+      }
+    }
+  } else if (Archive::is_loading::value) {
     string s;
     ar1(s);
     id = getId(s.data());
   } else {
-    string s = data();
+    string s = getIdString(id);
     ar1(s);
   }
 }
 
+template <typename T>
+template <class Archive>
+void ContentId<T>::serialize(Archive& ar1, const unsigned int) {
+  serializeId(ar1, id);
+}
+
 template <typename T>
 template <class Archive>
 void PrimaryId<T>::serialize(Archive& ar1, const unsigned int) {
-  if (Archive::is_loading::value) {
-    string s;
-    ar1(s);
-    id = ContentId<T>::getId(s.data());
-  } else {
-    string s = data();
-    ar1(s);
-  }
+  ContentId<T>::serializeId(ar1, id);
 }
 
 template<typename T>
@@ -141,7 +239,7 @@ int PrimaryId<T>::getHash() const {
 
 template<typename T>
 const char* PrimaryId<T>::data() const {
-  return ContentId<T>::getAllIds()[id].data();
+  return ContentId<T>::getIdString(id).data();
 }
 
 template<typename T>
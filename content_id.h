@@ -28,12 +28,42 @@ class ContentId {
   private:
   friend PrimaryId<T>;
   InternalId id;
-  static vector<string>& getAllIds();
+  static deque<string>& getAllIds();
+  static const string& getIdString(InternalId);
   static int getId(const char* text);
+  static int getTypeIndex();
+  template <class Archive>
+  static void serializeId(Archive&, InternalId&);
 };
 
 void setInitializedStatics();
 
+/* While an instance is alive, ContentIds and PrimaryIds that the current thread serializes through the given
+   archive are stored as indices into a per-archive string table. Each id string is written only once, right
+   after its first index. An archive written with a table must be read with one. */
+class ContentIdTable {
+  public:
+  ContentIdTable(const void* archive);
+  ~ContentIdTable();
+  ContentIdTable(const ContentIdTable&) = delete;
+  ContentIdTable& operator = (const ContentIdTable&) = delete;
+
+  private:
+  template <typename T>
+  friend class ContentId;
+  struct TypeTable {
+    vector<int> loadedIds;
+    vector<int> savedIndexes;
+    int numSaved = 0;
+  };
+  static ContentIdTable* get(const void* archive);
+  static int getNewTypeIndex();
+  TypeTable& getTypeTable(int typeIndex);
+  const void* archive;
+  vector<TypeTable> typeTables;
+  ContentIdTable* previous;
+};
+
 template <typename T>
 class PrimaryId {
   public:
@@ -50,6 +80,39 @@ class PrimaryId {
   typename ContentId<T>::InternalId id;
 };
 
+class KeyVerifier;
+
+/* Names of the ids used through CONTENT_ID, collected during static initialization so that they can be checked
+   against the loaded content. */
+class ContentIdLiterals {
+  public:
+  static bool add(const std::type_info&, const char* name);
+  static void verify(KeyVerifier*);
+  // Checks the names against keys returned by KeyVerifier::getKeys.
+  static vector<string> verify(const map<string, set<string>>& keys);
+};
+
+template <typename T, typename Name>
+class InternedContentId {
+  public:
+  static const T& get() {
+    (void) registered;
+    static const T id(Name::get());
+    return id;
+  }
+
+  private:
+  static const bool registered;
+};
+
+template <typename T, typename Name>
+const bool InternedContentId<T, Name>::registered = ContentIdLiterals::add(typeid(T), Name::get());
+
+// Constructs the id from the string only once per call site, afterwards it's just a copy of the internal id.
+#define CONTENT_ID(T, name) ([] {\
+  struct Name { static const char* get() { return name; } };\
+  return InternedContentId<T, Name>::get(); }())
+
 template <typename Key, typename Value>
 map<Key, Value> convertKeys(map<PrimaryId<Key>, Value> m) {
   map<Key, Value> ret;
@@ -51,6 +51,8 @@
 #include "weapon_info.h"
 #include "time_queue.h"
 #include "profiler.h"
+#include "perf_counters.h"
+#include "morale_influence.h"
 #include "furniture_type.h"
 #include "furniture_usage.h"
 #include "fx_name.h"
@@ -331,7 +333,7 @@ CreatureAction Creature::move(Position pos, optional<Position> nextPos) const {
   }
   return CreatureAction(this, [=](Creature* self) {
   PROFILE;
-    INFO << getName().the() << " moving " << direction;
+    INFO_IN(CREATURES) << getName().the() << " moving " << direction;
     if (isAffected(LastingEffect::ENTANGLED) || isAffected(LastingEffect::TIED_UP)) {
       secondPerson("You can't break free!");
       thirdPerson(getName().the() + " can't break free!");
@@ -450,10 +452,11 @@ void Creature::makeMove() {
     // Calls makeMove() while preventing Controller destruction by holding a shared_ptr on stack.
     // This is needed, otherwise Controller could be destroyed during makeMove() if creature committed suicide.
     shared_ptr<Controller> controllerTmp = controllerStack.back().giveMeSharedPointer();
+    PerfTimer timer(PerfCounter::CREATURE_MOVE_TIME);
     MEASURE(controllerTmp->makeMove(), "creature move time");
   }
   updateViewObject();
-  INFO << getName().bare() << " morale " << getMorale();
+  INFO_IN(CREATURES) << getName().bare() << " morale " << getMorale();
   unknownAttackers.clear();
   getBody().affectPosition(position);
   highestAttackValueEver = max(highestAttackValueEver, getBestAttack().value);
@@ -463,7 +466,7 @@ void Creature::makeMove() {
 CreatureAction Creature::wait() {
   return CreatureAction([=](Creature* self) {
     self->nextPosIntent = none;
-    INFO << self->getName().the() << " waiting";
+    INFO_IN(CREATURES) << self->getName().the() << " waiting";
     bool keepHiding = self->hidden;
     self->spendTime();
     self->hidden = keepHiding;
@@ -567,7 +570,7 @@ CreatureAction Creature::pickUp(const vector<Item*>& itemsAll) const {
   if (items.empty())
     return CreatureAction("You are carrying too much to pick this up.");
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " pickup ";
+    INFO_IN(CREATURES) << getName().the() << " pickup ";
     for (auto stack : stackItems(items)) {
       thirdPerson(getName().the() + " picks up " + getPluralAName(stack[0], stack.size()));
       secondPerson("You pick up " + getPluralTheName(stack[0], stack.size()));
@@ -589,7 +592,7 @@ vector<vector<Item*>> Creature::stackItems(vector<Item*> items) const {
 
 CreatureAction Creature::drop(const vector<Item*>& items) const {
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " drop";
+    INFO_IN(CREATURES) << getName().the() << " drop";
     for (auto stack : stackItems(items)) {
       thirdPerson(getName().the() + " drops " + getPluralAName(stack[0], stack.size()));
       secondPerson("You drop " + getPluralTheName(stack[0], stack.size()));
@@ -657,7 +660,7 @@ CreatureAction Creature::equip(Item* item) const {
   if (equipment->getSlotItems(item->getEquipmentSlot()).contains(item))
     return CreatureAction();
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " equip " << item->getName();
+    INFO_IN(CREATURES) << getName().the() << " equip " << item->getName();
     EquipmentSlot slot = item->getEquipmentSlot();
     if (self->equipment->getSlotItems(slot).size() >= self->equipment->getMaxItems(slot, this)) {
       Item* previousItem = self->equipment->getSlotItems(slot)[0];
@@ -680,7 +683,7 @@ CreatureAction Creature::unequip(Item* item) const {
   if (getBody().numGood(BodyPart::ARM) == 0)
     return CreatureAction("You have no healthy arms!");
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " unequip";
+    INFO_IN(CREATURES) << getName().the() << " unequip";
     CHECK(equipment->isEquipped(item)) << "Item not equipped.";
     EquipmentSlot slot = item->getEquipmentSlot();
     secondPerson("You " + string(slot == EquipmentSlot::WEAPON ? " sheathe " : " remove ") +
@@ -712,7 +715,7 @@ CreatureAction Creature::applySquare(Position pos, FurnitureLayer layer) const {
     if (furniture->canUse(this))
       return CreatureAction(this, [=](Creature* self) {
         self->nextPosIntent = none;
-        INFO << getName().the() << " applying " << getPosition().getName();
+        INFO_IN(CREATURES) << getName().the() << " applying " << getPosition().getName();
         auto originalPos = getPosition();
         auto usageTime = furniture->getUsageTime();
         furniture->use(pos, self);
@@ -974,7 +977,7 @@ void Creature::considerMovingFromInaccessibleSquare() {
   auto movement = getMovementType();
   auto forced = getMovementType().setForced();
   if (!position.canEnterEmpty(forced))
-    for (auto neighbor : position.neighbors8(Random))
+    for (auto neighbor : position.fixedNeighbors8(Random))
       if (neighbor.canEnter(movement)) {
         displace(position.getDir(neighbor));
         CHECK(getPosition().getCreature() == this);
@@ -985,20 +988,16 @@ void Creature::considerMovingFromInaccessibleSquare() {
 void Creature::tick() {
   PROFILE_BLOCK("Creature::tick");
   addMorale(-morale * 0.0008);
-  auto updateMorale = [this](Position pos, double mult) {
-    for (auto& f : pos.getFurniture()) {
-      auto& luxury = f->getLuxuryInfo();
-      if (luxury.luxury > morale)
-        addMorale((luxury.luxury - morale) * mult);
-    }
-    for (auto& it : pos.getItems())
-      if (auto info = it->getCorpseInfo())
-        if (!info->isSkeleton && it->getClass() != ItemClass::FOOD)
-          addMorale(-2 * mult);
+  auto updateMorale = [this](const MoraleInfluence& influence, double mult) {
+    for (int i : Range(influence.numLuxury))
+      if (influence.luxury[i] > morale)
+        addMorale((influence.luxury[i] - morale) * mult);
+    for (int i : Range(influence.numCorpses))
+      addMorale(-2 * mult);
   };
-  for (auto pos : position.neighbors8())
-    updateMorale(pos, 0.0004);
-  updateMorale(position, 0.001);
+  for (auto pos : position.fixedNeighbors8())
+    updateMorale(pos.getMoraleInfluence(), 0.0004);
+  updateMorale(position.getMoraleInfluence(), 0.001);
   considerMovingFromInaccessibleSquare();
   captureHealth = min(1.0, captureHealth + 0.02);
   vision->update(this);
@@ -1007,7 +1006,9 @@ void Creature::tick() {
   equipment->tick(position);
   if (isDead())
     return;
-  for (LastingEffect effect : ENUM_ALL(LastingEffect)) {
+  // The set is read while it's being changed, so an effect that becomes active during the loop is still processed
+  // in this turn if it comes later in the enum, just like when looping over all effects.
+  for (LastingEffect effect : attributes->getActiveEffects()) {
     if (attributes->considerTimeout(effect, *getGlobalTime()))
       LastingEffects::onTimedOut(this, effect, true);
     if (isDead())
@@ -1085,7 +1086,7 @@ CreatureAction Creature::attack(Creature* other, optional<AttackParams> attackPa
     return CreatureAction("No available weapon or intrinsic attack");
   return CreatureAction(this, [=] (Creature* self) {
     other->addCombatIntent(self, true);
-    INFO << getName().the() << " attacking " << other->getName().the();
+    INFO_IN(CREATURES) << getName().the() << " attacking " << other->getName().the();
     auto& weaponInfo = weapon->getWeaponInfo();
     auto damageAttr = weaponInfo.meleeAttackAttr;
     int damage = getAttr(damageAttr, false) + weapon->getModifier(damageAttr);
@@ -1304,7 +1305,7 @@ void Creature::setHeld(Creature* c) {
 Creature* Creature::getHoldingCreature() const {
   PROFILE;
   if (holding)
-    for (auto pos : getPosition().neighbors8())
+    for (auto pos : getPosition().fixedNeighbors8())
       if (auto c = pos.getCreature())
         if (c->getUniqueId() == *holding)
           return c;
@@ -1344,7 +1345,7 @@ void Creature::dieWithAttacker(Creature* attacker, DropType drops) {
   getController()->onKilled(attacker);
   deathTime = *getGlobalTime();
   lastAttacker = attacker;
-  INFO << getName().the() << " dies. Killed by " << (attacker ? attacker->getName().bare() : "");
+  INFO_IN(CREATURES) << getName().the() << " dies. Killed by " << (attacker ? attacker->getName().bare() : "");
   if (drops == DropType::EVERYTHING || drops == DropType::ONLY_INVENTORY)
     for (PItem& item : equipment->removeAllItems(this))
       getPosition().dropItem(std::move(item));
@@ -1373,7 +1374,7 @@ CreatureAction Creature::flyAway() const {
   if (!isAffected(LastingEffect::FLYING) || getPosition().isCovered())
     return CreatureAction();
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " fly away";
+    INFO_IN(CREATURES) << getName().the() << " fly away";
     thirdPerson(getName().the() + " flies away.");
     self->dieNoReason(Creature::DropType::NOTHING);
   });
@@ -1381,7 +1382,7 @@ CreatureAction Creature::flyAway() const {
 
 CreatureAction Creature::disappear() const {
   return CreatureAction(this, [=](Creature* self) {
-    INFO << getName().the() << " disappears";
+    INFO_IN(CREATURES) << getName().the() << " disappears";
     thirdPerson(getName().the() + " disappears.");
     self->dieNoReason(Creature::DropType::NOTHING);
   });
@@ -1587,7 +1588,7 @@ CreatureAction Creature::copulate(Vec2 direction) const {
   if (!other || !canCopulateWith(other))
     return CreatureAction();
   return CreatureAction(this, [=](Creature* self) {
-      INFO << getName().bare() << " copulate with " << other->getName().bare();
+      INFO_IN(CREATURES) << getName().bare() << " copulate with " << other->getName().bare();
       you(MsgType::COPULATE, "with " + other->getName().the());
       getGame()->addEvent(EventInfo::FX{self->position, {FXName::LOVE}, self->position.getDir(other->position)});
       auto movementInfo = *self->spendTime(2_visible);
@@ -1759,7 +1760,7 @@ CreatureAction Creature::stayIn(WLevel level, Rectangle area) {
   PROFILE;
   if (level != getLevel() || !getPosition().getCoord().inRectangle(area)) {
     if (level == getLevel())
-      for (Position v : getPosition().neighbors8(Random))
+      for (Position v : getPosition().fixedNeighbors8(Random))
         if (v.getCoord().inRectangle(area))
           if (auto action = move(v))
             return action;
@@ -1804,15 +1805,15 @@ CreatureAction Creature::moveTowards(Position pos, bool away, NavigationFlags fl
   auto currentPath = shortestPath;
   for (int i : Range(2)) {
     bool wasNew = false;
-    INFO << identify() << (away ? " retreating " : " navigating ") << position.getCoord() << " to " << pos.getCoord();
+    INFO_IN(PATHFINDING) << identify() << (away ? " retreating " : " navigating ") << position.getCoord() << " to " << pos.getCoord();
     if (!currentPath || Random.roll(10) || currentPath->isReversed() != away ||
         currentPath->getTarget().dist8(pos).value_or(10000000) > *position.dist8(pos) / 10) {
-      INFO << "Calculating new path";
+      INFO_IN(PATHFINDING) << "Calculating new path";
       currentPath = LevelShortestPath(this, pos, away ? -1.5 : 0);
       wasNew = true;
     }
     if (currentPath->isReachable(position)) {
-      INFO << "Position reachable";
+      INFO_IN(PATHFINDING) << "Position reachable";
       Position pos2 = currentPath->getNextMove(position);
       if (pos2.dist8(position).value_or(2) > 1)
         if (auto f = position.getFurniture(FurnitureLayer::MIDDLE))
@@ -1824,19 +1825,19 @@ CreatureAction Creature::moveTowards(Position pos, bool away, NavigationFlags fl
         else
           return CreatureAction();
       } else {
-        INFO << "Trying to destroy";
+        INFO_IN(PATHFINDING) << "Trying to destroy";
         if (!pos2.canEnterEmpty(this) && flags.destroy) {
           if (auto destroyAction = pos2.getBestDestroyAction(getMovementType()))
             if (auto action = destroy(getPosition().getDir(pos2), *destroyAction)) {
-              INFO << "Destroying";
+              INFO_IN(PATHFINDING) << "Destroying";
               return action.append([path = *currentPath](Creature* c) { c->shortestPath = path; });
             }
-          if (auto bridgeAction = construct(getPosition().getDir(pos2), FurnitureType("BRIDGE")))
+          if (auto bridgeAction = construct(getPosition().getDir(pos2), CONTENT_ID(FurnitureType, "BRIDGE")))
             return bridgeAction.append([path = *currentPath](Creature* c) { c->shortestPath = path; });
         }
       }
     } else
-      INFO << "Position unreachable";
+      INFO_IN(PATHFINDING) << "Position unreachable";
     shortestPath = none;
     currentPath = none;
     if (wasNew)
@@ -36,6 +36,20 @@ void CreatureAttributes::initializeLastingEffects() {
   for (auto effect : ENUM_ALL(LastingEffect))
     if (body->isIntrinsicallyAffected(effect))
       ++permanentEffects[effect];
+  updateActiveEffects();
+}
+
+void CreatureAttributes::updateActiveEffect(LastingEffect effect) {
+  activeEffects.set(effect, permanentEffects[effect] > 0 || lastingEffects[effect] > GlobalTime(0));
+}
+
+void CreatureAttributes::updateActiveEffects() {
+  for (auto effect : ENUM_ALL(LastingEffect))
+    updateActiveEffect(effect);
+}
+
+const EnumSet<LastingEffect>& CreatureAttributes::getActiveEffects() const {
+  return activeEffects;
 }
 
 void CreatureAttributes::randomize() {
@@ -71,6 +85,8 @@ void CreatureAttributes::serializeImpl(Archive& ar, const unsigned int version)
 template <class Archive>
 void CreatureAttributes::serialize(Archive& ar, const unsigned int version) {
   serializeImpl(ar, version);
+  if (Archive::is_loading::value)
+    updateActiveEffects();
 }
 
 SERIALIZABLE(CreatureAttributes);
@@ -212,6 +228,7 @@ void CreatureAttributes::add(BodyPart p, int count) {
   for (auto effect : ENUM_ALL(LastingEffect))
     if (body->isIntrinsicallyAffected(effect))
       ++permanentEffects[effect];
+  updateActiveEffects();
 }
 
 optional<string> CreatureAttributes::getPetReaction(const Creature* me) const {
@@ -239,6 +256,8 @@ void CreatureAttributes::chatReaction(Creature* me, Creature* other) {
 }
 
 bool CreatureAttributes::isAffected(LastingEffect effect, GlobalTime time) const {
+  if (!activeEffects.contains(effect))
+    return false;
   PROFILE;
   if (auto suppressor = LastingEffects::getSuppressor(effect))
     if (isAffected(*suppressor, time))
@@ -262,6 +281,7 @@ bool CreatureAttributes::considerTimeout(LastingEffect effect, GlobalTime curren
 void CreatureAttributes::addLastingEffect(LastingEffect effect, GlobalTime endTime) {
   if (lastingEffects[effect] < endTime)
     lastingEffects[effect] = endTime;
+  updateActiveEffect(effect);
 }
 
 static bool consumeProb() {
@@ -390,14 +410,17 @@ bool CreatureAttributes::isAffectedPermanently(LastingEffect effect) const {
 
 void CreatureAttributes::clearLastingEffect(LastingEffect effect) {
   lastingEffects[effect] = GlobalTime(0);
+  updateActiveEffect(effect);
 }
 
 void CreatureAttributes::addPermanentEffect(LastingEffect effect, int count) {
   permanentEffects[effect] += count;
+  updateActiveEffect(effect);
 }
 
 void CreatureAttributes::removePermanentEffect(LastingEffect effect, int count) {
   permanentEffects[effect] -= count;
+  updateActiveEffect(effect);
 }
 
 const MinionActivityMap& CreatureAttributes::getMinionActivities() const {
@@ -103,6 +103,8 @@ class CreatureAttributes {
   bool considerTimeout(LastingEffect, GlobalTime current);
   void addLastingEffect(LastingEffect, GlobalTime endtime);
   optional<GlobalTime> getLastAffected(LastingEffect, GlobalTime currentGlobalTime) const;
+  // Effects that are permanent or have a pending timeout. No other effect can affect the creature or time out.
+  const EnumSet<LastingEffect>& getActiveEffects() const;
   bool canSleep() const;
   bool isInnocent() const;
   void consume(Creature* self, CreatureAttributes& other);
@@ -151,5 +153,8 @@ class CreatureAttributes {
   bool SERIAL(canJoinCollective) = true;
   optional<string> SERIAL(petReaction);
   optional<LastingEffect> SERIAL(hatedByEffect);
+  EnumSet<LastingEffect> activeEffects;
   void initializeLastingEffects();
+  void updateActiveEffect(LastingEffect);
+  void updateActiveEffects();
 };
@@ -33,19 +33,151 @@ DebugOutput DebugOutput::toString(function<void (const string&)> callback) {
 }
 
 DebugOutput DebugOutput::crash() {
-  return DebugOutput(*(new stringstream()), [] { fail(); });
+  return DebugOutput(*(new stringstream()), [] { InfoLog.flush(); fail(); });
 }
 
 DebugOutput DebugOutput::exitProgram() {
   return DebugOutput(*(new stringstream()), [] { exit(0); });
 }
 
+struct DebugLog::ThreadBuffer {
+  std::mutex mutex;
+  vector<string> lines;
+};
+
+static const char* categoryNames[] = {"general", "creatures", "pathfinding", "level_gen"};
+
+DebugLog::DebugLog() {
+}
+
+DebugLog::~DebugLog() {
+}
+
 void DebugLog::addOutput(DebugOutput o) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
   outputs.push_back(o);
+  updateEnabledMask();
+}
+
+void DebugLog::updateEnabledMask() {
+  enabledMask = outputs.empty() ? 0 : enabledCategories;
+}
+
+bool DebugLog::setEnabledCategories(const string& list) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  enabledCategories = 0;
+  for (auto& name : split(list, {','})) {
+    auto it = std::find(std::begin(categoryNames), std::end(categoryNames), name);
+    if (it == std::end(categoryNames))
+      return false;
+    enabledCategories |= 1u << (it - std::begin(categoryNames));
+  }
+  updateEnabledMask();
+  return true;
+}
+
+string DebugLog::getCategoryNames() {
+  return combine(vector<string>(std::begin(categoryNames), std::end(categoryNames)), true);
+}
+
+// Unregisters the buffers of a thread when it exits, after writing out what's left in them.
+struct DebugLog::ThreadBuffers {
+  vector<pair<DebugLog*, ThreadBuffer*>> buffers;
+  ~ThreadBuffers() {
+    for (auto& elem : buffers)
+      elem.first->removeThreadBuffer(elem.second);
+  }
+};
+
+DebugLog::ThreadBuffer& DebugLog::getThreadBuffer() {
+  thread_local ThreadBuffers threadLocal;
+  for (auto& elem : threadLocal.buffers)
+    if (elem.first == this)
+      return *elem.second;
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  threadBuffers.push_back(make_shared<ThreadBuffer>());
+  threadLocal.buffers.push_back(make_pair(this, threadBuffers.back().get()));
+  return *threadBuffers.back();
+}
+
+void DebugLog::removeThreadBuffer(ThreadBuffer* buffer) {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  for (int i : All(threadBuffers))
+    if (threadBuffers[i].get() == buffer) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      for (auto& line : buffer->lines)
+        writeLine(line);
+      threadBuffers.erase(threadBuffers.begin() + i);
+      break;
+    }
+}
+
+void DebugLog::writeLine(const string& line) {
+  for (int i = outputs.size() - 1; i >= 0; --i) {
+    outputs[i].out << line;
+    outputs[i].onLineEnd();
+  }
+}
+
+void DebugLog::startAsyncWriter() {
+  async = true;
+  asyncWriter = unique<AsyncLoop>([this] {
+    sleep_for(milliseconds(50));
+    flush();
+  });
+}
+
+void DebugLog::stopAsyncWriter() {
+  asyncWriter.reset();
+  // Lines finished after this point are written directly, so the final flush catches all the buffered ones.
+  async = false;
+  flush();
+}
+
+void DebugLog::flush() {
+  std::lock_guard<std::recursive_mutex> lock(mutex);
+  for (auto& buffer : threadBuffers) {
+    vector<string> lines;
+    {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      swap(lines, buffer->lines);
+    }
+    for (auto& line : lines)
+      writeLine(line);
+  }
+}
+
+long long DebugLog::getNumLines() const {
+  return numLines;
 }
 
 DebugLog::Logger DebugLog::get() {
-  return Logger(outputs);
+  return Logger(*this);
+}
+
+DebugLog::Logger::~Logger() {
+  if (!active)
+    return;
+  ++log.numLines;
+  if (async) {
+    auto& threadBuffer = log.getThreadBuffer();
+    std::unique_lock<std::mutex> lock(threadBuffer.mutex);
+    // The flag is checked under the buffer's lock, which the final flush takes only after clearing it.
+    if (log.async)
+      threadBuffer.lines.push_back(buffer.str());
+    else {
+      lock.unlock();
+      std::lock_guard<std::recursive_mutex> logLock(log.mutex);
+      lock.lock();
+      // The earlier lines of this thread go first, if the final flush hasn't got to them yet.
+      for (auto& line : threadBuffer.lines)
+        log.writeLine(line);
+      threadBuffer.lines.clear();
+      log.writeLine(buffer.str());
+    }
+  } else
+    for (int i = log.outputs.size() - 1; i >= 0; --i)
+      log.outputs[i].onLineEnd();
 }
 
 DebugLog InfoLog;
@@ -21,7 +21,12 @@
 #define FATAL FatalLog.get() << "FATAL " << __FILE__ << ":" << __LINE__ << " "
 #define USER_FATAL UserErrorLog.get()
 #define USER_INFO UserInfoLog.get()
-#define INFO InfoLog.get() << __FILE__ << ":" <<  __LINE__ << " "
+// The stream arguments are only evaluated if the category is enabled and InfoLog has an output. The conditional
+// expression keeps the macro safe to use as the body of an if.
+#define INFO_IN(category) \
+  !InfoLog.isEnabled(LogCategory::category) ? (void) 0 : \
+      DebugLog::Voidify() & InfoLog.get() << __FILE__ << ":" <<  __LINE__ << " "
+#define INFO INFO_IN(GENERAL)
 #define CHECK(exp) if (!(exp)) FATAL << ": " << #exp << " is false. "
 #define USER_CHECK(exp) if (!(exp)) USER_FATAL
 //#define CHECKEQ(exp, exp2) if ((exp) != (exp2)) FATAL << __FILE__ << ":" << __LINE__ << ": " << #exp << " = " << #exp2 << " is false. " << exp << " " << exp2
@@ -30,6 +35,7 @@
 #ifndef WINDOWS
 
 #define MEASURE(exp, text) do { \
+  PROFILE_BLOCK(text); \
   timeval time1; \
   gettimeofday(&time1, nullptr); \
   suseconds_t m1 = time1.tv_usec + time1.tv_sec * 1000000; \
@@ -40,7 +46,7 @@
 
 #else
 
-#define MEASURE(exp, text) exp;
+#define MEASURE(exp, text) do { PROFILE_BLOCK(text); exp; } while(0);
 
 #endif
 
@@ -72,33 +78,85 @@ class DebugOutput {
   DebugOutput(std::ostream& o, LineEndFun end) : out(o), onLineEnd(end) {}
 };
 
+// Categories of INFO messages that can be turned off separately. Messages logged every turn get their own ones.
+enum class LogCategory {
+  GENERAL,
+  CREATURES,
+  PATHFINDING,
+  LEVEL_GEN
+};
+
+class AsyncLoop;
+
 class DebugLog {
   public:
+  DebugLog();
+  ~DebugLog();
   void addOutput(DebugOutput);
 
+  bool isEnabled(LogCategory category) const {
+    return enabledMask.load(std::memory_order_relaxed) & (1u << int(category));
+  }
+  // Takes a comma separated list of category names and disables the other categories. Returns false if a name
+  // is unknown.
+  bool setEnabledCategories(const string&);
+  static string getCategoryNames();
+
+  /* From now on every thread formats its lines into its own buffer and a background thread writes them to the
+     outputs. Lines logged by one thread keep their order. */
+  void startAsyncWriter();
+  void stopAsyncWriter();
+  // Writes all buffered lines before returning.
+  void flush();
+  long long getNumLines() const;
+
   class Logger {
     public:
-    Logger(std::vector<DebugOutput>& s) : outputs(s) {}
+    Logger(DebugLog& l) : log(l), async(l.async) {}
+    Logger(Logger&& o) : log(o.log), async(o.async), buffer(std::move(o.buffer)) {
+      o.active = false;
+    }
 
     template <typename T>
     Logger& operator << (const T& t) {
-      for (int i = outputs.size() - 1; i >= 0; --i)
-        outputs[i].out << t;
+      if (async)
+        buffer << t;
+      else
+        for (int i = log.outputs.size() - 1; i >= 0; --i)
+          log.outputs[i].out << t;
       return *this;
     }
-    ~Logger() {
-      for (int i = outputs.size() - 1; i >= 0; --i)
-        outputs[i].onLineEnd();
-    }
+    ~Logger();
 
     private:
-    std::vector<DebugOutput>& outputs;
+    DebugLog& log;
+    // Decided once, so that a line isn't split if the writer is started or stopped in the middle.
+    bool async;
+    std::ostringstream buffer;
+    bool active = true;
   };
 
   Logger get();
 
+  struct Voidify {
+    void operator & (const Logger&) {}
+  };
+
   private:
+  struct ThreadBuffer;
+  struct ThreadBuffers;
+  ThreadBuffer& getThreadBuffer();
+  void removeThreadBuffer(ThreadBuffer*);
+  void writeLine(const string&);
+  void updateEnabledMask();
   std::vector<DebugOutput> outputs;
+  std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+  std::recursive_mutex mutex;
+  std::atomic<bool> async{false};
+  std::unique_ptr<AsyncLoop> asyncWriter;
+  std::atomic<unsigned> enabledMask{0};
+  unsigned enabledCategories = ~0u;
+  std::atomic<long long> numLines{0};
 };
 
 extern DebugLog InfoLog;
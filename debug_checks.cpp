@@ -0,0 +1,8 @@
+#include "stdafx.h"
+#include "debug_checks.h"
+
+atomic<bool> DebugChecks::enabled(false);
+
+void DebugChecks::setEnabled(bool e) {
+  enabled.store(e, std::memory_order_relaxed);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "util.h"
+
+/* Cross-checks of incrementally maintained caches against a full recomputation. They are too slow to run
+   in a normal game, so they are enabled with the check_caches command line flag. */
+class DebugChecks {
+  public:
+  static bool isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+  }
+  static void setEnabled(bool);
+
+  private:
+  static atomic<bool> enabled;
+};
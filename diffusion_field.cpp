@@ -0,0 +1,110 @@
+#include "stdafx.h"
+#include "diffusion_field.h"
+#include "memory_report.h"
+
+template <class Archive>
+void DiffusionField::serialize(Archive& ar, const unsigned int) {
+  // Only the active area is written, the rest of the grid is zero.
+  Rectangle bounds = amounts.getBounds();
+  ar(bounds, activeArea);
+  if (Archive::is_loading::value)
+    amounts = Table<float>(bounds, 0);
+  if (activeArea)
+    for (Vec2 v : *activeArea)
+      ar(amounts[v]);
+}
+
+SERIALIZABLE(DiffusionField)
+SERIALIZATION_CONSTRUCTOR_IMPL(DiffusionField)
+
+DiffusionField::DiffusionField(Rectangle bounds) : amounts(bounds, 0) {
+}
+
+float DiffusionField::get(Vec2 v) const {
+  return amounts[v];
+}
+
+void DiffusionField::add(Vec2 v, float amount) {
+  CHECK(amount > 0);
+  amounts[v] = min(1.0f, amounts[v] + amount);
+  if (activeArea)
+    activeArea = Rectangle::boundingBox({activeArea->topLeft(), activeArea->bottomRight() - Vec2(1, 1), v});
+  else
+    activeArea = Rectangle(v, v + Vec2(1, 1));
+}
+
+const optional<Rectangle>& DiffusionField::getActiveArea() const {
+  return activeArea;
+}
+
+long long DiffusionField::getMemoryUsage() const {
+  return ::getMemoryUsage(amounts) + (src.capacity() + open.capacity() + dst.capacity()) * sizeof(float);
+}
+
+const float cardinalSpread = 0.1f;
+const float diagonalSpread = 0.05f;
+const float decrease = 0.98f;
+const float minAmount = 0.01f;
+
+void DiffusionField::tick(function<bool(Vec2)> isOpen, function<void(Vec2, float)> onChanged) {
+  PROFILE;
+  if (!activeArea)
+    return;
+  auto area = activeArea->minusMargin(-1).intersection(amounts.getBounds());
+  // The amounts and the open flags of the area are copied into buffers with a one tile border of zeros, so that
+  // the kernel below needs no bounds checks and no branches.
+  const int width = area.width() + 2;
+  const int height = area.height() + 2;
+  src.assign(width * height, 0);
+  open.assign(width * height, 0);
+  dst.resize(area.width() * area.height());
+  for (int y = 0; y < area.height(); ++y)
+    for (int x = 0; x < area.width(); ++x) {
+      Vec2 v = area.topLeft() + Vec2(x, y);
+      int index = (y + 1) * width + x + 1;
+      src[index] = amounts[v];
+      open[index] = isOpen(v) ? 1 : 0;
+    }
+  for (int y = 1; y < height - 1; ++y) {
+    const float* row = &src[y * width];
+    const float* up = row - width;
+    const float* down = row + width;
+    const float* openRow = &open[y * width];
+    const float* openUp = openRow - width;
+    const float* openDown = openRow + width;
+    float* target = &dst[(y - 1) * (width - 2)];
+    for (int x = 1; x < width - 1; ++x) {
+      float amount = row[x];
+      float cardinal = openRow[x - 1] * (row[x - 1] - amount) + openRow[x + 1] * (row[x + 1] - amount) +
+          openUp[x] * (up[x] - amount) + openDown[x] * (down[x] - amount);
+      float diagonal = openUp[x - 1] * (up[x - 1] - amount) + openUp[x + 1] * (up[x + 1] - amount) +
+          openDown[x - 1] * (down[x - 1] - amount) + openDown[x + 1] * (down[x + 1] - amount);
+      float result = (amount + openRow[x] * (cardinalSpread * cardinal + diagonalSpread * diagonal)) * decrease;
+      target[x - 1] = result < minAmount ? 0 : result;
+    }
+  }
+  for (int y = 0; y < area.height(); ++y)
+    for (int x = 0; x < area.width(); ++x) {
+      Vec2 v = area.topLeft() + Vec2(x, y);
+      float previous = amounts[v];
+      amounts[v] = dst[y * area.width() + x];
+      if (amounts[v] != previous)
+        onChanged(v, previous);
+    }
+  updateActiveArea(area);
+}
+
+void DiffusionField::updateActiveArea(Rectangle area) {
+  int minX = area.right(), minY = area.bottom(), maxX = area.left() - 1, maxY = area.top() - 1;
+  for (Vec2 v : area)
+    if (amounts[v] > 0) {
+      minX = min(minX, v.x);
+      minY = min(minY, v.y);
+      maxX = max(maxX, v.x);
+      maxY = max(maxY, v.y);
+    }
+  if (maxX < minX)
+    activeArea = none;
+  else
+    activeArea = Rectangle(minX, minY, maxX + 1, maxY + 1);
+}
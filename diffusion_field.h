@@ -0,0 +1,31 @@
+#pragma once
+
+#include "util.h"
+
+/* A level-wide quantity that spreads to neighboring tiles and decays, such as poison gas. The amounts are kept
+   in a contiguous grid and only the bounding rectangle of the non-zero tiles, grown by one tile, is simulated.
+   Every tick computes all new amounts from the previous ones, so the result doesn't depend on the order in which
+   the tiles are visited and no randomness is involved. */
+class DiffusionField {
+  public:
+  DiffusionField(Rectangle bounds);
+  float get(Vec2) const;
+  // The amount on a tile never exceeds 1.
+  void add(Vec2, float amount);
+  // The returned rectangle contains all tiles with a non-zero amount.
+  const optional<Rectangle>& getActiveArea() const;
+  // Tiles for which isOpen returns false don't exchange anything with their neighbors, but their amount still decays.
+  // onChanged is called with the previous amount for every tile whose amount has changed.
+  void tick(function<bool(Vec2)> isOpen, function<void(Vec2, float)> onChanged);
+  long long getMemoryUsage() const;
+
+  SERIALIZATION_DECL(DiffusionField)
+
+  private:
+  void updateActiveArea(Rectangle area);
+  Table<float> amounts;
+  optional<Rectangle> activeArea;
+  std::vector<float> src;
+  std::vector<float> open;
+  std::vector<float> dst;
+};
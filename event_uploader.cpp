@@ -0,0 +1,310 @@
+#include "stdafx.h"
+#include "event_uploader.h"
+
+#include <curl/curl.h>
+#include <zlib.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static std::chrono::milliseconds toStd(milliseconds m) {
+  return std::chrono::milliseconds(m.count());
+}
+
+EventUploader::Params EventUploader::getDefaultParams() {
+  return Params {
+    milliseconds(5000),
+    100,
+    milliseconds(5000),
+    milliseconds(600000),
+    10000
+  };
+}
+
+static size_t appendToString(void* buffer, size_t size, size_t nmemb, void* userp) {
+  static_cast<string*>(userp)->append(static_cast<char*>(buffer), size * nmemb);
+  return size * nmemb;
+}
+
+static int progressFunction(void* ptr, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+  return *static_cast<const std::atomic<bool>*>(ptr) ? 1 : 0;
+}
+
+// The handle is only used by the uploading thread, and keeps the connection open between the batches.
+static EventUploader::PostFun getCurlPost(const string& url, const std::atomic<bool>& aborted) {
+  shared_ptr<CURL> curl(curl_easy_init(), curl_easy_cleanup);
+  shared_ptr<curl_slist> headers(curl_slist_append(nullptr, "Content-Type: application/octet-stream"),
+      curl_slist_free_all);
+  return [curl, headers, url, &aborted] (const string& batch) {
+    if (!curl)
+      return false;
+    string response;
+    curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl.get(), CURLOPT_POST, 1L);
+    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, batch.data());
+    curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDSIZE, long(batch.size()));
+    curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, headers.get());
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, appendToString);
+    curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl.get(), CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl.get(), CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl.get(), CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl.get(), CURLOPT_XFERINFODATA, &aborted);
+    curl_easy_setopt(curl.get(), CURLOPT_XFERINFOFUNCTION, progressFunction);
+    CURLcode res = curl_easy_perform(curl.get());
+    long status = 0;
+    curl_easy_getinfo(curl.get(), CURLINFO_RESPONSE_CODE, &status);
+    if (res != CURLE_OK || status != 200 || response.compare(0, 2, "OK") != 0) {
+      INFO << "Event upload failed: " << curl_easy_strerror(res) << ", status " << status;
+      return false;
+    }
+    return true;
+  };
+}
+
+EventUploader::EventUploader(const string& url, optional<FilePath> spool, Params params)
+    : EventUploader(getCurlPost(url, aborted), std::move(spool), params) {
+}
+
+EventUploader::EventUploader(PostFun p, optional<FilePath> s, Params par) : post(std::move(p)), spool(std::move(s)),
+    params(par), firstPendingTime(Clock::now()), nextAttempt(Clock::now()), backoff(toStd(params.minBackoff)),
+    aborted(false), loop(bindMethod(&EventUploader::uploadingLoop, this)) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (spool)
+    if (auto contents = spool->readContents())
+      for (auto& line : split(*contents, {'\n'}))
+        if (!line.empty())
+          pending.push_back(line);
+  INFO << "Events waiting in the spool: " << pending.size();
+  wakeUp.notify_one();
+}
+
+EventUploader::~EventUploader() {
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished = true;
+    wakeUp.notify_one();
+    // Give the last attempt a moment before aborting it.
+    if (!sent.wait_for(lock, std::chrono::seconds(1), [this] { return stopped; }))
+      aborted = true;
+  }
+  loop.finishAndWait();
+}
+
+void EventUploader::setEnabled(bool e) {
+  std::unique_lock<std::mutex> lock(mutex);
+  enabled = e;
+  wakeUp.notify_one();
+}
+
+void EventUploader::removeEvents(function<bool(const Event&)> predicate) {
+  std::unique_lock<std::mutex> lock(mutex);
+  auto size = pending.size();
+  pending.erase(std::remove_if(pending.begin(), pending.end(), [&](const string& line) {
+    auto event = decodeEvent(line);
+    return !event || predicate(*event);
+  }), pending.end());
+  if (pending.size() != size)
+    writeSpool();
+  if (pending.empty())
+    sent.notify_all();
+}
+
+void EventUploader::add(const Event& event) {
+  auto line = encodeEvent(event);
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!enabled)
+    return;
+  if (pending.empty())
+    firstPendingTime = Clock::now();
+  pending.push_back(line);
+  if (pending.size() > params.maxPending) {
+    pending.pop_front();
+    writeSpool();
+  } else if (spool) {
+    ofstream out(spool->getPath(), std::ios::app);
+    out << line << '\n';
+  }
+  wakeUp.notify_one();
+}
+
+void EventUploader::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  flushRequested = true;
+  wakeUp.notify_one();
+}
+
+bool EventUploader::waitUntilSent(milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex);
+  return sent.wait_for(lock, toStd(timeout), [this] { return pending.empty(); });
+}
+
+int EventUploader::getNumPending() {
+  std::unique_lock<std::mutex> lock(mutex);
+  return pending.size();
+}
+
+int EventUploader::getNumRequests() {
+  std::unique_lock<std::mutex> lock(mutex);
+  return numRequests;
+}
+
+void EventUploader::writeSpool() {
+  if (!spool)
+    return;
+  // Writing to a temporary file first means that a crash leaves either the old or the new spool.
+  string tmpPath = spool->getPath() + ".tmp"_s;
+  {
+    ofstream out(tmpPath);
+    for (auto& line : pending)
+      out << line << '\n';
+  }
+  remove(spool->getPath());
+  rename(tmpPath.c_str(), spool->getPath());
+}
+
+void EventUploader::uploadingLoop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    auto now = Clock::now();
+    // When the game is closing make at most one more attempt, and leave the rest for the next start.
+    if (finished && (pending.empty() || !enabled || now < nextAttempt)) {
+      stop();
+      return;
+    }
+    if (pending.empty() || !enabled) {
+      wakeUp.wait(lock);
+      continue;
+    }
+    auto sendTime = finished || flushRequested || pending.size() >= params.maxBatchSize
+        ? now : firstPendingTime + toStd(params.batchDelay);
+    sendTime = max(sendTime, nextAttempt);
+    if (sendTime <= now)
+      break;
+    wakeUp.wait_until(lock, sendTime);
+  }
+  vector<string> batch(pending.begin(), pending.begin() + min<int>(pending.size(), params.maxBatchSize));
+  bool lastAttempt = finished;
+  lock.unlock();
+  bool success = post(encodeBatch(batch));
+  lock.lock();
+  ++numRequests;
+  if (success) {
+    // add() only appends new events, unless the spool overflowed and dropped some of the ones we've just sent.
+    for (auto& line : batch)
+      if (!pending.empty() && pending.front() == line)
+        pending.pop_front();
+    writeSpool();
+    backoff = toStd(params.minBackoff);
+    nextAttempt = firstPendingTime = Clock::now();
+    if (pending.empty()) {
+      flushRequested = false;
+      sent.notify_all();
+    }
+  } else {
+    INFO << "Retrying event upload in " << backoff.count() << " ms";
+    nextAttempt = Clock::now() + backoff;
+    backoff = min(backoff * 2, toStd(params.maxBackoff));
+  }
+  if (lastAttempt)
+    stop();
+}
+
+void EventUploader::stop() {
+  stopped = true;
+  sent.notify_all();
+  loop.setDone();
+}
+
+static bool isUnreserved(char c) {
+  return isalnum((unsigned char) c) || c == '-' || c == '_' || c == '.' || c == '~';
+}
+
+static string percentEncode(const string& s) {
+  const char* hex = "0123456789ABCDEF";
+  string ret;
+  for (char c : s)
+    if (isUnreserved(c))
+      ret += c;
+    else {
+      ret += '%';
+      ret += hex[(unsigned char) c >> 4];
+      ret += hex[(unsigned char) c & 15];
+    }
+  return ret;
+}
+
+static optional<string> percentDecode(const string& s) {
+  string ret;
+  for (int i = 0; i < s.size(); ++i)
+    if (s[i] == '%') {
+      if (i + 2 >= s.size() || !isxdigit((unsigned char) s[i + 1]) || !isxdigit((unsigned char) s[i + 2]))
+        return none;
+      ret += char(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else if (s[i] == '+')
+      ret += ' ';
+    else
+      ret += s[i];
+  return ret;
+}
+
+string EventUploader::encodeEvent(const Event& event) {
+  string ret;
+  for (auto& elem : event) {
+    if (!ret.empty())
+      ret += '&';
+    ret += percentEncode(elem.first) + '=' + percentEncode(elem.second);
+  }
+  return ret;
+}
+
+optional<EventUploader::Event> EventUploader::decodeEvent(const string& line) {
+  Event ret;
+  for (auto& param : split(line, {'&'})) {
+    auto separator = param.find('=');
+    if (separator == string::npos)
+      return none;
+    auto key = percentDecode(param.substr(0, separator));
+    auto value = percentDecode(param.substr(separator + 1));
+    if (!key || !value)
+      return none;
+    ret[*key] = *value;
+  }
+  return ret;
+}
+
+string EventUploader::encodeBatch(const vector<string>& events) {
+  string text;
+  for (auto& line : events)
+    text += line + '\n';
+  uLongf size = compressBound(text.size());
+  string ret(size, 0);
+  CHECK(compress2((Bytef*) &ret[0], &size, (const Bytef*) text.data(), text.size(), Z_BEST_COMPRESSION) == Z_OK);
+  ret.resize(size);
+  return ret;
+}
+
+optional<vector<string>> EventUploader::decodeBatch(const string& batch) {
+  z_stream stream {};
+  if (inflateInit(&stream) != Z_OK)
+    return none;
+  stream.next_in = (Bytef*) batch.data();
+  stream.avail_in = batch.size();
+  string text;
+  char buf[4096];
+  int res = Z_OK;
+  while (res == Z_OK) {
+    stream.next_out = (Bytef*) buf;
+    stream.avail_out = sizeof(buf);
+    res = inflate(&stream, Z_NO_FLUSH);
+    text.append(buf, sizeof(buf) - stream.avail_out);
+  }
+  inflateEnd(&stream);
+  if (res != Z_STREAM_END)
+    return none;
+  vector<string> ret;
+  for (auto& line : split(text, {'\n'}))
+    if (!line.empty())
+      ret.push_back(line);
+  return ret;
+}
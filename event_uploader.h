@@ -0,0 +1,75 @@
+#pragma once
+
+#include "util.h"
+#include "file_path.h"
+
+/* Sends game events to the server in batches. Every event is first appended to a spool file, so the ones that
+   haven't been sent yet survive losing the connection or quitting the game, and go out after the next start.
+   A background thread waits for a few events to gather, compresses them into a single request and posts it
+   over a connection that's kept open between batches. After a failed request it waits twice as long as
+   before until the next attempt. The uploader starts disabled, so that the owner can drop the spooled events
+   it's no longer allowed to send before anything goes out. */
+class EventUploader {
+  public:
+  typedef map<string, string> Event;
+  // Posts a compressed batch and returns true if the server has accepted it.
+  typedef function<bool(const string& batch)> PostFun;
+
+  struct Params {
+    milliseconds batchDelay;
+    int maxBatchSize;
+    milliseconds minBackoff;
+    milliseconds maxBackoff;
+    // When the spool gets bigger the oldest events are dropped.
+    int maxPending;
+  };
+  static Params getDefaultParams();
+
+  // Posts the batches to the url, which must accept the format of server/game_events.php.
+  EventUploader(const string& url, optional<FilePath> spool, Params = getDefaultParams());
+  EventUploader(PostFun, optional<FilePath> spool, Params = getDefaultParams());
+  ~EventUploader();
+
+  // While disabled no requests are made and new events are ignored.
+  void setEnabled(bool);
+  // Drops the waiting events for which the predicate returns true, also from the spool.
+  void removeEvents(function<bool(const Event&)>);
+  void add(const Event&);
+  // Sends the waiting events without the batching delay, unless the uploader is backing off after a failure.
+  void flush();
+  // Returns false if some events are still waiting after the timeout.
+  bool waitUntilSent(milliseconds timeout);
+  int getNumPending();
+  int getNumRequests();
+
+  // Every event is one url-encoded line, and the lines are compressed with zlib.
+  static string encodeEvent(const Event&);
+  static optional<Event> decodeEvent(const string&);
+  static string encodeBatch(const vector<string>& events);
+  static optional<vector<string>> decodeBatch(const string&);
+
+  private:
+  void uploadingLoop();
+  void stop();
+  void writeSpool();
+  PostFun post;
+  optional<FilePath> spool;
+  Params params;
+  std::mutex mutex;
+  std::condition_variable wakeUp;
+  std::condition_variable sent;
+  deque<string> pending;
+  // std::chrono is used directly, because the time points are passed to std::condition_variable.
+  std::chrono::steady_clock::time_point firstPendingTime;
+  std::chrono::steady_clock::time_point nextAttempt;
+  std::chrono::milliseconds backoff;
+  bool enabled = false;
+  bool flushRequested = false;
+  bool finished = false;
+  bool stopped = false;
+  // Makes the request in progress fail right away, so that a slow server doesn't delay quitting the game.
+  std::atomic<bool> aborted;
+  int numRequests = 0;
+  // The thread goes last, so that it's stopped before any of the state it uses is destroyed.
+  AsyncLoop loop;
+};
@@ -20,6 +20,8 @@
 #include "square_array.h"
 #include "level.h"
 #include "position.h"
+#include "perf_counters.h"
+#include "memory_report.h"
 
 template <class Archive>
 void FieldOfView::serialize(Archive& ar, const unsigned int) {
@@ -47,6 +49,14 @@ bool FieldOfView::canSee(Vec2 from, Vec2 to) {
   return visibility[from]->checkVisible(to.x - from.x, to.y - from.y);
 }
   
+long long FieldOfView::getMemoryUsage() const {
+  long long ret = ::getMemoryUsage(visibility) + ::getMemoryUsage(blocking);
+  for (Vec2 v : visibility.getBounds())
+    if (auto& elem = visibility[v])
+      ret += sizeof(Visibility) + ::getMemoryUsage(elem->getVisibleTiles());
+  return ret;
+}
+
 void FieldOfView::squareChanged(Vec2 pos) {
   PROFILE;
   blocking[pos] = !Position(pos, level).canSeeThru(vision);
@@ -94,6 +104,7 @@ const vector<Vec2>& FieldOfView::Visibility::getVisibleTiles() const {
 
 const vector<Vec2>& FieldOfView::getVisibleTiles(Vec2 from) {
   if (!visibility[from]) {
+    PerfCounters::add(PerfCounter::FOV_COMPUTATIONS);
     visibility[from].reset(new Visibility(level->getBounds(), blocking, from.x, from.y));
   }
   return visibility[from]->getVisibleTiles();
@@ -26,6 +26,7 @@ class FieldOfView {
   bool canSee(Vec2 from, Vec2 to);
   const vector<Vec2>& getVisibleTiles(Vec2 from);
   void squareChanged(Vec2 pos);
+  long long getMemoryUsage() const;
 
   SERIALIZATION_DECL(FieldOfView)
 
@@ -6,12 +6,44 @@
 #include "options.h"
 #include "text_serialization.h"
 #include "miniunz.h"
+#include "event_uploader.h"
 
 #include <curl/curl.h>
 
-FileSharing::FileSharing(const string& url, Options& o, string id) : uploadUrl(url), options(o),
-    uploadLoop(bindMethod(&FileSharing::uploadingLoop, this)), installId(id), wasCancelled(false) {
+static string escapeSpaces(string s) {
+  string ret;
+  for (auto c : s)
+    if (c == ' ')
+      ret += "%20";
+    else
+      ret += c;
+  return ret;
+}
+
+FileSharing::FileSharing(const string& url, Options& o, string id, optional<FilePath> eventSpool)
+    : uploadUrl(url), options(o), uploadLoop(bindMethod(&FileSharing::uploadingLoop, this)), installId(id),
+      wasCancelled(false) {
   curl_global_init(CURL_GLOBAL_ALL);
+  if (eventSpool) {
+    eventUploader = unique<EventUploader>(escapeSpaces(uploadUrl + "/game_events.php"), eventSpool);
+    updateEventUploader();
+    for (auto id : {OptionId::ONLINE, OptionId::GAME_EVENTS})
+      options.addTrigger(id, [this](int) { updateEventUploader(); });
+  }
+}
+
+static bool isBoardMessage(const FileSharing::GameEvent& event) {
+  auto it = event.find("eventType");
+  return it != event.end() && it->second == "boardMessage";
+}
+
+void FileSharing::updateEventUploader() {
+  bool online = options.getBoolValue(OptionId::ONLINE);
+  bool gameEvents = options.getBoolValue(OptionId::GAME_EVENTS);
+  // Board messages only need the online features, the statistics also need the user's permission.
+  if (!online || !gameEvents)
+    eventUploader->removeEvents([=](const GameEvent& event) { return !online || !isBoardMessage(event); });
+  eventUploader->setEnabled(online);
 }
 
 FileSharing::~FileSharing() {
@@ -42,16 +74,6 @@ size_t dataFun(void *buffer, size_t size, size_t nmemb, void *userp) {
   return size * nmemb;
 }
 
-static string escapeSpaces(string s) {
-  string ret;
-  for (auto c : s)
-    if (c == ' ')
-      ret += "%20";
-    else
-      ret += c;
-  return ret;
-}
-
 static string escapeEverything(const string& s) {
   char* tmp = curl_easy_escape(curl_easy_init(), s.c_str(), (int) s.size());
   string ret(tmp);
@@ -185,36 +207,14 @@ void FileSharing::uploadingLoop() {
 bool FileSharing::uploadGameEvent(const GameEvent& data1, bool requireGameEventsPermission) {
   GameEvent data(data1);
   data.emplace("installId", installId);
-  if (options.getBoolValue(OptionId::ONLINE) &&
+  if (eventUploader && options.getBoolValue(OptionId::ONLINE) &&
       (!requireGameEventsPermission || options.getBoolValue(OptionId::GAME_EVENTS))) {
-    uploadGameEventImpl(data, 5);
+    eventUploader->add(data);
     return true;
   } else
     return false;
 }
 
-void FileSharing::uploadGameEventImpl(const GameEvent& data, int tries) {
-  if (tries >= 0)
-    uploadQueue.push([data, this, tries] {
-      string params;
-      for (auto& elem : data) {
-        if (!params.empty())
-          params += "&";
-        params += elem.first + "=" + escapeEverything(elem.second);
-      }
-      if (CURL* curl = curl_easy_init()) {
-        string ret;
-        curl_easy_setopt(curl, CURLOPT_URL, escapeSpaces(uploadUrl + "/game_event.php").c_str());
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, params.c_str());
-        CURLcode res = curl_easy_perform(curl);
-        curl_easy_cleanup(curl);
-        if (res != CURLE_OK)
-          uploadGameEventImpl(data, tries - 1);
-      }
-    });
-}
-
 string FileSharing::downloadHighscores(int version) {
   string ret;
   if (options.getBoolValue(OptionId::ONLINE))
@@ -316,13 +316,17 @@ optional<vector<FileSharing::BoardMessage>> FileSharing::getBoardMessages(int bo
 }
 
 bool FileSharing::uploadBoardMessage(const string& gameId, int hash, const string& author, const string& text) {
-  return uploadGameEvent({
+  if (!uploadGameEvent({
       { "gameId", gameId },
       { "eventType", "boardMessage"},
       { "boardId", toString(hash) },
       { "author", author },
       { "text", text }
-  }, false);
+  }, false))
+    return false;
+  // The author expects to see the message on the board soon, so don't wait for more events.
+  eventUploader->flush();
+  return true;
 }
 
 static optional<FileSharing::OnlineModInfo> parseModInfo(const vector<string>& fields) {
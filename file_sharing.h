@@ -6,10 +6,13 @@
 #include "saved_game_info.h"
 
 class ProgressMeter;
+class EventUploader;
 
 class FileSharing {
   public:
-  FileSharing(const string& uploadUrl, Options&, string installId);
+  // Game events that couldn't be sent yet are kept in the spool file until the next start. Without a spool
+  // no game events are sent.
+  FileSharing(const string& uploadUrl, Options&, string installId, optional<FilePath> eventSpool = none);
 
   optional<string> uploadSite(const FilePath& path, ProgressMeter&);
   struct SiteInfo {
@@ -58,7 +61,8 @@ class FileSharing {
   SyncQueue<function<void()>> uploadQueue;
   AsyncLoop uploadLoop;
   void uploadingLoop();
-  void uploadGameEventImpl(const GameEvent&, int tries);
+  unique_ptr<EventUploader> eventUploader;
+  void updateEventUploader();
   optional<string> downloadContent(const string& url);
   string installId;
   atomic<bool> wasCancelled;
@@ -113,6 +113,10 @@ bool Furniture::isVisibleTo(const Creature* c) const {
     return true;
 }
 
+bool Furniture::isVisibleToEveryone() const {
+  return !entryType || entryType->isVisibleToEveryone();
+}
+
 const MovementSet& Furniture::getMovementSet() const {
   return *movementSet;
 }
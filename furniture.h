@@ -61,6 +61,8 @@ class Furniture : public OwnedObject<Furniture> {
   const string& getName(int count = 1) const;
   FurnitureType getType() const;
   bool isVisibleTo(const Creature*) const;
+  // False if isVisibleTo depends on the creature.
+  bool isVisibleToEveryone() const;
   const MovementSet& getMovementSet() const;
   void onEnter(Creature*) const;
   bool canDestroy(const MovementType&, const DestroyAction&) const;
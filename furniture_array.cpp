@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "furniture_array.h"
+#include "memory_report.h"
 
 SERIALIZE_DEF(FurnitureArray, built, construction)
 SERIALIZATION_CONSTRUCTOR_IMPL(FurnitureArray)
@@ -9,6 +10,13 @@ FurnitureArray::FurnitureArray(Rectangle bounds) :
 construction([&](FurnitureLayer) { return Table<optional<Construction>>(bounds); }) {
 }
 
+long long FurnitureArray::getMemoryUsage() const {
+  long long ret = 0;
+  for (auto layer : ENUM_ALL(FurnitureLayer))
+    ret += built[layer].getMemoryUsage() + ::getMemoryUsage(construction[layer]);
+  return ret;
+}
+
 const FurnitureArray::Array& FurnitureArray::getBuilt(FurnitureLayer layer) const {
   return built[layer];
 }
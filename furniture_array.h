@@ -25,6 +25,7 @@ class FurnitureArray {
 
   const optional<Construction>& getConstruction(Vec2, FurnitureLayer) const;
   optional<Construction>& getConstruction(Vec2, FurnitureLayer);
+  long long getMemoryUsage() const;
 
   SERIALIZATION_DECL(FurnitureArray)
 
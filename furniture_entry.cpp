@@ -85,6 +85,10 @@ bool FurnitureEntry::isVisibleTo(WConstFurniture f, const Creature* c) const {
   );
 }
 
+bool FurnitureEntry::isVisibleToEveryone() const {
+  return !entryData.contains<Trap>();
+}
+
 SERIALIZE_DEF(FurnitureEntry, entryData)
 SERIALIZATION_CONSTRUCTOR_IMPL(FurnitureEntry)
 
@@ -29,6 +29,7 @@ class FurnitureEntry {
   FurnitureEntry(EntryData);
   void handle(WFurniture, Creature*);
   bool isVisibleTo(WConstFurniture, const Creature*) const;
+  bool isVisibleToEveryone() const;
 
   SERIALIZATION_DECL(FurnitureEntry)
 
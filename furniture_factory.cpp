@@ -128,11 +128,11 @@ const vector<FurnitureType>& FurnitureFactory::getUpgrades(FurnitureType base) c
 
 FurnitureType FurnitureFactory::getWaterType(double depth) const {
   if (depth >= 2.0)
-    return FurnitureType("WATER");
+    return CONTENT_ID(FurnitureType, "WATER");
   else if (depth >= 1.0)
-    return FurnitureType("SHALLOW_WATER1");
+    return CONTENT_ID(FurnitureType, "SHALLOW_WATER1");
   else
-    return FurnitureType("SHALLOW_WATER2");
+    return CONTENT_ID(FurnitureType, "SHALLOW_WATER2");
 }
 
 FurnitureFactory::~FurnitureFactory() {
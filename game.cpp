@@ -40,6 +40,10 @@
 #include "game_event.h"
 #include "version.h"
 #include "content_factory.h"
+#include "input_recording.h"
+#include "perf_counters.h"
+#include "memory_report.h"
+#include "allocation_tracker.h"
 
 template <class Archive> 
 void Game::serialize(Archive& ar, const unsigned int version) {
@@ -47,6 +51,8 @@ void Game::serialize(Archive& ar, const unsigned int version) {
   ar(villainsByType, collectives, lastTick, playerControl, playerCollective, currentTime);
   ar(musicType, statistics, spectator, tribes, gameIdentifier, players, contentFactory, sunlightTimeOffset);
   ar(gameDisplayName, finishCurrentMusic, models, visited, baseModel, campaign, localTime, turnEvents);
+  if (version >= 2)
+    ar(backgroundTime, nextBackgroundModel);
   if (Archive::is_loading::value)
     sunlightInfo.update(getGlobalTime() + sunlightTimeOffset);
 }
@@ -156,6 +162,10 @@ GlobalTime Game::getGlobalTime() const {
   return GlobalTime((int) currentTime);
 }
 
+double Game::getGlobalTimeDouble() const {
+  return currentTime;
+}
+
 const vector<WCollective>& Game::getVillains(VillainType type) const {
   static vector<WCollective> empty;
   if (villainsByType.count(type))
@@ -253,7 +263,7 @@ void Game::doneRetirement() {
 optional<ExitInfo> Game::updateInput() {
   if (spectator)
     while (1) {
-      UserInput input = view->getAction();
+      UserInput input = getUserInput();
       if (input.getId() == UserInputId::EXIT)
         return ExitInfo(ExitAndQuit());
       if (input.getId() == UserInputId::IDLE)
@@ -261,7 +271,7 @@ optional<ExitInfo> Game::updateInput() {
     }
   if (playerControl && !isTurnBased()) {
     while (1) {
-      UserInput input = view->getAction();
+      UserInput input = getUserInput();
       if (input.getId() == UserInputId::IDLE)
         break;
       else
@@ -300,7 +310,7 @@ void Game::increaseTime(double diff) {
 }
 
 optional<ExitInfo> Game::update(double timeDiff) {
-  ScopeTimer timer("Game::update timer");
+  PerfTimer timer(PerfCounter::GAME_UPDATE_TIME);
   if (auto exitInfo = updateInput())
     return exitInfo;
   considerRealTimeRender();
@@ -319,9 +329,88 @@ optional<ExitInfo> Game::update(double timeDiff) {
     localTime[currentId] += timeDiff;
     increaseTime(timeDiff);
   }
+  if (!exitInfo && options->getBoolValue(OptionId::BACKGROUND_SIMULATION))
+    updateBackgroundModels(getCurrentModel());
   return exitInfo;
 }
 
+// Limits the work done for the inactive models in a single frame. The limit is in creature moves rather than
+// milliseconds, so that the simulation doesn't depend on the speed of the computer.
+static const int maxBackgroundMoves = 200;
+
+void Game::updateBackgroundModels(WModel currentModel) {
+  PerfTimer timer(PerfCounter::BACKGROUND_SIMULATION_TIME);
+  backgroundTime[currentModel->getTopLevel()->getUniqueId()] = currentTime;
+  auto hasPlayer = [&](WModel m) {
+    for (auto c : players)
+      if (c->getPosition().getModel() == m)
+        return true;
+    return false;
+  };
+  vector<WModel> inactive;
+  for (Vec2 v : models.getBounds())
+    if (WModel m = models[v].get())
+      if (m != currentModel && localTime.count(m->getTopLevel()->getUniqueId()) &&
+          (m == getMainModel().get() || campaign->isInInfluence(v)) && !hasPlayer(m))
+        inactive.push_back(m);
+  if (inactive.empty())
+    return;
+  int firstIndex = 0;
+  if (nextBackgroundModel)
+    for (int i : All(inactive))
+      if (inactive[i]->getTopLevel()->getUniqueId() == *nextBackgroundModel)
+        firstIndex = i;
+  int movesLeft = maxBackgroundMoves;
+  for (int i : Range(inactive.size())) {
+    int index = (firstIndex + i) % inactive.size();
+    auto model = inactive[index];
+    auto id = model->getTopLevel()->getUniqueId();
+    if (!backgroundTime.count(id)) {
+      backgroundTime[id] = currentTime;
+      continue;
+    }
+    // Model::update also runs the model's ticks up to the target time, so a model that runs out of moves lags
+    // behind only with its creatures.
+    double targetTime = localTime[id] + currentTime - backgroundTime[id];
+    bool caughtUp = true;
+    backgroundModel = model;
+    while (true) {
+      if (movesLeft == 0) {
+        caughtUp = false;
+        break;
+      }
+      if (!model->update(targetTime))
+        break;
+      --movesLeft;
+      PerfCounters::add(PerfCounter::BACKGROUND_MOVES);
+    }
+    backgroundModel = nullptr;
+    applyPendingTransfers();
+    if (caughtUp) {
+      localTime[id] = targetTime;
+      backgroundTime[id] = currentTime;
+    } else {
+      // Model::update has already moved the model's clock, so keep it, and carry over only the time that
+      // was left to simulate.
+      double progress = model->getLocalTimeDouble();
+      backgroundTime[id] = currentTime - (targetTime - progress);
+      localTime[id] = progress;
+      // The next frame starts with the following model, so that a busy model doesn't starve the others.
+      nextBackgroundModel = inactive[(index + 1) % inactive.size()]->getTopLevel()->getUniqueId();
+      break;
+    }
+    if (exitInfo)
+      break;
+  }
+}
+
+void Game::applyPendingTransfers() {
+  for (auto& transfer : pendingTransfers)
+    if (!transfer.first->isDead())
+      transferCreature(transfer.first, transfer.second);
+  pendingTransfers.clear();
+}
+
 void Game::considerRealTimeRender() {
   auto absoluteTime = view->getTimeMilliAbsolute();
   if (!lastUpdate || absoluteTime - *lastUpdate > milliseconds{10}) {
@@ -355,6 +444,7 @@ bool Game::isVillainActive(WConstCollective col) {
 
 void Game::tick(GlobalTime time) {
   PROFILE_BLOCK("Game::tick");
+  PerfCounters::endTurn();
   if (!turnEvents.empty() && time.getVisibleInt() > *turnEvents.begin()) {
     auto turn = *turnEvents.begin();
     if (turn == 0) {
@@ -427,6 +517,13 @@ Position Game::getTransferPos(WModel from, WModel to) const {
 }
 
 void Game::transferCreature(Creature* c, WModel to) {
+  if (backgroundModel) {
+    for (auto& transfer : pendingTransfers)
+      if (transfer.first == c)
+        return;
+    pendingTransfers.push_back(make_pair(c, to));
+    return;
+  }
   WModel from = c->getLevel()->getModel();
   if (from != to)
     to->transferCreature(from->extractCreature(c), getModelCoords(from) - getModelCoords(to));
@@ -535,6 +632,48 @@ View* Game::getView() const {
   return view;
 }
 
+UserInput Game::getUserInput() {
+  if (inputReplay)
+    return inputReplay->popInput();
+  auto ret = view->getAction();
+  if (ret.getId() == UserInputId::MEMORY_REPORT) {
+    writeMemoryReport();
+    return UserInputId::IDLE;
+  }
+  if (inputRecorder)
+    inputRecorder->addInput(ret);
+  return ret;
+}
+
+void Game::addMemoryUsage(MemoryReport& report) const {
+  for (Vec2 v : models.getBounds())
+    if (models[v])
+      report.addGroup("model " + toString(v.x) + "," + toString(v.y), [&] { models[v]->addMemoryUsage(report); });
+  if (playerControl) {
+    const CreatureView* creatureView = playerControl;
+    report.add("map memory", creatureView->getMemory().getMemoryUsage());
+  }
+}
+
+void Game::writeMemoryReport() {
+  MemoryReport report;
+  addMemoryUsage(report);
+  ofstream out("memory_report.txt");
+  report.write(out);
+  if (AllocationTracker::isEnabled())
+    AllocationTracker::writeReport(out);
+  view->presentText("Memory report", "Estimated " + toString(report.getTotal() / 1024) +
+      " KB in the game state, written to memory_report.txt");
+}
+
+void Game::setInputRecorder(InputRecorder* r) {
+  inputRecorder = r;
+}
+
+void Game::setInputReplay(InputReplay* r) {
+  inputReplay = r;
+}
+
 ContentFactory* Game::getContentFactory() {
   return &*contentFactory;
 }
@@ -709,14 +848,10 @@ void Game::handleMessageBoard(Position pos, Creature* c) {
   int boardId = pos.getHash();
   vector<ListElem> options;
   atomic<bool> cancelled(false);
-  view->displaySplash(nullptr, "Fetching board contents...", SplashType::SMALL, [&] {
-      cancelled = true;
-      fileSharing->cancel();
-      });
   optional<vector<FileSharing::BoardMessage>> messages;
-  thread t([&] { messages = fileSharing->getBoardMessages(boardId); view->clearSplash(); });
-  view->refreshView();
-  t.join();
+  view->doWithSplash(SplashType::SMALL, "Fetching board contents...", 1,
+      [&] (ProgressMeter&) { messages = fileSharing->getBoardMessages(boardId); },
+      [&] { cancelled = true; fileSharing->cancel(); });
   if (!messages || cancelled) {
     view->presentText("", "Couldn't download board contents. Please check your internet connection and "
         "enable online features in the settings.");
@@ -23,6 +23,10 @@ struct CampaignSetup;
 class AvatarInfo;
 class ContentFactory;
 class NameGenerator;
+class InputRecorder;
+class UserInput;
+class InputReplay;
+class MemoryReport;
 
 class Game : public OwnedObject<Game> {
   public:
@@ -33,6 +37,10 @@ class Game : public OwnedObject<Game> {
   Options* getOptions();
   void initialize(Options*, Highscores*, View*, FileSharing*);
   View* getView() const;
+  UserInput getUserInput();
+  void addMemoryUsage(MemoryReport&) const;
+  void setInputRecorder(InputRecorder*);
+  void setInputReplay(InputReplay*);
   ContentFactory* getContentFactory();
   ContentFactory removeContentFactory();
   void exitAction();
@@ -50,6 +58,7 @@ class Game : public OwnedObject<Game> {
   const Statistics& getStatistics() const;
   Tribe* getTribe(TribeId) const;
   GlobalTime getGlobalTime() const;
+  double getGlobalTimeDouble() const;
   WCollective getPlayerCollective() const;
   WPlayerControl getPlayerControl() const;
   void addPlayer(Creature*);
@@ -102,6 +111,9 @@ class Game : public OwnedObject<Game> {
   void tick(GlobalTime);
   Vec2 getModelCoords(const WModel) const;
   bool updateModel(WModel, double timeDiff);
+  void updateBackgroundModels(WModel currentModel);
+  void applyPendingTransfers();
+  void writeMemoryReport();
   string getPlayerName() const;
   void uploadEvent(const string& name, const map<string, string>&);
 
@@ -130,8 +142,16 @@ class Game : public OwnedObject<Game> {
   WCollective SERIAL(playerCollective) = nullptr;
   HeapAllocated<Campaign> SERIAL(campaign);
   bool wasTransfered = false;
+  // Global time up to which each inactive model was simulated in the background.
+  map<LevelId, double> backgroundTime;
+  optional<LevelId> nextBackgroundModel;
+  WModel backgroundModel = nullptr;
+  // Transfers requested by the creatures of backgroundModel. They are applied after its time slice.
+  vector<pair<Creature*, WModel>> pendingTransfers;
   vector<Creature*> SERIAL(players);
   FileSharing* fileSharing = nullptr;
+  InputRecorder* inputRecorder = nullptr;
+  InputReplay* inputReplay = nullptr;
   set<int> SERIAL(turnEvents);
   TimeInterval SERIAL(sunlightTimeOffset);
   friend class GameListener;
@@ -144,4 +164,4 @@ class Game : public OwnedObject<Game> {
   HeapAllocated<ContentFactory> SERIAL(contentFactory);
 };
 
-CEREAL_CLASS_VERSION(Game, 1);
+CEREAL_CLASS_VERSION(Game, 2);
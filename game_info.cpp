@@ -207,3 +207,13 @@ vector<AttributeInfo> AttributeInfo::fromCreature(const Creature* c) {
       ),
     };
 }
+
+void GameInfo::updateChangeStamps() {
+  stamps.playerInfo = combineHash(playerInfo);
+  stamps.villageInfo = combineHash(villageInfo);
+  stamps.tutorial = combineHash(tutorial);
+  // The message buttons refer to the ids of the messages, which aren't part of their hash.
+  stamps.messages = combineHash(messageBuffer);
+  for (auto& message : messageBuffer)
+    stamps.messages = combineHash(stamps.messages, message.getUniqueId());
+}
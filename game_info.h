@@ -410,4 +410,15 @@ class GameInfo {
 
   vector<PlayerMessage> HASH(messageBuffer);
   HASH_ALL(infoType, time, playerInfo, villageInfo, sunlightInfo, messageBuffer, singleModel, modifiedSquares, totalSquares, tutorial, currentLevel)
+
+  /* Hashes of the sections that are drawn as separate panels. They are computed once per GUI rebuild, and
+     the panels are cached by them instead of hashing the same section in every draw function. */
+  struct ChangeStamps {
+    int playerInfo = 0;
+    int villageInfo = 0;
+    int tutorial = 0;
+    int messages = 0;
+  };
+  ChangeStamps stamps;
+  void updateChangeStamps();
 };
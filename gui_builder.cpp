@@ -42,6 +42,7 @@
 #include "tribe_alignment.h"
 #include "avatar_menu_option.h"
 #include "view_object_action.h"
+#include "perf_counters.h"
 
 using SDL::SDL_Keysym;
 using SDL::SDL_Keycode;
@@ -370,6 +371,11 @@ void GuiBuilder::addUpsCounterTick() {
 const int resourceSpace = 110;
 
 SGuiElem GuiBuilder::drawBottomBandInfo(GameInfo& gameInfo) {
+  int hash = combineHash(gameInfo.stamps.playerInfo, gameInfo.stamps.tutorial, gameInfo.sunlightInfo);
+  if (hash == bottomBandHash && bottomBandCache)
+    return bottomBandCache;
+  bottomBandHash = hash;
+  PerfCounters::add(PerfCounter::GUI_PANEL_REBUILDS);
   auto& info = *gameInfo.playerInfo.getReferenceMaybe<CollectiveInfo>();
   GameSunlightInfo& sunlightInfo = gameInfo.sunlightInfo;
   auto topLine = gui.getListBuilder(resourceSpace);
@@ -411,7 +417,7 @@ SGuiElem GuiBuilder::drawBottomBandInfo(GameInfo& gameInfo) {
   bottomLine.addElem(getTurnInfoGui(gameInfo.time), 50);
   bottomLine.addSpace(space);
   bottomLine.addElem(getSunlightInfoGui(sunlightInfo), 80);
-  return gui.getListBuilder(legendLineHeight)
+  return bottomBandCache = gui.getListBuilder(legendLineHeight)
         .addElem(gui.centerHoriz(topLine.buildHorizontalList()))
         .addElem(gui.centerHoriz(bottomLine.buildHorizontalList()))
         .buildVerticalList();
@@ -436,9 +442,11 @@ const char* GuiBuilder::getCurrentGameSpeedName() const {
 SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
   auto getIconHighlight = [&] (Color c) { return gui.topMargin(-1, gui.uiHighlight(c)); };
   auto& collectiveInfo = *info.playerInfo.getReferenceMaybe<CollectiveInfo>();
-  int hash = combineHash(collectiveInfo, info.villageInfo, info.modifiedSquares, info.totalSquares, info.tutorial);
+  int hash = combineHash(info.stamps.playerInfo, info.stamps.villageInfo, info.modifiedSquares, info.totalSquares,
+      info.stamps.tutorial);
   if (hash != rightBandInfoHash) {
     rightBandInfoHash = hash;
+    PerfCounters::add(PerfCounter::GUI_PANEL_REBUILDS);
     vector<SGuiElem> buttons = makeVec(
         gui.icon(gui.BUILDING),
         gui.icon(gui.MINION),
@@ -471,9 +479,9 @@ SGuiElem GuiBuilder::drawRightBandInfo(GameInfo& info) {
             buttons[1]);
     }
     vector<pair<CollectiveTab, SGuiElem>> elems = makeVec(
-        make_pair(CollectiveTab::MINIONS, drawMinions(collectiveInfo, info.tutorial)),
-        make_pair(CollectiveTab::BUILDINGS, cache->get(bindMethod(
-            &GuiBuilder::drawBuildings, this), THIS_LINE, collectiveInfo, info.tutorial)),
+        make_pair(CollectiveTab::MINIONS, drawMinions(collectiveInfo, info.tutorial, info.stamps.playerInfo)),
+        make_pair(CollectiveTab::BUILDINGS, cache->getStamped(bindMethod(&GuiBuilder::drawBuildings, this),
+            THIS_LINE, combineHash(info.stamps.playerInfo, info.stamps.tutorial), collectiveInfo, info.tutorial)),
         make_pair(CollectiveTab::KEY_MAPPING, drawKeeperHelp()),
         make_pair(CollectiveTab::TECHNOLOGY, drawTechnology(collectiveInfo))
     );
@@ -1792,8 +1800,8 @@ vector<SGuiElem> GuiBuilder::getSettingsButtons() {
     );
 }
 
-SGuiElem GuiBuilder::drawMinions(CollectiveInfo& info, const optional<TutorialInfo>& tutorial) {
-  int newHash = info.getHash();
+SGuiElem GuiBuilder::drawMinions(CollectiveInfo& info, const optional<TutorialInfo>& tutorial, int changeStamp) {
+  int newHash = changeStamp;
   if (newHash != minionsHash) {
     minionsHash = newHash;
     auto list = gui.getListBuilder(legendLineHeight);
@@ -2379,43 +2387,44 @@ SGuiElem GuiBuilder::drawMapHintOverlay() {
 
 void GuiBuilder::drawOverlays(vector<OverlayInfo>& ret, GameInfo& info) {
   if (info.tutorial)
-    ret.push_back({cache->get(bindMethod(&GuiBuilder::drawTutorialOverlay, this), THIS_LINE,
-         *info.tutorial), OverlayInfo::TUTORIAL});
+    ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawTutorialOverlay, this), THIS_LINE,
+         info.stamps.tutorial, *info.tutorial), OverlayInfo::TUTORIAL});
   switch (info.infoType) {
     case GameInfo::InfoType::BAND: {
       auto& collectiveInfo = *info.playerInfo.getReferenceMaybe<CollectiveInfo>();
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawVillainsOverlay, this), THIS_LINE,
-           info.villageInfo), OverlayInfo::VILLAINS});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawImmigrationOverlay, this), THIS_LINE,
-           collectiveInfo, info.tutorial), OverlayInfo::IMMIGRATION});
+      int collectiveStamp = combineHash(info.stamps.playerInfo, info.stamps.tutorial);
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawVillainsOverlay, this), THIS_LINE,
+           info.stamps.villageInfo, info.villageInfo), OverlayInfo::VILLAINS});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawImmigrationOverlay, this), THIS_LINE,
+           collectiveStamp, collectiveInfo, info.tutorial), OverlayInfo::IMMIGRATION});
       ret.push_back({cache->get(bindMethod(&GuiBuilder::drawRansomOverlay, this), THIS_LINE,
            collectiveInfo.ransom), OverlayInfo::TOP_LEFT});
       ret.push_back({cache->get(bindMethod(&GuiBuilder::drawWarningWindow, this), THIS_LINE,
            collectiveInfo.rebellionChance, collectiveInfo.nextWave), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawMinionsOverlay, this), THIS_LINE,
-           collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawWorkshopsOverlay, this), THIS_LINE,
-           collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawLibraryOverlay, this), THIS_LINE,
-           collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawTasksOverlay, this), THIS_LINE,
-           collectiveInfo), OverlayInfo::TOP_LEFT});
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawBuildingsOverlay, this), THIS_LINE,
-           collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawMinionsOverlay, this), THIS_LINE,
+           collectiveStamp, collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawWorkshopsOverlay, this), THIS_LINE,
+           collectiveStamp, collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawLibraryOverlay, this), THIS_LINE,
+           collectiveStamp, collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawTasksOverlay, this), THIS_LINE,
+           info.stamps.playerInfo, collectiveInfo), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawBuildingsOverlay, this), THIS_LINE,
+           collectiveStamp, collectiveInfo, info.tutorial), OverlayInfo::TOP_LEFT});
       if (bottomWindow == IMMIGRATION_HELP)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawImmigrationHelp, this), THIS_LINE,
-            collectiveInfo), OverlayInfo::BOTTOM_LEFT});
+        ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawImmigrationHelp, this), THIS_LINE,
+            info.stamps.playerInfo, collectiveInfo), OverlayInfo::BOTTOM_LEFT});
       if (bottomWindow == ALL_VILLAINS)
-        ret.push_back({cache->get(bindMethod(&GuiBuilder::drawAllVillainsOverlay, this), THIS_LINE,
-            info.villageInfo), OverlayInfo::BOTTOM_LEFT});
+        ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawAllVillainsOverlay, this), THIS_LINE,
+            info.stamps.villageInfo, info.villageInfo), OverlayInfo::BOTTOM_LEFT});
       ret.push_back({cache->get(bindMethod(&GuiBuilder::drawGameSpeedDialog, this), THIS_LINE),
            OverlayInfo::GAME_SPEED});
       break;
     }
     case GameInfo::InfoType::PLAYER: {
       auto& playerInfo = *info.playerInfo.getReferenceMaybe<PlayerInfo>();
-      ret.push_back({cache->get(bindMethod(&GuiBuilder::drawPlayerOverlay, this), THIS_LINE,
-           playerInfo), OverlayInfo::TOP_LEFT});
+      ret.push_back({cache->getStamped(bindMethod(&GuiBuilder::drawPlayerOverlay, this), THIS_LINE,
+           info.stamps.playerInfo, playerInfo), OverlayInfo::TOP_LEFT});
       break;
     }
     default:
@@ -2497,7 +2506,13 @@ static void cutToFit(Renderer& renderer, string& s, int maxLength) {
     s.pop_back();
 }
 
-SGuiElem GuiBuilder::drawMessages(const vector<PlayerMessage>& messageBuffer, int maxMessageLength) {
+SGuiElem GuiBuilder::drawMessages(const GameInfo& info, int maxMessageLength) {
+  int hash = combineHash(info.stamps.messages, maxMessageLength);
+  if (hash == messagesHash && messagesCache)
+    return messagesCache;
+  messagesHash = hash;
+  PerfCounters::add(PerfCounter::GUI_PANEL_REBUILDS);
+  auto& messageBuffer = info.messageBuffer;
   int hMargin = 10;
   int vMargin = 5;
   vector<vector<PlayerMessage>> messages = fitMessages(renderer, messageBuffer, maxMessageLength - 2 * hMargin,
@@ -2523,10 +2538,10 @@ SGuiElem GuiBuilder::drawMessages(const vector<PlayerMessage>& messageBuffer, in
       lines.push_back(line.buildHorizontalList());
   }
   if (!lines.empty())
-    return gui.setWidth(maxMessageLength, gui.translucentBackground(
+    return messagesCache = gui.setWidth(maxMessageLength, gui.translucentBackground(
         gui.margins(gui.verticalList(std::move(lines), lineHeight), hMargin, vMargin, hMargin, vMargin)));
   else
-    return gui.empty();
+    return messagesCache = gui.empty();
 }
 
 const double menuLabelVPadding = 0.15;
@@ -69,7 +69,7 @@ class GuiBuilder {
   SGuiElem drawPlayerInventory(const PlayerInfo&);
   SGuiElem drawRightBandInfo(GameInfo&);
   SGuiElem drawTechnology(CollectiveInfo&);
-  SGuiElem drawMinions(CollectiveInfo&, const optional<TutorialInfo>&);
+  SGuiElem drawMinions(CollectiveInfo&, const optional<TutorialInfo>&, int changeStamp);
   SGuiElem drawBottomBandInfo(GameInfo&);
   SGuiElem drawKeeperHelp();
   optional<string> getTextInput(const string& title, const string& value, int maxLength, const string& hint);
@@ -80,7 +80,7 @@ class GuiBuilder {
   };
   SGuiElem drawPlayerOverlay(const PlayerInfo&);
   void drawOverlays(vector<OverlayInfo>&, GameInfo&);
-  SGuiElem drawMessages(const vector<PlayerMessage>&, int guiLength);
+  SGuiElem drawMessages(const GameInfo&, int guiLength);
   SGuiElem drawGameSpeedDialog();
   SGuiElem drawImmigrationOverlay(const CollectiveInfo&, const optional<TutorialInfo>&);
   SGuiElem drawImmigrationHelp(const CollectiveInfo&);
@@ -163,6 +163,9 @@ class GuiBuilder {
   //SGuiElem getExpIncreaseLine(const PlayerInfo::LevelInfo&, ExperienceType);
   SGuiElem drawBuildings(const CollectiveInfo&, const optional<TutorialInfo>&);
   SGuiElem bottomBandCache;
+  int bottomBandHash = 0;
+  SGuiElem messagesCache;
+  int messagesHash = 0;
   SGuiElem drawMinionButtons(const vector<PlayerInfo>&, UniqueEntity<Creature>::Id current, optional<TeamId> teamId);
   SGuiElem minionButtonsCache;
   int minionButtonsHash = 0;
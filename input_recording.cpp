@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "input_recording.h"
+#include "file_path.h"
+
+InputRecorder::InputRecorder(const FilePath& path, int seed, int saveVersion, const string& gameState)
+    : output(path.getPath()) {
+  output.getArchive() << seed << saveVersion << gameState;
+}
+
+InputRecorder::~InputRecorder() {
+  flushFrame();
+}
+
+void InputRecorder::flushFrame() {
+  if (currentFrame)
+    output.getArchive() << *currentFrame;
+  currentFrame = none;
+}
+
+void InputRecorder::startFrame(double time, double step) {
+  flushFrame();
+  currentFrame = RecordedFrame{time, step, {}};
+}
+
+void InputRecorder::addInput(const UserInput& input) {
+  CHECK(!!currentFrame);
+  currentFrame->inputs.push_back(input);
+}
+
+InputReplay::InputReplay(const FilePath& path) : input(path.getPath()) {
+  USER_CHECK(input.getStream().good()) << "Couldn't open replay file: " << path;
+  input.getArchive() >> seed >> saveVersion >> gameState;
+}
+
+int InputReplay::getSeed() const {
+  return seed;
+}
+
+int InputReplay::getSaveVersion() const {
+  return saveVersion;
+}
+
+const string& InputReplay::getGameState() const {
+  return gameState;
+}
+
+optional<RecordedFrame> InputReplay::nextFrame() {
+  if (!frameInputs.empty()) {
+    INFO << "Replay: " << frameInputs.size() << " inputs not consumed in frame " << frameIndex;
+    ++numDesyncs;
+  }
+  try {
+    RecordedFrame frame;
+    input.getArchive() >> frame;
+    ++frameIndex;
+    frameInputs = frame.inputs;
+    std::reverse(frameInputs.begin(), frameInputs.end());
+    return frame;
+  } catch (std::exception&) {
+    frameInputs.clear();
+    return none;
+  }
+}
+
+UserInput InputReplay::popInput() {
+  if (frameInputs.empty())
+    return UserInputId::IDLE;
+  auto ret = frameInputs.back();
+  frameInputs.pop_back();
+  return ret;
+}
+
+int InputReplay::getNumDesyncs() const {
+  return numDesyncs;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "util.h"
+#include "user_input.h"
+#include "parse_game.h"
+
+class FilePath;
+
+// All UserInputs consumed during one call to Game::update, stamped with the game time at the start of the call.
+struct RecordedFrame {
+  double SERIAL(time);
+  double SERIAL(step);
+  vector<UserInput> SERIAL(inputs);
+  SERIALIZE_ALL(time, step, inputs)
+};
+
+/* The recording file starts with the RNG seed and the serialized starting state of the game,
+   followed by a RecordedFrame for every game update. */
+class InputRecorder {
+  public:
+  InputRecorder(const FilePath&, int seed, int saveVersion, const string& gameState);
+  ~InputRecorder();
+  void startFrame(double time, double step);
+  void addInput(const UserInput&);
+
+  private:
+  void flushFrame();
+  CompressedOutput output;
+  optional<RecordedFrame> currentFrame;
+};
+
+class InputReplay {
+  public:
+  InputReplay(const FilePath&);
+  int getSeed() const;
+  int getSaveVersion() const;
+  const string& getGameState() const;
+  optional<RecordedFrame> nextFrame();
+  UserInput popInput();
+  // Number of recorded inputs that the game didn't consume when expected.
+  int getNumDesyncs() const;
+
+  private:
+  CompressedInput input;
+  int seed;
+  int saveVersion;
+  string gameState;
+  vector<UserInput> frameInputs;
+  int frameIndex = 0;
+  int numDesyncs = 0;
+};
@@ -124,8 +124,9 @@ double Inventory::getTotalWeight() const {
   return weight;
 }
 
-void Inventory::tick(Position pos) {
+bool Inventory::tick(Position pos) {
   PROFILE_BLOCK("Inventory::tick");
+  bool changed = false;
   vector<WeakPointer<Item>> itemsCopy = getItems().transform([](const auto& it){ return it->getThis(); });
   for (auto item : itemsCopy)
     if (item && hasItem(item.get())) {
@@ -136,10 +137,14 @@ void Inventory::tick(Position pos) {
       if (newViewId != oldViewId) {
         addViewId(oldViewId, -1);
         addViewId(newViewId, 1);
+        changed = true;
       }
-      if (item->isDiscarded() && hasItem(item.get()))
+      if (item->isDiscarded() && hasItem(item.get())) {
         removeItem(item.get());
+        changed = true;
+      }
     }
+  return changed;
 }
 
 bool Inventory::containsAnyOf(const EntitySet<Item>& items) const {
@@ -46,7 +46,8 @@ class Inventory {
   Item* getItemById(UniqueEntity<Item>::Id) const;
   int size() const;
   double getTotalWeight() const;
-  void tick(Position);
+  // Returns true if an item was removed or changed how it looks, for example a corpse that rotted.
+  bool tick(Position);
   bool containsAnyOf(const EntitySet<Item>&) const;
 
   bool isEmpty() const;
@@ -36,17 +36,57 @@
 #include "creature_name.h"
 #include "creature_attributes.h"
 
+static void serializeAttributes(OutputArchive& ar, const shared_ptr<const ItemAttributes>& attributes) {
+  if (auto table = ItemAttributesTable::get(&ar)) {
+    auto it = table->savedIndexes.find(attributes.get());
+    bool firstOccurrence = it == table->savedIndexes.end();
+    int index = firstOccurrence ? table->savedIndexes.size() : it->second;
+    ar(index);
+    if (firstOccurrence) {
+      table->savedIndexes[attributes.get()] = index;
+      ar(*attributes);
+    }
+  } else
+    // Same format as the HeapAllocated that used to hold the attributes.
+    ar(cereal::make_nvp("valid", std::uint8_t(1)), *attributes);
+}
+
+static void serializeAttributes(InputArchive& ar, shared_ptr<const ItemAttributes>& attributes) {
+  if (auto table = ItemAttributesTable::get(&ar)) {
+    int index;
+    ar(index);
+    if (index == table->loaded.size()) {
+      ItemAttributes loaded;
+      ar(loaded);
+      table->loaded.push_back(make_shared<const ItemAttributes>(std::move(loaded)));
+    }
+    if (index < 0 || index >= table->loaded.size())
+      throw cereal::Exception("Bad item attributes index: " + toString(index));
+    attributes = table->loaded[index];
+  } else {
+    std::uint8_t valid;
+    ItemAttributes loaded;
+    ar(valid, loaded);
+    attributes = make_shared<const ItemAttributes>(std::move(loaded));
+  }
+}
+
 template <class Archive> 
 void Item::serialize(Archive& ar, const unsigned int version) {
   ar & SUBCLASS(OwnedObject<Item>) & SUBCLASS(UniqueEntity) & SUBCLASS(Renderable);
-  ar(attributes, discarded, shopkeeper, fire, classCache, canEquipCache, timeout);
+  serializeAttributes(ar, attributes);
+  ar(discarded, shopkeeper, fire, classCache, canEquipCache, timeout);
 }
 
 SERIALIZABLE(Item)
 SERIALIZATION_CONSTRUCTOR_IMPL(Item)
 
-Item::Item(const ItemAttributes& attr) : Renderable(ViewObject(*attr.viewId, ViewLayer::ITEM, capitalFirst(*attr.name))),
-    attributes(attr), fire(attr.burnTime), canEquipCache(!!attributes->equipmentSlot),
+Item::Item(const ItemAttributes& attr) : Item(make_shared<const ItemAttributes>(attr)) {
+}
+
+Item::Item(shared_ptr<const ItemAttributes> attr)
+    : Renderable(ViewObject(*attr->viewId, ViewLayer::ITEM, capitalFirst(*attr->name))),
+    attributes(std::move(attr)), fire(attributes->burnTime), canEquipCache(!!attributes->equipmentSlot),
     classCache(*attributes->itemClass) {
   if (!attributes->prefixes.empty())
     modViewObject().setModifier(ViewObject::Modifier::AURA);
@@ -56,8 +96,25 @@ Item::Item(const ItemAttributes& attr) : Renderable(ViewObject(*attr.viewId, Vie
 Item::~Item() {
 }
 
+long long Item::getMemoryUsage(unordered_set<const ItemAttributes*>& countedAttributes) const {
+  long long ret = sizeof(*this);
+  if (countedAttributes.insert(attributes.get()).second)
+    ret += sizeof(ItemAttributes);
+  return ret;
+}
+
 PItem Item::getCopy() const {
-  return makeOwner<Item>(*attributes);
+  if (ownedAttributes)
+    return makeOwner<Item>(*attributes);
+  return makeOwner<Item>(attributes);
+}
+
+ItemAttributes& Item::modifyAttributes() {
+  if (!ownedAttributes) {
+    ownedAttributes = make_shared<ItemAttributes>(*attributes);
+    attributes = ownedAttributes;
+  }
+  return *ownedAttributes;
 }
 
 ItemPredicate Item::effectPredicate(Effect type) {
@@ -153,7 +210,7 @@ void Item::tick(Position position) {
 
 void Item::applyPrefix(const ItemPrefix& prefix) {
   modViewObject().setModifier(ViewObject::Modifier::AURA);
-  ::applyPrefix(prefix, *attributes);
+  ::applyPrefix(prefix, modifyAttributes());
 }
 
 void Item::setTimeout(GlobalTime t) {
@@ -284,7 +341,7 @@ void Item::applySpecial(Creature* c) {
     c->getGame()->getStatistics().add(StatId::SCROLL_READ);
   if (attributes->effect)
     attributes->effect->apply(c->getPosition(), c);
-  if (attributes->uses > -1 && --attributes->uses == 0) {
+  if (attributes->uses > -1 && --modifyAttributes().uses == 0) {
     discarded = true;
     if (attributes->usedUpMsg)
       c->privateMessage(getTheName() + " is used up.");
@@ -332,7 +389,7 @@ string Item::getNoSeeApplyMsg() const {
 }
 
 void Item::setName(const string& n) {
-  attributes->name = n;
+  modifyAttributes().name = n;
 }
 
 Creature* Item::getShopkeeper(const Creature* owner) const {
@@ -419,7 +476,7 @@ const optional<string>& Item::getArtifactName() const {
 }
 
 void Item::setArtifactName(const string& s) {
-  attributes->artifactName = s;
+  modifyAttributes().artifactName = s;
 }
 
 string Item::getSuffix() const {
@@ -514,7 +571,7 @@ EquipmentSlot Item::getEquipmentSlot() const {
 }
 
 void Item::addModifier(AttrType type, int value) {
-  attributes->modifiers[type] += value;
+  modifyAttributes().modifiers[type] += value;
 }
 
 int Item::getModifier(AttrType type) const {
@@ -38,8 +38,12 @@ class ItemType;
 class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<Item> {
   public:
   Item(const ItemAttributes&);
+  // The attributes may be shared with other items, they are copied before the first modification.
+  Item(shared_ptr<const ItemAttributes>);
   virtual ~Item();
   PItem getCopy() const;
+  // Counts the item and its attributes, unless they are shared with an item that was counted already.
+  long long getMemoryUsage(unordered_set<const ItemAttributes*>& countedAttributes) const;
 
   void apply(Creature*, bool noSound = false);
 
@@ -130,7 +134,11 @@ class Item : public Renderable, public UniqueEntity<Item>, public OwnedObject<It
   string getModifiers(bool shorten = false) const;
   string getVisibleName(bool plural) const;
   string getBlindName(bool plural) const;
-  HeapAllocated<ItemAttributes> SERIAL(attributes);
+  ItemAttributes& modifyAttributes();
+  // Shared with other items until the first modification.
+  shared_ptr<const ItemAttributes> SERIAL(attributes);
+  // Points to the same instance as attributes once the item has its own copy.
+  shared_ptr<ItemAttributes> ownedAttributes;
   optional<UniqueEntity<Creature>::Id> SERIAL(shopkeeper);
   HeapAllocated<Fire> SERIAL(fire);
   bool SERIAL(canEquipCache);
@@ -35,6 +35,23 @@ void ItemAttributes::serialize(Archive& ar, const unsigned int version) {
 SERIALIZABLE(ItemAttributes);
 SERIALIZATION_CONSTRUCTOR_IMPL(ItemAttributes);
 
+static thread_local ItemAttributesTable* currentTable = nullptr;
+
+ItemAttributesTable::ItemAttributesTable(const void* archive) : archive(archive), previous(currentTable) {
+  currentTable = this;
+}
+
+ItemAttributesTable::~ItemAttributesTable() {
+  currentTable = previous;
+}
+
+ItemAttributesTable* ItemAttributesTable::get(const void* archive) {
+  for (auto table = currentTable; table; table = table->previous)
+    if (table->archive == archive)
+      return table;
+  return nullptr;
+}
+
 #include "pretty_archive.h"
 template
 void ItemAttributes::serialize(PrettyInputArchive& ar1, unsigned);
@@ -77,3 +77,22 @@ class ItemAttributes {
   double SERIAL(damageReduction) = 0;
   optional<ItemType> SERIAL(ingredientFor);
 };
+
+/* While an instance is alive, Items that the current thread serializes through the given archive store their
+   attributes as indices into a per-archive table, so that attributes shared by many items are written only once.
+   An archive written with a table must be read with one. */
+class ItemAttributesTable {
+  public:
+  ItemAttributesTable(const void* archive);
+  ~ItemAttributesTable();
+  ItemAttributesTable(const ItemAttributesTable&) = delete;
+  ItemAttributesTable& operator = (const ItemAttributesTable&) = delete;
+  static ItemAttributesTable* get(const void* archive);
+
+  unordered_map<const ItemAttributes*, int> savedIndexes;
+  vector<shared_ptr<const ItemAttributes>> loaded;
+
+  private:
+  const void* archive;
+  ItemAttributesTable* previous;
+};
@@ -88,7 +88,7 @@ ItemType& ItemType::operator = (ItemType&&) = default;
 
 class FireScrollItem : public Item {
   public:
-  FireScrollItem(const ItemAttributes& attr) : Item(attr) {}
+  FireScrollItem(shared_ptr<const ItemAttributes> attr) : Item(std::move(attr)) {}
 
   virtual void applySpecial(Creature* c) override {
     fireDamage(c->getPosition());
@@ -185,7 +185,7 @@ PItem ItemFactory::corpse(const string& name, const string& rottenName, double w
 
 class PotionItem : public Item {
   public:
-  PotionItem(const ItemAttributes& attr) : Item(attr) {}
+  PotionItem(shared_ptr<const ItemAttributes> attr) : Item(std::move(attr)) {}
 
   virtual void fireDamage(Position position) override {
     heat += 0.3;
@@ -214,7 +214,7 @@ class PotionItem : public Item {
 
 class TechBookItem : public Item {
   public:
-  TechBookItem(const ItemAttributes& attr, TechId t) : Item(attr), tech(t) {}
+  TechBookItem(shared_ptr<const ItemAttributes> attr, TechId t) : Item(std::move(attr)), tech(t) {}
 
   virtual void applySpecial(Creature* c) override {
     if (!read) {
@@ -241,10 +241,35 @@ ItemAttributes ItemType::getAttributes(const ContentFactory* factory) const {
   return type.visit([&](const auto& t) { return t.getAttributes(factory); });
 }
 
+// Items without a prefix share the attributes of their type. They are interned once per type in the ContentFactory,
+// so creating an item doesn't need to compare its attributes with the existing ones.
+shared_ptr<const ItemAttributes> ItemType::getSharedAttributes(const ContentFactory* factory) const {
+  if (!factory)
+    return make_shared<const ItemAttributes>(getAttributes(factory));
+  shared_ptr<const ItemAttributes>* ret = nullptr;
+  if (auto id = type.getValueMaybe<Simple>())
+    ret = &factory->sharedCustomItemAttributes[*id];
+  else {
+    // The other types are small, so their serialized form is a cheap key.
+    std::ostringstream key;
+    {
+      OutputArchive archive(key);
+      archive << type;
+    }
+    ret = &factory->sharedItemAttributes[key.str()];
+  }
+  if (!*ret)
+    *ret = make_shared<const ItemAttributes>(getAttributes(factory));
+  return *ret;
+}
+
 PItem ItemType::get(const ContentFactory* factory) const {
-  auto attributes = getAttributes(factory);
-  if (!attributes.genPrefixes.empty() && Random.chance(prefixChance))
-    applyPrefix(Random.choose(attributes.genPrefixes), attributes);
+  auto attributes = getSharedAttributes(factory);
+  if (!attributes->genPrefixes.empty() && Random.chance(prefixChance)) {
+    auto prefixed = make_shared<ItemAttributes>(*attributes);
+    applyPrefix(Random.choose(prefixed->genPrefixes), *prefixed);
+    attributes = std::move(prefixed);
+  }
   return type.visit(
       [&](const FireScroll&) {
         return makeOwner<FireScrollItem>(std::move(attributes));
@@ -113,5 +113,6 @@ class ItemType {
   private:
   Type SERIAL(type);
   ItemAttributes getAttributes(const ContentFactory*) const;
+  shared_ptr<const ItemAttributes> getSharedAttributes(const ContentFactory*) const;
   double SERIAL(prefixChance) = 0.0;
 };
@@ -13,3 +13,10 @@ vector<string> KeyVerifier::verify() {
   }
   return ret;
 }
+
+map<string, set<string>> KeyVerifier::getKeys() const {
+  map<string, set<string>> ret;
+  for (auto& verifier : verifiers)
+    ret[verifier.first.name()] = verifier.second.keys;
+  return ret;
+}
@@ -12,7 +12,11 @@ class KeyVerifier {
 
   template <typename T>
   void verifyContentId(string id) {
-    verifiers[typeid(T)].toVerify.insert(std::move(id));
+    verifyContentId(typeid(T), std::move(id));
+  }
+
+  void verifyContentId(std::type_index type, string id) {
+    verifiers[type].toVerify.insert(std::move(id));
   }
 
   template <typename T>
@@ -25,6 +29,9 @@ class KeyVerifier {
 
   vector<string> verify();
 
+  // The keys of every type by the type's name, e.g. to check ids against data that wasn't parsed again.
+  map<string, set<string>> getKeys() const;
+
   private:
   map<std::type_index, Verifier> verifiers;
 };
@@ -40,6 +40,13 @@
 #include "portals.h"
 #include "roof_support.h"
 #include "game_event.h"
+#include "diffusion_field.h"
+#include "view_index_cache.h"
+#include "morale_influence.h"
+#include "memory_report.h"
+#include "equipment.h"
+#include "inventory.h"
+#include "poison_gas.h"
 
 template <class Archive> 
 void Level::serialize(Archive& ar, const unsigned int version) {
@@ -48,6 +55,18 @@ void Level::serialize(Archive& ar, const unsigned int version) {
   ar(sunlight, bucketMap, lightAmount, unavailable);
   ar(levelId, noDiagonalPassing, lightCapAmount, creatureIds, memoryUpdates);
   ar(furniture, tickingFurniture, covered, roofSupport, portals, furnitureEffects);
+  if (version >= 1)
+    ar(poisonGas);
+  else if (Archive::is_loading::value) {
+    poisonGas.reset(DiffusionField(getBounds()));
+    auto& loadedAmounts = PoisonGas::getLoadedAmounts();
+    if (!loadedAmounts.empty())
+      for (Vec2 v : getBounds())
+        if (auto amount = getValueMaybe(loadedAmounts, squares->getReadonly(v))) {
+          poisonGas->add(v, *amount);
+          loadedAmounts.erase(squares->getReadonly(v));
+        }
+  }
   if (Archive::is_loading::value) // some code requires these Sectors to be always initialized
     getSectors({MovementTrait::WALK});
 }  
@@ -60,7 +79,7 @@ Level::~Level() {}
 
 Level::Level(Private, SquareArray s, FurnitureArray f, WModel m, Table<double> sun, LevelId id)
     : squares(std::move(s)), furniture(std::move(f)),
-      memoryUpdates(squares->getBounds(), true), model(m),
+      memoryUpdates(squares->getBounds(), true), poisonGas(squares->getBounds()), model(m),
       sunlight(sun), roofSupport(squares->getBounds()),
       bucketMap(squares->getBounds().width(), squares->getBounds().height(),
       FieldOfView::sightRange), lightAmount(squares->getBounds(), 0), lightCapAmount(squares->getBounds(), 1),
@@ -319,7 +338,7 @@ optional<Position> Level::getClosestLanding(vector<Position> landing, Creature*
     if (v.canEnter(creature))
       return v;
     else
-      for (Position next : v.neighbors8(Random))
+      for (Position next : v.fixedNeighbors8(Random))
         if (!marked.count(next) && next.canEnterEmpty(creature)) {
           q.push(next);
           marked.insert(next);
@@ -494,14 +513,75 @@ void Level::addTickingFurniture(Vec2 pos) {
   tickingFurniture.insert(pos);
 }
 
+// The gas decays a little on every tile every turn, so a tile is only redrawn once its amount has changed by
+// a visible step, or when the gas appears or disappears.
+static int getVisibleGasLevel(float amount) {
+  return amount > 0 ? 1 + int(amount * 20) : 0;
+}
+
+void Level::tickPoisonGas() {
+  poisonGas->tick([this](Vec2 v) { return Position(v, this).canSeeThru(VisionId::NORMAL); },
+      [this](Vec2 v, float previous) {
+        if (getVisibleGasLevel(previous) != getVisibleGasLevel(poisonGas->get(v)))
+          Position(v, this).setNeedsRenderAndMemoryUpdate(true);
+      });
+  if (auto& area = poisonGas->getActiveArea())
+    for (Vec2 v : *area) {
+      auto amount = poisonGas->get(v);
+      if (amount > 0.2)
+        if (auto creature = Position(v, this).getCreature())
+          creature->poisonWithGas(min(1.0f, amount));
+    }
+}
+
 void Level::tick() {
   PROFILE_BLOCK("Level::tick");
   for (Vec2 pos : tickingSquares)
     squares->getWritable(pos)->tick(Position(pos, this));
+  tickPoisonGas();
   for (Vec2 pos : tickingFurniture)
     for (auto layer : ENUM_ALL(FurnitureLayer))
-      if (auto f = furniture->getBuilt(layer).getWritable(pos))
+      if (auto f = furniture->getBuilt(layer).getWritable(pos)) {
         f->tick(Position(pos, this));
+        if (viewIndexCache)
+          viewIndexCache->invalidate(pos);
+      }
+}
+
+void Level::addMemoryUsage(MemoryReport& report) const {
+  report.add("squares", squares->getMemoryUsage());
+  report.add("furniture", furniture->getMemoryUsage());
+  long long tables = getMemoryUsage(memoryUpdates) + getMemoryUsage(renderUpdates) + getMemoryUsage(unavailable) +
+      getMemoryUsage(sunlight) + getMemoryUsage(covered) + getMemoryUsage(lightAmount) +
+      getMemoryUsage(lightCapAmount);
+  for (auto tribe : ENUM_ALL(TribeId::KeyType))
+    if (auto& effects = furnitureEffects[tribe])
+      tables += getMemoryUsage(*effects);
+  report.add("tile tables", tables);
+  long long fov = 0;
+  for (auto vision : ENUM_ALL(VisionId))
+    fov += (*fieldOfView)[vision].getMemoryUsage();
+  report.add("field of view", fov);
+  long long sectorsSize = getNodeMemoryUsage(sectors);
+  for (auto& elem : sectors)
+    sectorsSize += elem.second.getMemoryUsage();
+  report.add("sectors", sectorsSize);
+  report.add("poison gas", poisonGas->getMemoryUsage());
+  report.add("caches", (viewIndexCache ? viewIndexCache->getMemoryUsage() : 0) +
+      (moraleInfluenceCache ? moraleInfluenceCache->getMemoryUsage() : 0));
+  unordered_set<const ItemAttributes*> attributes;
+  long long items = 0;
+  for (Vec2 v : getBounds())
+    for (auto item : squares->getReadonly(v)->getInventory().getItems())
+      items += item->getMemoryUsage(attributes);
+  long long creatureSize = getMemoryUsage(creatures);
+  for (auto c : creatures) {
+    creatureSize += sizeof(Creature);
+    for (auto item : c->getEquipment().getItems())
+      items += item->getMemoryUsage(attributes);
+  }
+  report.add("creatures", creatureSize);
+  report.add("items", items);
 }
 
 bool Level::inBounds(Vec2 pos) const {
@@ -561,8 +641,11 @@ int Level::getNumTotalSquares() const {
 }
 
 void Level::setNeedsMemoryUpdate(Vec2 pos, bool s) {
-  if (pos.inRectangle(getBounds()))
+  if (pos.inRectangle(getBounds())) {
     memoryUpdates[pos] = s;
+    if (s && viewIndexCache)
+      viewIndexCache->invalidate(pos);
+  }
 }
 
 bool Level::needsRenderUpdate(Vec2 pos) const {
@@ -570,7 +653,34 @@ bool Level::needsRenderUpdate(Vec2 pos) const {
 }
 
 void Level::setNeedsRenderUpdate(Vec2 pos, bool s) {
+  if (s && !renderUpdates[pos])
+    renderUpdateList.push_back(pos);
   renderUpdates[pos] = s;
+  if (s && viewIndexCache)
+    viewIndexCache->invalidate(pos);
+}
+
+ViewIndexCache& Level::getViewIndexCache() const {
+  if (!viewIndexCache)
+    viewIndexCache = unique<ViewIndexCache>(getBounds());
+  return *viewIndexCache;
+}
+
+MoraleInfluenceCache& Level::getMoraleInfluenceCache() const {
+  if (!moraleInfluenceCache)
+    moraleInfluenceCache = unique<MoraleInfluenceCache>(getBounds());
+  return *moraleInfluenceCache;
+}
+
+vector<Vec2> Level::popRenderUpdates() {
+  vector<Vec2> ret;
+  for (Vec2 pos : renderUpdateList)
+    if (renderUpdates[pos]) {
+      renderUpdates[pos] = false;
+      ret.push_back(pos);
+    }
+  renderUpdateList.clear();
+  return ret;
 }
 
 bool Level::needsMemoryUpdate(Vec2 pos) const {
@@ -29,6 +29,7 @@ class Model;
 class Square;
 class Player;
 class LevelMaker;
+class DiffusionField;
 class Attack;
 class ProgressMeter;
 class Sectors;
@@ -44,6 +45,9 @@ class Vision;
 class FieldOfView;
 class Portals;
 class RoofSupport;
+class ViewIndexCache;
+class MemoryReport;
+class MoraleInfluenceCache;
 
 /** A class representing a single level of the dungeon or the overworld. All events occuring on the level are performed by this class.*/
 class Level : public OwnedObject<Level> {
@@ -117,6 +121,8 @@ class Level : public OwnedObject<Level> {
   /** Ticks all squares that must be ticked. */
   void tick();
 
+  void addMemoryUsage(MemoryReport&) const;
+
   /** Moves the creature to a different level according to \paramname{direction}. */
   void changeLevel(StairKey key, Creature* c);
 
@@ -165,6 +171,8 @@ class Level : public OwnedObject<Level> {
   bool needsMemoryUpdate(Vec2) const;
   bool needsRenderUpdate(Vec2) const;
   void setNeedsRenderUpdate(Vec2, bool);
+  /** Returns the tiles that need a render update since the last call and clears their flags.*/
+  vector<Vec2> popRenderUpdates();
 
   LevelId getUniqueId() const;
   void setFurniture(Vec2, PFurniture);
@@ -186,11 +194,18 @@ class Level : public OwnedObject<Level> {
   HeapAllocated<SquareArray> SERIAL(squares);
   HeapAllocated<FurnitureArray> SERIAL(furniture);
   Table<bool> SERIAL(memoryUpdates);
-  Table<bool> renderUpdates = Table<bool>(getMaxBounds(), true);
+  Table<bool> renderUpdates = Table<bool>(getMaxBounds(), false);
+  vector<Vec2> renderUpdateList;
+  mutable unique_ptr<ViewIndexCache> viewIndexCache;
+  ViewIndexCache& getViewIndexCache() const;
+  mutable unique_ptr<MoraleInfluenceCache> moraleInfluenceCache;
+  MoraleInfluenceCache& getMoraleInfluenceCache() const;
   Table<bool> SERIAL(unavailable);
   unordered_map<StairKey, vector<Position>> SERIAL(landingSquares);
   set<Vec2> SERIAL(tickingSquares);
   set<Vec2> SERIAL(tickingFurniture);
+  HeapAllocated<DiffusionField> SERIAL(poisonGas);
+  void tickPoisonGas();
   void eraseCreature(Creature*, Vec2 coord);
   void placeCreature(Creature*, Vec2 pos);
   void unplaceCreature(Creature*, Vec2 pos);
@@ -232,3 +247,4 @@ class Level : public OwnedObject<Level> {
   void forEachEffect(Vec2, TribeId, Fun);
 };
 
+CEREAL_CLASS_VERSION(Level, 1);
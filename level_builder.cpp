@@ -18,7 +18,7 @@ LevelBuilder::LevelBuilder(ProgressMeter* meter, RandomGen& r, ContentFactory* c
   : squares(Rectangle(width, height)), unavailable(width, height, false),
     heightMap(width, height, 0), covered(width, height, allCovered), building(width, height, false),
     sunlight(width, height, defaultLight ? *defaultLight : (allCovered ? 0.0 : 1.0)),
-    attrib(width, height), items(width, height), furniture(Rectangle(width, height)),
+    attrib([&](SquareAttrib) { return BitTable(Rectangle(width, height)); }), items(width, height), furniture(Rectangle(width, height)),
     progressMeter(meter), random(r), contentFactory(contentFactory) {
 }
 
@@ -40,19 +40,51 @@ ContentFactory* LevelBuilder::getContentFactory() const {
 
 bool LevelBuilder::hasAttrib(Vec2 posT, SquareAttrib attr) {
   Vec2 pos = transform(posT);
-  return attrib[pos].contains(attr);
+  return attrib[attr].get(pos);
 }
 
-void LevelBuilder::addAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[transform(pos)].insert(attr);
+void LevelBuilder::addAttrib(Vec2 posT, SquareAttrib attr) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, attr, value = attrib[attr].get(pos)] { attrib[attr].set(pos, value); });
+  attrib[attr].set(pos, true);
+}
+
+void LevelBuilder::removeAttrib(Vec2 posT, SquareAttrib attr) {
+  Vec2 pos = transform(posT);
+  addUndo([this, pos, attr, value = attrib[attr].get(pos)] { attrib[attr].set(pos, value); });
+  attrib[attr].set(pos, false);
+}
+
+BitTable LevelBuilder::getMask(const BitTable& plane, Rectangle area) {
+  if (!isTransformed())
+    return plane.getShifted(area, Vec2(0, 0));
+  BitTable ret(area);
+  for (Vec2 v : area) {
+    Vec2 pos = transform(v);
+    if (pos.inRectangle(plane.getBounds()) && plane.get(pos))
+      ret.set(v, true);
+  }
+  return ret;
 }
 
-void LevelBuilder::removeAttrib(Vec2 pos, SquareAttrib attr) {
-  attrib[transform(pos)].erase(attr);
+BitTable LevelBuilder::getAttribMask(Rectangle area, SquareAttrib attr) {
+  return getMask(attrib[attr], area);
 }
 
-WSquare LevelBuilder::modSquare(Vec2 pos) {
-  return squares.getWritable(transform(pos));
+BitTable LevelBuilder::getFurnitureMask(Rectangle area, FurnitureType type) {
+  if (auto plane = getReferenceMaybe(furnitureTypes, type))
+    return getMask(*plane, area);
+  return BitTable(area);
+}
+
+void LevelBuilder::updateFurniturePlanes(Vec2 pos, FurnitureLayer layer, optional<FurnitureType> newType) {
+  if (auto f = furniture.getBuilt(layer).getReadonly(pos))
+    furnitureTypes.at(f->getType()).set(pos, false);
+  if (newType) {
+    if (!furnitureTypes.count(*newType))
+      furnitureTypes.insert(make_pair(*newType, BitTable(squares.getBounds())));
+    furnitureTypes.at(*newType).set(pos, true);
+  }
 }
 
 Rectangle LevelBuilder::toGlobalCoordinates(Rectangle area) {
@@ -64,12 +96,21 @@ vector<Vec2> LevelBuilder::toGlobalCoordinates(vector<Vec2> v) {
 }
 
 void LevelBuilder::addCollective(CollectiveBuilder* col) {
-  if (!collectives.contains(col))
+  if (!collectives.contains(col)) {
     collectives.push_back(col);
+    addUndo([this] { collectives.pop_back(); });
+  }
 }
 
-void LevelBuilder::setHeightMap(Vec2 pos, double h) {
-  heightMap[transform(pos)] = h;
+CollectiveBuilder* LevelBuilder::modCollective(CollectiveBuilder* col) {
+  addUndo([col, checkpoint = col->getCheckpoint()] { col->rollback(checkpoint); });
+  return col;
+}
+
+void LevelBuilder::setHeightMap(Vec2 posT, double h) {
+  Vec2 pos = transform(posT);
+  saveForUndo(heightMap, pos);
+  heightMap[pos] = h;
 }
 
 double LevelBuilder::getHeightMap(Vec2 pos) {
@@ -78,11 +119,13 @@ double LevelBuilder::getHeightMap(Vec2 pos) {
 
 void LevelBuilder::putCreature(Vec2 pos, PCreature creature) {
   creatures.emplace_back(std::move(creature), transform(pos));
+  addUndo([this] { creatures.pop_back(); });
 }
 
 void LevelBuilder::putItems(Vec2 posT, vector<PItem> it) {
   CHECK(canPutItems(posT));
   Vec2 pos = transform(posT);
+  addUndo([this, pos, size = items[pos].size()] { items[pos].resize(size); });
   append(items[pos], std::move(it));
 }
 
@@ -99,6 +142,8 @@ void LevelBuilder::putFurniture(Vec2 posT, FurnitureParams f, optional<SquareAtt
   auto layer = contentFactory->furniture.getData(f.type).getLayer();
   if (getFurniture(posT, layer))
     removeFurniture(posT, layer);
+  saveFurnitureForUndo(transform(posT), layer);
+  updateFurniturePlanes(transform(posT), layer, f.type);
   furniture.getBuilt(layer).putElem(transform(posT), f, [&](const FurnitureParams& t) {
     return contentFactory->furniture.getFurniture(t.type, t.tribe); });
   if (attrib)
@@ -131,9 +176,18 @@ bool LevelBuilder::canPutFurniture(Vec2 posT, FurnitureLayer layer) {
 
 void LevelBuilder::removeFurniture(Vec2 pos, FurnitureLayer layer) {
   CHECK(getFurnitureType(pos, layer) != FurnitureType("DOWN_STAIRS"));
+  saveFurnitureForUndo(transform(pos), layer);
+  updateFurniturePlanes(transform(pos), layer, none);
   furniture.getBuilt(layer).clearElem(transform(pos));
 }
 
+void LevelBuilder::saveFurnitureForUndo(Vec2 pos, FurnitureLayer layer) {
+  addUndo([this, pos, layer, state = furniture.getBuilt(layer).getElemState(pos)] {
+    updateFurniturePlanes(pos, layer, state.type ? optional<FurnitureType>(state.type->type) : none);
+    furniture.getBuilt(layer).setElemState(pos, state);
+  });
+}
+
 void LevelBuilder::removeAllFurniture(Vec2 pos) {
   for (auto layer : ENUM_ALL(FurnitureLayer))
     removeFurniture(pos, layer);
@@ -156,6 +210,9 @@ WConstFurniture LevelBuilder::getFurniture(Vec2 posT, FurnitureLayer layer) {
 
 void LevelBuilder::setLandingLink(Vec2 posT, StairKey key) {
   Vec2 pos = transform(posT);
+  addUndo([this, pos, link = squares.getReadonly(pos)->getLandingLink()] {
+    squares.getWritable(pos)->setLandingLink(link);
+  });
   squares.getWritable(pos)->setLandingLink(key);
 }
 
@@ -171,6 +228,7 @@ bool LevelBuilder::canPutCreature(Vec2 posT, Creature* c) {
 }
 
 void LevelBuilder::setNoDiagonalPassing() {
+  addUndo([this, value = noDiagonalPassing] { noDiagonalPassing = value; });
   noDiagonalPassing = true;
 }
 
@@ -194,10 +252,6 @@ PLevel LevelBuilder::build(WModel m, LevelMaker* maker, LevelId levelId) {
   return l;
 }
 
-static Vec2::LinearMap identity() {
-  return [](Vec2 v) { return v; };
-}
-
 static Vec2::LinearMap deg90(Rectangle bounds) {
   return [bounds](Vec2 v) {
     v -= bounds.topLeft();
@@ -220,7 +274,7 @@ static Vec2::LinearMap deg270(Rectangle bounds) {
 
 void LevelBuilder::pushMap(Rectangle bounds, Rot rot) {
   switch (rot) {
-    case CW0: mapStack.push_back(identity()); break;
+    case CW0: mapStack.push_back(none); break;
     case CW1: mapStack.push_back(deg90(bounds)); break;
     case CW2: mapStack.push_back(deg180(bounds)); break;
     case CW3: mapStack.push_back(deg270(bounds)); break;
@@ -232,26 +286,77 @@ void LevelBuilder::popMap() {
 }
 
 Vec2 LevelBuilder::transform(Vec2 v) {
-  for (auto m : mapStack.reverse()) {
-    v = m(v);
-  }
+  for (auto& m : mapStack.reverse())
+    if (m)
+      v = (*m)(v);
   return v;
 }
 
+bool LevelBuilder::isTransformed() const {
+  for (auto& m : mapStack)
+    if (m)
+      return true;
+  return false;
+}
+
 void LevelBuilder::setCovered(Vec2 posT, bool state) {
-  covered[transform(posT)] = state;
+  Vec2 pos = transform(posT);
+  saveForUndo(covered, pos);
+  covered[pos] = state;
 }
 
 void LevelBuilder::setBuilding(Vec2 posT, bool state) {
-  building[transform(posT)] = state;
+  Vec2 pos = transform(posT);
+  saveForUndo(building, pos);
+  building[pos] = state;
 }
 
 void LevelBuilder::setSunlight(Vec2 pos, double s) {
+  saveForUndo(sunlight, pos);
   sunlight[pos] = s;
 }
 
-void LevelBuilder::setUnavailable(Vec2 pos) {
-  unavailable[transform(pos)] = true;
+void LevelBuilder::setUnavailable(Vec2 posT) {
+  Vec2 pos = transform(posT);
+  saveForUndo(unavailable, pos);
+  unavailable[pos] = true;
+}
+
+static atomic<int> numLocalRetries(0);
+
+void LevelBuilder::pushCheckpoint() {
+  checkpoints.push_back(Checkpoint{undoLog.size(), mapStack.size()});
+}
+
+void LevelBuilder::popCheckpoint() {
+  checkpoints.pop_back();
+  if (checkpoints.empty())
+    undoLog.clear();
+}
+
+void LevelBuilder::rollback() {
+  auto checkpoint = checkpoints.back();
+  checkpoints.pop_back();
+  while (undoLog.size() > checkpoint.undoLogSize) {
+    undoLog.back()();
+    undoLog.pop_back();
+  }
+  // The failed maker may have thrown between pushMap and popMap.
+  mapStack.resize(checkpoint.mapStackSize);
+  if (checkpoints.empty())
+    undoLog.clear();
+}
+
+bool LevelBuilder::useLocalRetry() {
+  if (localRetriesLeft == 0)
+    return false;
+  --localRetriesLeft;
+  ++numLocalRetries;
+  return true;
+}
+
+int LevelBuilder::getNumLocalRetries() {
+  return numLocalRetries;
 }
 
 bool LevelBuilder::canNavigate(Vec2 posT, const MovementType& movement) {
@@ -5,6 +5,7 @@
 #include "square_array.h"
 #include "furniture_array.h"
 #include "view_object.h"
+#include "bit_table.h"
 
 class ProgressMeter;
 class Model;
@@ -50,9 +51,6 @@ class LevelBuilder {
   LevelBuilder(LevelBuilder&&);
   ~LevelBuilder();
 
-  /** Returns a given square.*/
-  WSquare modSquare(Vec2);
-
   /** Checks if it's possible to put a creature on given square.*/
   bool canPutCreature(Vec2, Creature*);
 
@@ -94,6 +92,12 @@ class LevelBuilder {
   /** Removes attribute from given square.*/
   void removeAttrib(Vec2 pos, SquareAttrib attr);
 
+  /** Returns which squares of the area have the attribute. Squares outside of the level don't have any.*/
+  BitTable getAttribMask(Rectangle area, SquareAttrib);
+
+  /** Returns which squares of the area have the furniture type.*/
+  BitTable getFurnitureMask(Rectangle area, FurnitureType);
+
   bool canNavigate(Vec2 pos, const MovementType&);
 
   /** Sets the height of the given square.*/
@@ -108,6 +112,9 @@ class LevelBuilder {
   /** Adds a collective to the level and initializes it.*/
   void addCollective(CollectiveBuilder*);
 
+  /** Returns the collective for modification. The changes are undone together with the level by rollback().*/
+  CollectiveBuilder* modCollective(CollectiveBuilder*);
+
   /** Sets the cover of the square. The value will remain if square is changed.*/
   void setCovered(Vec2, bool state);
 
@@ -128,9 +135,40 @@ class LevelBuilder {
 
   RandomGen& getRandom();
   ContentFactory* getContentFactory() const;
-  
+
+  /** Starts recording the changes, so that they can be undone by rollback(). Checkpoints can be nested.*/
+  void pushCheckpoint();
+  /** Keeps the changes made since the last pushCheckpoint().*/
+  void popCheckpoint();
+  /** Undoes the changes made since the last pushCheckpoint() and removes the checkpoint.*/
+  void rollback();
+  /** Uses up one of the retries of a failed LevelMaker that this builder allows. Returns false if none are left.*/
+  bool useLocalRetry();
+  /** Total number of local retries used by all builders.*/
+  static int getNumLocalRetries();
+
   private:
   Vec2 transform(Vec2);
+  bool isTransformed() const;
+  BitTable getMask(const BitTable& plane, Rectangle area);
+  void updateFurniturePlanes(Vec2 pos, FurnitureLayer, optional<FurnitureType> newType);
+  template <typename Fun>
+  void addUndo(Fun undo) {
+    if (!checkpoints.empty())
+      undoLog.push_back(std::move(undo));
+  }
+  template <typename T>
+  void saveForUndo(Table<T>& table, Vec2 pos) {
+    addUndo([&table, pos, value = table[pos]] { table[pos] = value; });
+  }
+  void saveFurnitureForUndo(Vec2 pos, FurnitureLayer);
+  struct Checkpoint {
+    int undoLogSize;
+    int mapStackSize;
+  };
+  vector<Checkpoint> checkpoints;
+  vector<function<void()>> undoLog;
+  int localRetriesLeft = 10;
   SquareArray squares;
   Table<bool> unavailable;
   Table<double> heightMap;
@@ -139,11 +177,13 @@ class LevelBuilder {
   Table<bool> covered;
   Table<bool> building;
   Table<double> sunlight;
-  Table<EnumSet<SquareAttrib>> attrib;
+  EnumMap<SquareAttrib, BitTable> attrib;
+  map<FurnitureType, BitTable> furnitureTypes;
   vector<pair<PCreature, Vec2>> creatures;
   Table<vector<PItem>> items;
   FurnitureArray furniture;
-  vector<Vec2::LinearMap> mapStack;
+  // Rotations by 0 degrees are stored as none, so that masks can be copied directly from the whole level bitplanes.
+  vector<optional<Vec2::LinearMap>> mapStack;
   ProgressMeter* progressMeter = nullptr;
   RandomGen& random;
   bool noDiagonalPassing = false;
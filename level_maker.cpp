@@ -53,59 +53,99 @@ void checkGen(bool b) {
     failGen();
 }
 
+// Retries a failed maker from the state the level was in before it ran, instead of failing the whole model.
+void makeWithRetries(LevelMaker* maker, LevelBuilder* builder, Rectangle area) {
+  while (true) {
+    builder->pushCheckpoint();
+    try {
+      maker->make(builder, area);
+      builder->popCheckpoint();
+      return;
+    } catch (LevelGenException) {
+      builder->rollback();
+      if (!builder->useLocalRetry())
+        throw;
+    }
+  }
+}
+
 class Predicate {
   public:
   bool apply(LevelBuilder* builder, Vec2 pos) const {
     return predFun(builder, pos);
   }
 
+  BitTable getMask(LevelBuilder* builder, Rectangle area) const {
+    return maskFun(builder, area);
+  }
+
   Vec2 getRandomPosition(LevelBuilder* builder, Rectangle area) {
-    vector<Vec2> good;
-    for (Vec2 v : area)
-      if (apply(builder, v))
-        good.push_back(v);
+    auto good = getMask(builder, area).getAllSet();
     if (good.empty())
       failGen();
     return builder->getRandom().choose(good);
   }
 
   static Predicate attrib(SquareAttrib attr) {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAttrib(pos, attr);});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return builder->hasAttrib(pos, attr);},
+        [=] (LevelBuilder* builder, Rectangle area) { return builder->getAttribMask(area, attr);});
   }
 
   Predicate operator !() const {
     PredFun self(predFun);
-    return Predicate([self] (LevelBuilder* builder, Vec2 pos) { return !self(builder, pos);});
+    MaskFun selfMask(maskFun);
+    return Predicate([self] (LevelBuilder* builder, Vec2 pos) { return !self(builder, pos);},
+        [selfMask] (LevelBuilder* builder, Rectangle area) {
+          auto ret = selfMask(builder, area);
+          ret.invert();
+          return ret;
+        });
   }
 
   Predicate operator && (const Predicate& p1) const {
     PredFun self(predFun);
+    MaskFun selfMask(maskFun);
     return Predicate([self, p1] (LevelBuilder* builder, Vec2 pos) {
-        return p1.apply(builder, pos) && self(builder, pos);});
+        return p1.apply(builder, pos) && self(builder, pos);},
+        [selfMask, p1] (LevelBuilder* builder, Rectangle area) {
+          auto ret = p1.getMask(builder, area);
+          ret &= selfMask(builder, area);
+          return ret;
+        });
   }
 
   Predicate operator || (const Predicate& p1) const {
     PredFun self(predFun);
+    MaskFun selfMask(maskFun);
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-        return p1.apply(builder, pos) || self(builder, pos);});
+        return p1.apply(builder, pos) || self(builder, pos);},
+        [=] (LevelBuilder* builder, Rectangle area) {
+          auto ret = p1.getMask(builder, area);
+          ret |= selfMask(builder, area);
+          return ret;
+        });
   }
 
   static Predicate type(FurnitureType t) {
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-      return builder->isFurnitureType(pos, t);});
+      return builder->isFurnitureType(pos, t);},
+      [=] (LevelBuilder* builder, Rectangle area) { return builder->getFurnitureMask(area, t);});
   }
 
   static Predicate inRectangle(Rectangle r) {
     return Predicate([=] (LevelBuilder* builder, Vec2 pos) {
-      return pos.inRectangle(r);});
+      return pos.inRectangle(r);},
+      [=] (LevelBuilder* builder, Rectangle area) { return BitTable(r, true).getShifted(area, Vec2(0, 0));});
   }
 
   static Predicate alwaysTrue() {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return true;});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return true;},
+        [=] (LevelBuilder* builder, Rectangle area) { return BitTable(area, true);});
   }
 
   static Predicate alwaysFalse() {
-    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return false;});
+    return Predicate([=] (LevelBuilder* builder, Vec2 pos) { return false;},
+        [=] (LevelBuilder* builder, Rectangle area) { return BitTable(area, false);});
   }
 
   static Predicate canEnter(MovementType m) {
@@ -119,6 +159,8 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt <= 0;
+    }, [=] (LevelBuilder* builder, Rectangle area) {
+      return BitTable::countAtLeast(getNeighborMasks(builder, area, type, Vec2::directions8()), count);
     });
   }
 
@@ -129,6 +171,8 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt <= 0;
+    }, [=] (LevelBuilder* builder, Rectangle area) {
+      return BitTable::countAtLeast(getNeighborMasks(builder, area, type, Vec2::directions4()), count);
     });
   }
 
@@ -139,13 +183,32 @@ class Predicate {
         if (builder->isFurnitureType(v, type))
           --cnt;
       return cnt == 0;
+    }, [=] (LevelBuilder* builder, Rectangle area) {
+      return BitTable::countEquals(getNeighborMasks(builder, area, type, Vec2::directions4()), count);
     });
   }
 
   private:
   typedef function<bool(LevelBuilder*, Vec2)> PredFun;
-  Predicate(PredFun fun) : predFun(fun) {}
+  // Evaluates the predicate on the whole area at once.
+  typedef function<BitTable(LevelBuilder*, Rectangle)> MaskFun;
+  Predicate(PredFun fun, MaskFun mask) : predFun(fun), maskFun(mask) {}
+  Predicate(PredFun fun) : predFun(fun), maskFun([fun] (LevelBuilder* builder, Rectangle area) {
+    BitTable ret(area);
+    for (Vec2 v : area)
+      if (fun(builder, v))
+        ret.set(v, true);
+    return ret;
+  }) {}
+
+  static vector<BitTable> getNeighborMasks(LevelBuilder* builder, Rectangle area, FurnitureType type,
+      const vector<Vec2>& directions) {
+    auto mask = builder->getFurnitureMask(area.minusMargin(-1), type);
+    return directions.transform([&](Vec2 dir) { return mask.getShifted(area, dir); });
+  }
+
   PredFun predFun;
+  MaskFun maskFun;
 };
 
 class SquareChange {
@@ -227,7 +290,7 @@ class SquareChange {
 
   static SquareChange addTerritory(CollectiveBuilder* collective) {
     return SquareChange([=](LevelBuilder* builder, Vec2 pos) {
-      collective->addArea(builder->toGlobalCoordinates(vector<Vec2>({pos})));
+      builder->modCollective(collective)->addArea(builder->toGlobalCoordinates(vector<Vec2>({pos})));
     });
   }
 
@@ -261,7 +324,7 @@ class RoomMaker : public LevelMaker {
             int _minSize, int _maxSize, 
             SquareChange wall = SquareChange::none(),
             optional<FurnitureType> _onType = none,
-            PLevelMaker _roomContents = unique<Empty>(FurnitureType("FLOOR")),
+            PLevelMaker _roomContents = unique<Empty>(CONTENT_ID(FurnitureType, "FLOOR")),
             vector<PLevelMaker> _insideMakers = {},
             bool _diggableCorners = false) : 
       numRooms(_numRooms),
@@ -294,13 +357,13 @@ class RoomMaker : public LevelMaker {
           }
       } while (!good && --cnt > 0);
       if (cnt == 0) {
-        INFO << "Placed only " << i << " rooms out of " << numRooms;
+        INFO_IN(LEVEL_GEN) << "Placed only " << i << " rooms out of " << numRooms;
         break;
       }
       for (Vec2 v : Rectangle(k))
         taken[v + p] = 1;
       for (Vec2 v : Rectangle(k - Vec2(2, 2)))
-        builder->resetFurniture(p + v + Vec2(1, 1), FurnitureType("FLOOR"), SquareAttrib::ROOM);
+        builder->resetFurniture(p + v + Vec2(1, 1), CONTENT_ID(FurnitureType, "FLOOR"), SquareAttrib::ROOM);
       for (int i : Range(p.x, p.x + k.x)) {
         wallChange.apply(builder, Vec2(i, p.y));
         wallChange.apply(builder, Vec2(i, p.y + k.y - 1));
@@ -387,7 +450,7 @@ class Connector : public LevelMaker {
         }
         if (!builder->canNavigate(v, {MovementTrait::WALK}))
           if (builder->getFurniture(v, FurnitureLayer::GROUND)->canBuildBridgeOver())
-            builder->putFurniture(v, FurnitureType("BRIDGE"));
+            builder->putFurniture(v, CONTENT_ID(FurnitureType, "BRIDGE"));
         CHECK(builder->canNavigate(v, {MovementTrait::WALK}));
       }
       if (!path.isReachable(v))
@@ -397,7 +460,7 @@ class Connector : public LevelMaker {
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     Vec2 p1, p2;
-    vector<Vec2> points = area.getAllSquares().filter([&] (Vec2 v) { return connectPred.apply(builder, v);});
+    vector<Vec2> points = connectPred.getMask(builder, area).getAllSet();
     if (points.size() < 2)
       return;
     for (int i : Range(30)) {
@@ -490,7 +553,7 @@ class Inhabitants : public LevelMaker {
       checkGen(!positions.empty());
       auto pos = builder->getRandom().choose(positions);
       if (collective) {
-        collective->addCreature(creature.get(), minion.second);
+        builder->modCollective(collective)->addCreature(creature.get(), minion.second);
         builder->addCollective(collective);
       }
       builder->putCreature(pos, std::move(creature));
@@ -652,7 +715,7 @@ class River : public LevelMaker {
   private:
 
   vector<Vec2> straightLine(int x0, int y0, int x1, int y1){
-    INFO << "Line " << x1 << " " << y0 << " " << x1 << " " << y1;
+    INFO_IN(LEVEL_GEN) << "Line " << x1 << " " << y0 << " " << x1 << " " << y1;
     int dx = x1 - x0;
     int dy = y1 - y0;
     vector<Vec2> ret{ Vec2(x0, y0)};
@@ -759,7 +822,7 @@ class MountainRiver : public LevelMaker {
     if (builder->hasAttrib(pos, SquareAttrib::MOUNTAIN))
       return builder->getContentFactory()->furniture.getWaterType(100);
     else if (numLayer == 0)
-      return FurnitureType("SAND");
+      return CONTENT_ID(FurnitureType, "SAND");
     else
       return builder->getContentFactory()->furniture.getWaterType(1.1 * (numLayer - 1));
   }
@@ -908,61 +971,61 @@ static BuildingType getBuildingInfo(const SettlementInfo& info) {
   switch (info.buildingId) {
     case BuildingId::WOOD:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("WOOD_WALL");
-          c.floorInside = FurnitureType("FLOOR");
-          c.door = Connector::DoorInfo LIST(FurnitureType("WOOD_DOOR"), info.tribe, 1.0);
-          c.gate = Connector::DoorInfo LIST(FurnitureType("WOOD_GATE"), info.tribe, 1.0);
+          c.wall = CONTENT_ID(FurnitureType, "WOOD_WALL");
+          c.floorInside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.door = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_DOOR"), info.tribe, 1.0);
+          c.gate = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_GATE"), info.tribe, 1.0);
       );
     case BuildingId::WOOD_CASTLE:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("WOOD_WALL");
-          c.floorInside = FurnitureType("FLOOR");
-          c.floorOutside = FurnitureType("MUD");
-          c.door = Connector::DoorInfo LIST(FurnitureType("WOOD_DOOR"), info.tribe, 1.0);
-          c.gate = Connector::DoorInfo LIST(FurnitureType("WOOD_GATE"), info.tribe, 1.0);
+          c.wall = CONTENT_ID(FurnitureType, "WOOD_WALL");
+          c.floorInside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.floorOutside = CONTENT_ID(FurnitureType, "MUD");
+          c.door = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_DOOR"), info.tribe, 1.0);
+          c.gate = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_GATE"), info.tribe, 1.0);
       );
     case BuildingId::MUD: 
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("MUD_WALL");
-          c.floorInside = FurnitureType("MUD");
-          //c.floorOutside = FurnitureType("MUD");
+          c.wall = CONTENT_ID(FurnitureType, "MUD_WALL");
+          c.floorInside = CONTENT_ID(FurnitureType, "MUD");
+          //c.floorOutside = CONTENT_ID(FurnitureType, "MUD");
       );
     case BuildingId::BRICK:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("CASTLE_WALL");
-          c.floorInside = FurnitureType("FLOOR");
-          c.floorOutside = FurnitureType("MUD");
-          c.prettyFloor = FurnitureType("FLOOR_CARPET1");
-          c.door = Connector::DoorInfo LIST(FurnitureType("IRON_DOOR"), info.tribe, 1.0);
-          c.gate = Connector::DoorInfo LIST(FurnitureType("IRON_GATE"), info.tribe, 1.0);
+          c.wall = CONTENT_ID(FurnitureType, "CASTLE_WALL");
+          c.floorInside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.floorOutside = CONTENT_ID(FurnitureType, "MUD");
+          c.prettyFloor = CONTENT_ID(FurnitureType, "FLOOR_CARPET1");
+          c.door = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "IRON_DOOR"), info.tribe, 1.0);
+          c.gate = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "IRON_GATE"), info.tribe, 1.0);
       );
     case BuildingId::DUNGEON:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("MOUNTAIN");
-          c.floorInside = FurnitureType("FLOOR");
-          c.floorOutside = FurnitureType("FLOOR");
-          c.door = Connector::DoorInfo LIST(FurnitureType("WOOD_DOOR"), info.tribe, 1.0);
-          c.gate = Connector::DoorInfo LIST(FurnitureType("WOOD_GATE"), info.tribe, 1.0);
+          c.wall = CONTENT_ID(FurnitureType, "MOUNTAIN");
+          c.floorInside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.floorOutside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.door = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_DOOR"), info.tribe, 1.0);
+          c.gate = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_GATE"), info.tribe, 1.0);
       );
     case BuildingId::DUNGEON_SURFACE:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("MOUNTAIN");
-          c.floorInside = FurnitureType("FLOOR");
-          c.floorOutside = FurnitureType("HILL");
-          c.door = Connector::DoorInfo LIST(FurnitureType("WOOD_DOOR"), info.tribe, 1.0);
-          c.gate = Connector::DoorInfo LIST(FurnitureType("WOOD_GATE"), info.tribe, 1.0);
+          c.wall = CONTENT_ID(FurnitureType, "MOUNTAIN");
+          c.floorInside = CONTENT_ID(FurnitureType, "FLOOR");
+          c.floorOutside = CONTENT_ID(FurnitureType, "HILL");
+          c.door = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_DOOR"), info.tribe, 1.0);
+          c.gate = Connector::DoorInfo LIST(CONTENT_ID(FurnitureType, "WOOD_GATE"), info.tribe, 1.0);
       );
     case BuildingId::RUINS:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("RUIN_WALL");
+          c.wall = CONTENT_ID(FurnitureType, "RUIN_WALL");
       );
     case BuildingId::SNOW:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("SNOW_WALL");
+          c.wall = CONTENT_ID(FurnitureType, "SNOW_WALL");
       );
     case BuildingId::GLACIER:
       return CONSTRUCT(BuildingType,
-          c.wall = FurnitureType("GLACIER");
+          c.wall = CONTENT_ID(FurnitureType, "GLACIER");
           c.water = {WaterType::ICE};
       );
   }
@@ -1081,7 +1144,7 @@ class Buildings : public LevelMaker {
     if (roadConnection) {
       Vec2 pos = Vec2((area.left() + area.right()) / 2, area.top() + alignHeight);
       builder->removeFurniture(pos, FurnitureLayer::MIDDLE);
-      builder->putFurniture(pos, FurnitureParams{FurnitureType("ROAD"), TribeId::getMonster()});
+      builder->putFurniture(pos, FurnitureParams{CONTENT_ID(FurnitureType, "ROAD"), TribeId::getMonster()});
       builder->addAttrib(pos, SquareAttrib::CONNECT_ROAD);
     }
   }
@@ -1113,7 +1176,7 @@ class MakerQueue : public LevelMaker {
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     for (auto& maker : makers)
-      maker->make(builder, area);
+      makeWithRetries(maker.get(), builder, area);
   }
 
   private:
@@ -1124,6 +1187,7 @@ class PredicatePrecalc {
   public:
   PredicatePrecalc(const Predicate& predicate, LevelBuilder* builder, Rectangle area)
       : counts(Rectangle(area.topLeft(), area.bottomRight() + Vec2(1, 1))) {
+    auto mask = predicate.getMask(builder, area);
     int px = counts.getBounds().left();
     int py = counts.getBounds().top();
     for (int x : Range(px, counts.getBounds().right()))
@@ -1131,7 +1195,7 @@ class PredicatePrecalc {
     for (int y : Range(py, counts.getBounds().bottom()))
       counts[px][y] = 0;
     for (Vec2 v : Rectangle(area.topLeft() + Vec2(1, 1), counts.getBounds().bottomRight()))
-      counts[v] = (predicate.apply(builder, v - Vec2(1, 1)) ? 1 : 0) +
+      counts[v] = (mask.get(v - Vec2(1, 1)) ? 1 : 0) +
         counts[v.x - 1][v.y] + counts[v.x][v.y - 1] -counts[v.x - 1][v.y - 1];
   }
 
@@ -1323,7 +1387,7 @@ class RandomLocations : public LevelMaker {
     for (int i : All(insideMakers)) {
       PROFILE_BLOCK("insider makers");
       builder->pushMap(makerBounds[i], rotations[i]);
-      insideMakers[i]->make(builder, makerBounds[i]);
+      makeWithRetries(insideMakers[i].get(), builder, makerBounds[i]);
       builder->popMap();
     }
     return true;
@@ -1545,7 +1609,7 @@ class Mountains : public LevelMaker {
       builder->setHeightMap(v, wys[v]);
       if (wys[v] >= cutOffHill) {
         isMountain[v] = true;
-        builder->putFurniture(v, FurnitureType("FLOOR"));
+        builder->putFurniture(v, CONTENT_ID(FurnitureType, "FLOOR"));
         builder->putFurniture(v, {mountainType, tribe}, SquareAttrib::MOUNTAIN);
         builder->setSunlight(v, max(0.0, 1. - (wys[v] - cutOffHill) / (cutOffDarkness - cutOffHill)));
         builder->setCovered(v, true);
@@ -1564,8 +1628,8 @@ class Mountains : public LevelMaker {
     removeEdge(isMountain, 20);
     for (auto v : area)
       if (isMountain[v])
-        builder->putFurniture(v, {FurnitureType("MOUNTAIN2"), tribe}, SquareAttrib::MOUNTAIN);
-    INFO << "Terrain distribution " << dCnt << " darkness, " << mCnt << " mountain, " << hCnt << " hill, " << lCnt << " lowland";
+        builder->putFurniture(v, {CONTENT_ID(FurnitureType, "MOUNTAIN2"), tribe}, SquareAttrib::MOUNTAIN);
+    INFO_IN(LEVEL_GEN) << "Terrain distribution " << dCnt << " darkness, " << mCnt << " mountain, " << hCnt << " hill, " << lCnt << " lowland";
   }
 
   private:
@@ -1594,16 +1658,16 @@ class Roads : public LevelMaker {
       return ShortestPath::infinity;
     if (makeBridge(builder, pos))
       return 10;
-    if (builder->isFurnitureType(pos, FurnitureType("ROAD")) || builder->isFurnitureType(pos, FurnitureType("BRIDGE")))
+    if (builder->isFurnitureType(pos, CONTENT_ID(FurnitureType, "ROAD")) || builder->isFurnitureType(pos, CONTENT_ID(FurnitureType, "BRIDGE")))
       return 1;
     return 1 + pow(1 + builder->getHeightMap(pos), 2);
   }
 
   FurnitureType getRoadType(LevelBuilder* builder, Vec2 pos) {
     if (makeBridge(builder, pos))
-      return FurnitureType("BRIDGE");
+      return CONTENT_ID(FurnitureType, "BRIDGE");
     else
-      return FurnitureType("ROAD");
+      return CONTENT_ID(FurnitureType, "ROAD");
   }
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
@@ -1611,7 +1675,7 @@ class Roads : public LevelMaker {
     for (Vec2 v : area)
       if (builder->hasAttrib(v, SquareAttrib::CONNECT_ROAD)) {
         points.push_back(v);
-        INFO << "Connecting point " << v;
+        INFO_IN(LEVEL_GEN) << "Connecting point " << v;
       }
     for (int ind : Range(1, points.size())) {
       Vec2 p1 = points[ind];
@@ -1639,7 +1703,7 @@ class StartingPos : public LevelMaker {
   virtual void make(LevelBuilder* builder, Rectangle area) override {
     for (Vec2 pos : area)
       if (predicate.apply(builder, pos))
-        builder->modSquare(pos)->setLandingLink(stairKey);
+        builder->setLandingLink(pos, stairKey);
   }
 
   private:
@@ -1658,7 +1722,7 @@ class TransferPos : public LevelMaker {
       if (((pos.x - area.left() < width) || (pos.y - area.top() < width) ||
           (area.right() - pos.x <= width) || (area.bottom() - pos.y <= width)) &&
           predicate.apply(builder, pos)) {
-        builder->modSquare(pos)->setLandingLink(stairKey);
+        builder->setLandingLink(pos, stairKey);
         found = true;
       }
     checkGen(found);
@@ -1702,6 +1766,7 @@ class PlaceCollective : public LevelMaker {
       : collective(NOTNULL(c)), predicate(pred) {}
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
+    builder->modCollective(collective);
     if (!collective->hasCentralPoint())
       collective->setCentralPoint(builder->toGlobalCoordinates(area).middle());
     collective->addArea(builder->toGlobalCoordinates(area.getAllSquares()
@@ -1752,7 +1817,7 @@ class Stairs : public LevelMaker {
     : direction(dir), key(k), onPredicate(onPred), setAttr(_setAttr) {}
 
   virtual void make(LevelBuilder* builder, Rectangle area) override {
-    auto type = direction == StairDirection::DOWN ? FurnitureType("DOWN_STAIRS") : FurnitureType("UP_STAIRS");
+    auto type = direction == StairDirection::DOWN ? CONTENT_ID(FurnitureType, "DOWN_STAIRS") : CONTENT_ID(FurnitureType, "UP_STAIRS");
     vector<Vec2> allPos;
     for (Vec2 v : area)
       if (onPredicate.apply(builder, v) && builder->canPutFurniture(v, builder->getContentFactory()->furniture.getData(type).getLayer()))
@@ -1790,7 +1855,7 @@ class ShopMaker : public LevelMaker {
       builder->putItems(shopkeeperPos, shopkeeper->getEquipment().removeAllItems(shopkeeper.get()));
       builder->putItems(shopkeeperPos, shopkeeper->generateCorpse(builder->getContentFactory(), true));
     }
-    builder->putFurniture(pos[builder->getRandom().get(pos.size())], FurnitureParams{FurnitureType("GROUND_TORCH"), tribe});
+    builder->putFurniture(pos[builder->getRandom().get(pos.size())], FurnitureParams{CONTENT_ID(FurnitureType, "GROUND_TORCH"), tribe});
     auto itemList = builder->getContentFactory()->itemFactory.get(shopItems);
     for (int i : Range(numItems)) {
       Vec2 v = pos[builder->getRandom().get(pos.size())];
@@ -2031,19 +2096,19 @@ static PMakerQueue stockpileMaker(StockpileInfo info) {
 PLevelMaker LevelMaker::mazeLevel(RandomGen& random, SettlementInfo info) {
   auto queue = unique<MakerQueue>();
   BuildingType building = getBuildingInfo(info);
-  queue->addMaker(unique<Empty>(SquareChange(FurnitureType("FLOOR"), FurnitureType("MOUNTAIN"))));
+  queue->addMaker(unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), CONTENT_ID(FurnitureType, "MOUNTAIN"))));
   queue->addMaker(unique<PlaceCollective>(info.collective));
   queue->addMaker(unique<RoomMaker>(random.get(8, 15), 3, 5));
   queue->addMaker(unique<Connector>(building.door));
   for (auto& furniture : info.furniture)
     queue->addMaker(unique<Furnitures>(Predicate::attrib(SquareAttrib::EMPTY_ROOM), 0.3, furniture, info.tribe));
   for (StairKey key : info.downStairs)
-    queue->addMaker(unique<Stairs>(StairDirection::DOWN, key, Predicate::type(FurnitureType("FLOOR"))));
+    queue->addMaker(unique<Stairs>(StairDirection::DOWN, key, Predicate::type(CONTENT_ID(FurnitureType, "FLOOR"))));
   for (StairKey key : info.upStairs)
-    queue->addMaker(unique<Stairs>(StairDirection::UP, key, Predicate::type(FurnitureType("FLOOR"))));
+    queue->addMaker(unique<Stairs>(StairDirection::UP, key, Predicate::type(CONTENT_ID(FurnitureType, "FLOOR"))));
   queue->addMaker(unique<Inhabitants>(info.inhabitants, info.collective));
   queue->addMaker(unique<Items>(ItemListId("dungeon"), 5, 10));
-  return unique<BorderGuard>(std::move(queue), SquareChange(FurnitureType("FLOOR"), FurnitureType("MOUNTAIN")));
+  return unique<BorderGuard>(std::move(queue), SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), CONTENT_ID(FurnitureType, "MOUNTAIN")));
 }
 
 static PMakerQueue getElderRoom(SettlementInfo info) {
@@ -2137,7 +2202,7 @@ static PMakerQueue temple(RandomGen& random, SettlementInfo info) {
       Predicate::near4AtLeast(building.wall, 1),
       Predicate::near4Equals(building.wall, 1)
   );
-  //room->addMaker(unique<Furnitures>(torchPred, 1.0, FurnitureFactory(info.tribe, {{FurnitureType("GROUND_TORCH"), 1}})));
+  //room->addMaker(unique<Furnitures>(torchPred, 1.0, FurnitureFactory(info.tribe, {{CONTENT_ID(FurnitureType, "GROUND_TORCH"), 1}})));
   if (info.outsideFeatures)
     room->addMaker(unique<Furnitures>(!Predicate::attrib(SquareAttrib::ROOM), 0.1, *info.outsideFeatures, info.tribe));
   if (building.prettyFloor)
@@ -2237,7 +2302,7 @@ static PMakerQueue castle2(RandomGen& random, SettlementInfo info) {
 static PMakerQueue tower(RandomGen& random, SettlementInfo info, bool withExit) {
   BuildingType building = getBuildingInfo(info);
   auto queue = unique<MakerQueue>();
-  queue->addMaker(unique<Empty>(SquareChange(FurnitureType("FLOOR"), building.wall)));
+  queue->addMaker(unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), building.wall)));
   if (withExit) {
     if (building.door)
       queue->addMaker(unique<LevelExit>(SquareChange(FurnitureParams{building.door->type, building.door->tribe}), 2));
@@ -2436,17 +2501,17 @@ static PMakerQueue islandVaultMaker(RandomGen& random, SettlementInfo info, bool
       unique<Margin>(1, std::move(inside))
       );
   if (door)
-    buildingMaker->addMaker(unique<LevelExit>(FurnitureType("WOOD_DOOR")));
+    buildingMaker->addMaker(unique<LevelExit>(CONTENT_ID(FurnitureType, "WOOD_DOOR")));
   return unique<MakerQueue>(
-        unique<Empty>(SquareChange::reset(FurnitureType("WATER"))),
+        unique<Empty>(SquareChange::reset(CONTENT_ID(FurnitureType, "WATER"))),
         unique<Margin>(1, std::move(buildingMaker)));
 }
 
 PLevelMaker LevelMaker::mineTownLevel(RandomGen& random, SettlementInfo info) {
   auto queue = unique<MakerQueue>();
-  queue->addMaker(unique<Empty>(SquareChange(FurnitureType("FLOOR"), FurnitureType("MOUNTAIN"))));
+  queue->addMaker(unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), CONTENT_ID(FurnitureType, "MOUNTAIN"))));
   queue->addMaker(mineTownMaker(random, info));
-  return unique<BorderGuard>(std::move(queue), SquareChange(FurnitureType("FLOOR"), FurnitureType("MOUNTAIN")));
+  return unique<BorderGuard>(std::move(queue), SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), CONTENT_ID(FurnitureType, "MOUNTAIN")));
 }
 
 static PMakerQueue cemetery(SettlementInfo info) {
@@ -2456,7 +2521,7 @@ static PMakerQueue cemetery(SettlementInfo info) {
           unique<Margin>(1, unique<Buildings>(1, 2, 2, 3, building, false, nullptr, false))
   );
   for (auto& furniture : info.furniture)
-    queue->addMaker(unique<Furnitures>(Predicate::type(FurnitureType("GRASS")), 0.15, furniture, info.tribe));
+    queue->addMaker(unique<Furnitures>(Predicate::type(CONTENT_ID(FurnitureType, "GRASS")), 0.15, furniture, info.tribe));
   for (StairKey key : info.downStairs)
     queue->addMaker(unique<Stairs>(StairDirection::DOWN, key, Predicate::attrib(SquareAttrib::ROOM)));
   queue->addMaker(unique<Inhabitants>(info.inhabitants, info.collective));
@@ -2480,7 +2545,7 @@ static PMakerQueue swamp(SettlementInfo info) {
 
 static PMakerQueue mountainLake(SettlementInfo info) {
   auto queue = unique<MakerQueue>(
-      unique<UniformBlob>(SquareChange::reset(FurnitureType("WATER"), SquareAttrib::LAKE), none),
+      unique<UniformBlob>(SquareChange::reset(CONTENT_ID(FurnitureType, "WATER"), SquareAttrib::LAKE), none),
       unique<PlaceCollective>(info.collective)
   );
   queue->addMaker(unique<Inhabitants>(info.inhabitants, info.collective));
@@ -2490,14 +2555,14 @@ static PMakerQueue mountainLake(SettlementInfo info) {
 static PLevelMaker getMountains(BiomeId id, TribeId tribe) {
   switch (id) {
     case BiomeId::SNOW:
-      return unique<Mountains>(0.45, 0.02, NoiseInit{0, 1, 0, 0, 0}, tribe, FurnitureType("SNOW"), FurnitureType("SNOW"), FurnitureType("GLACIER"));
+      return unique<Mountains>(0.45, 0.02, NoiseInit{0, 1, 0, 0, 0}, tribe, CONTENT_ID(FurnitureType, "SNOW"), CONTENT_ID(FurnitureType, "SNOW"), CONTENT_ID(FurnitureType, "GLACIER"));
     case BiomeId::DESERT:
-      return unique<Mountains>(0.45, 0.02, NoiseInit{0, 1, 0, 0, 0}, tribe, FurnitureType("SAND"), FurnitureType("SAND"), FurnitureType("MOUNTAIN_SAND"));
+      return unique<Mountains>(0.45, 0.02, NoiseInit{0, 1, 0, 0, 0}, tribe, CONTENT_ID(FurnitureType, "SAND"), CONTENT_ID(FurnitureType, "SAND"), CONTENT_ID(FurnitureType, "MOUNTAIN_SAND"));
     case BiomeId::GRASSLAND:
     case BiomeId::FORREST:
-      return unique<Mountains>(0.45, 0.06, NoiseInit{0, 1, 0, 0, 0}, tribe, FurnitureType("HILL"), FurnitureType("GRASS"), FurnitureType("MOUNTAIN"));
+      return unique<Mountains>(0.45, 0.06, NoiseInit{0, 1, 0, 0, 0}, tribe, CONTENT_ID(FurnitureType, "HILL"), CONTENT_ID(FurnitureType, "GRASS"), CONTENT_ID(FurnitureType, "MOUNTAIN"));
     case BiomeId::MOUNTAIN:
-      return unique<Mountains>(0.25, 0.1, NoiseInit{0, 1, 0, 0, 0}, tribe, FurnitureType("HILL"), FurnitureType("GRASS"), FurnitureType("MOUNTAIN"));
+      return unique<Mountains>(0.25, 0.1, NoiseInit{0, 1, 0, 0, 0}, tribe, CONTENT_ID(FurnitureType, "HILL"), CONTENT_ID(FurnitureType, "GRASS"), CONTENT_ID(FurnitureType, "MOUNTAIN"));
   }
 }
 
@@ -2505,19 +2570,19 @@ static PLevelMaker getForrest(BiomeId id) {
   switch (id) {
     case BiomeId::MOUNTAIN:
       return unique<MakerQueue>(
-          unique<Forrest>(0.2, 0.5, Predicate::type(FurnitureType("GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
-          unique<Forrest>(0.8, 0.5, Predicate::type(FurnitureType("HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
+          unique<Forrest>(0.2, 0.5, Predicate::type(CONTENT_ID(FurnitureType, "GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
+          unique<Forrest>(0.8, 0.5, Predicate::type(CONTENT_ID(FurnitureType, "HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
     case BiomeId::GRASSLAND:
       return unique<MakerQueue>(
-          unique<Forrest>(0.3, 0.25, Predicate::type(FurnitureType("GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
-          unique<Forrest>(0.8, 0.25, Predicate::type(FurnitureType("HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
+          unique<Forrest>(0.3, 0.25, Predicate::type(CONTENT_ID(FurnitureType, "GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
+          unique<Forrest>(0.8, 0.25, Predicate::type(CONTENT_ID(FurnitureType, "HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
     case BiomeId::FORREST:
       return unique<MakerQueue>(
-          unique<Forrest>(0.8, 0.5, Predicate::type(FurnitureType("GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
-          unique<Forrest>(0.8, 0.5, Predicate::type(FurnitureType("HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
+          unique<Forrest>(0.8, 0.5, Predicate::type(CONTENT_ID(FurnitureType, "GRASS")), FurnitureListId("vegetationLow"), TribeId::getHostile()),
+          unique<Forrest>(0.8, 0.5, Predicate::type(CONTENT_ID(FurnitureType, "HILL")), FurnitureListId("vegetationHigh"), TribeId::getHostile()));
     case BiomeId::DESERT:
       return unique<MakerQueue>(
-          unique<Forrest>(0.8, 0.015, Predicate::type(FurnitureType("SAND")), FurnitureListId("vegetationDesert"), TribeId::getHostile())
+          unique<Forrest>(0.8, 0.015, Predicate::type(CONTENT_ID(FurnitureType, "SAND")), FurnitureListId("vegetationDesert"), TribeId::getHostile())
       );
     case BiomeId::SNOW:
       return unique<MakerQueue>(
@@ -2562,7 +2627,7 @@ static void generateResources(RandomGen& random, ResourceCounts resourceCounts,
         change.add(SquareChange::addTerritory(collective));
       auto queue = unique<MakerQueue>(unique<FurnitureBlob>(std::move(change)));
       locations->add(std::move(queue), {random.get(size), random.get(size)},
-          Predicate::type(FurnitureType("MOUNTAIN2")));
+          Predicate::type(CONTENT_ID(FurnitureType, "MOUNTAIN2")));
       locations->setMaxDistanceLast(center, maxDist);
     }
   };
@@ -2682,7 +2747,7 @@ PLevelMaker LevelMaker::topLevel(RandomGen& random, optional<CreatureGroup> forr
     for (int i : Range(random.get(1, 3))) {
       locations->add(unique<MakerQueue>(
             unique<RemoveFurniture>(FurnitureLayer::MIDDLE),
-            unique<FurnitureBlob>(SquareChange(FurnitureParams{FurnitureType("CROPS"), cottage.tribe})),
+            unique<FurnitureBlob>(SquareChange(FurnitureParams{CONTENT_ID(FurnitureType, "CROPS"), cottage.tribe})),
             unique<PlaceCollective>(cottage.collective)),
           {random.get(7, 12), random.get(7, 12)},
           lowlandPred);
@@ -2693,15 +2758,15 @@ PLevelMaker LevelMaker::topLevel(RandomGen& random, optional<CreatureGroup> forr
       locations->add(unique<Lake>(none), {random.get(20, 30), random.get(20, 30)}, Predicate::attrib(SquareAttrib::LOWLAND));
   if (biomeId == BiomeId::DESERT)
     for (int i : Range(random.get(1, 3)))
-      locations->add(unique<Lake>(FurnitureType("GRASS")), {random.get(7, 12), random.get(7, 12)}, Predicate::attrib(SquareAttrib::LOWLAND));
+      locations->add(unique<Lake>(CONTENT_ID(FurnitureType, "GRASS")), {random.get(7, 12), random.get(7, 12)}, Predicate::attrib(SquareAttrib::LOWLAND));
   if (biomeId == BiomeId::MOUNTAIN)
     for (int i : Range(random.get(3, 6))) {
-      locations->add(unique<UniformBlob>(SquareChange::reset(FurnitureType("WATER"), SquareAttrib::LAKE), none),
+      locations->add(unique<UniformBlob>(SquareChange::reset(CONTENT_ID(FurnitureType, "WATER"), SquareAttrib::LAKE), none),
           {random.get(10, 30), random.get(10, 30)}, Predicate::attrib(SquareAttrib::MOUNTAIN));
     //  locations->setMaxDistanceLast(startingPos, i == 0 ? 25 : 60);
   }
 /*  for (int i : Range(random.get(3, 5))) {
-    locations->add(unique<UniformBlob>(FurnitureType("FLOOR"), none),
+    locations->add(unique<UniformBlob>(CONTENT_ID(FurnitureType, "FLOOR"), none),
         {random.get(5, 12), random.get(5, 12)}, Predicate::type(SquareId::MOUNTAIN));
  //   locations->setMaxDistanceLast(startingPos, i == 0 ? 25 : 40);
   }*/
@@ -2709,11 +2774,11 @@ PLevelMaker LevelMaker::topLevel(RandomGen& random, optional<CreatureGroup> forr
     generateResources(random, resourceCounts, startingPos, locations.get(), surroundWithResources, mapWidth, *keeperTribe);
   }
   int mapBorder = 2;
-  queue->addMaker(unique<Empty>(FurnitureType("WATER")));
+  queue->addMaker(unique<Empty>(CONTENT_ID(FurnitureType, "WATER")));
   queue->addMaker(getMountains(biomeId, keeperTribe.value_or(TribeId::getHostile())));
   optional<FurnitureType> waterType;
   if (biomeId == BiomeId::SNOW)
-    waterType = FurnitureType("ICE");
+    waterType = CONTENT_ID(FurnitureType, "ICE");
   if (biomeId != BiomeId::DESERT)
     queue->addMaker(unique<MountainRiver>(1, Predicate::attrib(SquareAttrib::MOUNTAIN), waterType));
   queue->addMaker(unique<AddAttrib>(SquareAttrib::CONNECT_CORRIDOR, Predicate::attrib(SquareAttrib::LOWLAND)));
@@ -2723,7 +2788,7 @@ PLevelMaker LevelMaker::topLevel(RandomGen& random, optional<CreatureGroup> forr
   queue->addMaker(unique<Margin>(mapBorder, unique<Roads>()));
   queue->addMaker(unique<Margin>(mapBorder,
         unique<TransferPos>(Predicate::canEnter(MovementTrait::WALK), StairKey::transferLanding(), 2)));
-  queue->addMaker(unique<Margin>(mapBorder, unique<DestroyRandomly>(FurnitureType("RUIN_WALL"), 0.3)));
+  queue->addMaker(unique<Margin>(mapBorder, unique<DestroyRandomly>(CONTENT_ID(FurnitureType, "RUIN_WALL"), 0.3)));
   queue->addMaker(unique<Margin>(mapBorder, unique<Connector>(none, 5,
           Predicate::canEnter({MovementTrait::WALK}) &&
           Predicate::attrib(SquareAttrib::CONNECT_CORRIDOR),
@@ -2741,11 +2806,11 @@ static PLevelMaker underground(RandomGen& random, vector<WaterType> waterTypes =
   auto water = [&] {
     switch (waterType) {
       case WaterType::ICE:
-        return FurnitureType("ICE");
+        return CONTENT_ID(FurnitureType, "ICE");
       case WaterType::WATER:
-        return FurnitureType("WATER");
+        return CONTENT_ID(FurnitureType, "WATER");
       case WaterType::LAVA:
-        return FurnitureType("LAVA");
+        return CONTENT_ID(FurnitureType, "MAGMA");
     }
   }();
   auto creatureGroup = [&] {
@@ -2765,7 +2830,7 @@ static PLevelMaker underground(RandomGen& random, vector<WaterType> waterTypes =
     int maxSize = minSize + random.get(3, 10);
     for (int i : Range(sqrt(random.get(4, 100)))) {
       int size = random.get(minSize, maxSize);
-      caverns->add(unique<UniformBlob>(SquareChange::reset(FurnitureType("FLOOR"))), Vec2(size, size), Predicate::alwaysTrue());
+      caverns->add(unique<UniformBlob>(SquareChange::reset(CONTENT_ID(FurnitureType, "FLOOR"))), Vec2(size, size), Predicate::alwaysTrue());
       caverns->setCanOverlap(caverns->getLast());
     }
     queue->addMaker(std::move(caverns));
@@ -2794,12 +2859,12 @@ static PLevelMaker underground(RandomGen& random, vector<WaterType> waterTypes =
 PLevelMaker LevelMaker::getFullZLevel(RandomGen& random, optional<SettlementInfo> settlement, ResourceCounts resourceCounts,
     int mapWidth, TribeId keeperTribe, StairKey landingLink) {
   auto queue = unique<MakerQueue>();
-  queue->addMaker(unique<Empty>(SquareChange(FurnitureType("FLOOR"))
-      .add(FurnitureParams{FurnitureType("MOUNTAIN2"), keeperTribe})));
+  queue->addMaker(unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"))
+      .add(FurnitureParams{CONTENT_ID(FurnitureType, "MOUNTAIN2"), keeperTribe})));
   queue->addMaker(underground(random));
   auto locations = unique<RandomLocations>();
   auto startingPosMaker = unique<MakerQueue>(
-      unique<Empty>(SquareChange(FurnitureType("FLOOR"))),
+      unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"))),
       unique<StartingPos>(Predicate::alwaysTrue(), landingLink));
   LevelMaker* startingPos = startingPosMaker.get();
   vector<SurroundWithResourcesInfo> surroundWithResources;
@@ -2833,13 +2898,13 @@ PLevelMaker LevelMaker::getWaterZLevel(RandomGen& random, FurnitureType waterTyp
   auto locations = unique<RandomLocations>();
   LevelMaker* startingPos = nullptr;
   auto startingPosMaker = unique<MakerQueue>(
-      unique<Empty>(SquareChange(FurnitureType("FLOOR"))),
+      unique<Empty>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"))),
       unique<StartingPos>(Predicate::alwaysTrue(), landingLink));
   startingPos = startingPosMaker.get();
   locations->add(std::move(startingPosMaker), Vec2(1, 1),
       RandomLocations::LocationPredicate(Predicate::alwaysTrue()));
   for (int i : Range(5))
-    locations->add(unique<UniformBlob>(SquareChange(FurnitureType("FLOOR"))), Vec2(Random.get(5, 10), Random.get(5, 10)),
+    locations->add(unique<UniformBlob>(SquareChange(CONTENT_ID(FurnitureType, "FLOOR"))), Vec2(Random.get(5, 10), Random.get(5, 10)),
         RandomLocations::LocationPredicate(Predicate::alwaysTrue()));
   locations->setMinMargin(startingPos, mapWidth / 3);
   queue->addMaker(std::move(locations));
@@ -2874,7 +2939,7 @@ class SpecificArea : public LevelMaker {
 PLevelMaker LevelMaker::splashLevel(CreatureGroup heroLeader, CreatureGroup heroes, CreatureGroup monsters,
     CreatureGroup imps, const FilePath& splashPath) {
   auto queue = unique<MakerQueue>();
-  queue->addMaker(unique<Empty>(FurnitureType("BLACK_FLOOR")));
+  queue->addMaker(unique<Empty>(CONTENT_ID(FurnitureType, "BLACK_FLOOR")));
   Rectangle leaderSpawn(
           Level::getSplashVisibleBounds().right() + 1, Level::getSplashVisibleBounds().middle().y,
           Level::getSplashVisibleBounds().right() + 2, Level::getSplashVisibleBounds().middle().y + 1);
@@ -2902,7 +2967,7 @@ PLevelMaker LevelMaker::splashLevel(CreatureGroup heroLeader, CreatureGroup hero
 PLevelMaker LevelMaker::roomLevel(RandomGen& random, SettlementInfo info) {
   auto queue = unique<MakerQueue>();
   BuildingType building = getBuildingInfo(info);
-  SquareChange wall(FurnitureType("FLOOR"), building.wall);
+  SquareChange wall(CONTENT_ID(FurnitureType, "FLOOR"), building.wall);
   queue->addMaker(unique<Empty>(wall));
   queue->addMaker(underground(random, building.water));
   queue->addMaker(unique<RoomMaker>(random.get(8, 15), 4, 7));
@@ -2910,9 +2975,9 @@ PLevelMaker LevelMaker::roomLevel(RandomGen& random, SettlementInfo info) {
   for (auto& furniture : info.furniture)
     queue->addMaker(unique<Furnitures>(Predicate::attrib(SquareAttrib::EMPTY_ROOM), 0.05, furniture, info.tribe));
   for (StairKey key : info.downStairs)
-    queue->addMaker(unique<Stairs>(StairDirection::DOWN, key, Predicate::type(FurnitureType("FLOOR"))));
+    queue->addMaker(unique<Stairs>(StairDirection::DOWN, key, Predicate::type(CONTENT_ID(FurnitureType, "FLOOR"))));
   for (StairKey key : info.upStairs)
-    queue->addMaker(unique<Stairs>(StairDirection::UP, key, Predicate::type(FurnitureType("FLOOR"))));
+    queue->addMaker(unique<Stairs>(StairDirection::UP, key, Predicate::type(CONTENT_ID(FurnitureType, "FLOOR"))));
   queue->addMaker(unique<Inhabitants>(info.inhabitants, info.collective));
   queue->addMaker(unique<Items>(ItemListId("dungeon"), 5, 10));
   return unique<BorderGuard>(std::move(queue), wall);
@@ -2928,15 +2993,15 @@ class SokobanFromFile : public LevelMaker {
     CHECK(area == file.getBounds()) << "Bad size of sokoban input.";
     builder->setNoDiagonalPassing();
     for (Vec2 v : area) {
-      builder->resetFurniture(v, FurnitureType("FLOOR"));
+      builder->resetFurniture(v, CONTENT_ID(FurnitureType, "FLOOR"));
       switch (file[v]) {
         case '.':
           break;
         case '#':
-          builder->putFurniture(v, FurnitureType("DUNGEON_WALL"));
+          builder->putFurniture(v, CONTENT_ID(FurnitureType, "DUNGEON_WALL"));
           break;
         case '^':
-          builder->putFurniture(v, FurnitureType("SOKOBAN_HOLE"));
+          builder->putFurniture(v, CONTENT_ID(FurnitureType, "SOKOBAN_HOLE"));
           break;
         case '$':
           builder->addAttrib(v, SquareAttrib::SOKOBAN_PRIZE);
@@ -2945,7 +3010,7 @@ class SokobanFromFile : public LevelMaker {
           builder->addAttrib(v, SquareAttrib::SOKOBAN_ENTRY);
           break;
         case '+':
-          builder->putFurniture(v, FurnitureParams{FurnitureType("IRON_DOOR"), TribeId::getHostile()});
+          builder->putFurniture(v, FurnitureParams{CONTENT_ID(FurnitureType, "IRON_DOOR"), TribeId::getHostile()});
           break;
         case '0':
           builder->putCreature(v, builder->getContentFactory()->getCreatures().fromId(CreatureId("SOKOBAN_BOULDER"),
@@ -2988,15 +3053,15 @@ class BattleFromFile : public LevelMaker {
         MonsterAIFactory::monster());
     int enemyIndex = 0;
     for (Vec2 v : area) {
-      builder->resetFurniture(v, FurnitureType("FLOOR"));
+      builder->resetFurniture(v, CONTENT_ID(FurnitureType, "FLOOR"));
       switch (level[v]) {
         case '.':
           break;
         case '#':
-          builder->putFurniture(v, FurnitureType("MOUNTAIN"));
+          builder->putFurniture(v, CONTENT_ID(FurnitureType, "MOUNTAIN"));
           break;
         case 'w':
-          builder->putFurniture(v, FurnitureType("WATER"));
+          builder->putFurniture(v, CONTENT_ID(FurnitureType, "WATER"));
           break;
         case 'a':
           if (allyIndex < alliesList.size()) {
@@ -3030,7 +3095,7 @@ PLevelMaker LevelMaker::emptyLevel(FurnitureType t, bool withFloor) {
   auto queue = unique<MakerQueue>();
   SquareChange change(t);
   if (withFloor)
-    change = SquareChange(FurnitureType("FLOOR"), t);
+    change = SquareChange(CONTENT_ID(FurnitureType, "FLOOR"), t);
   queue->addMaker(unique<Empty>(change));
   return std::move(queue);
 }
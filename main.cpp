@@ -56,6 +56,8 @@
 #include "fx_manager.h"
 #include "fx_renderer.h"
 #include "fx_view_manager.h"
+#include "debug_checks.h"
+#include "allocation_tracker.h"
 
 #ifndef VSTUDIO
 #include "stack_printer.h"
@@ -197,6 +199,8 @@ static po::parser getCommandLineFlags() {
   flags["data_dir"].type(po::string).description("Directory containing the game data");
   flags["restore_settings"].description("Restore settings to default values.");
   flags["run_tests"].description("Run all unit tests and exit");
+  flags["neighbor_benchmark"].description("Measure the allocations and time of neighbor iteration and exit");
+  flags["event_upload_test"].type(po::string).description("Send test game events to the given server url and exit");
   flags["worldgen_test"].type(po::i32).description("Test how often world generation fails");
   flags["worldgen_maps"].type(po::string).description("List of maps or enemy types in world generation test. Skip to test all.");
   flags["battle_level"].type(po::string).description("Path to battle test level");
@@ -206,14 +210,26 @@ static po::parser getCommandLineFlags() {
   flags["verify_mod"].type(po::string).description("Verify mod. Requires path to zip file.");
   flags["battle_view"].description("Open game window and display battle");
   flags["battle_rounds"].type(po::i32).description("Number of battle rounds");
+  flags["battle_threads"].type(po::i32).description("Number of battle rounds played in parallel");
+  flags["battle_thread_test"].type(po::i32).description("Check that the battle level gives the same results on one "
+      "and on the given number of threads and exit");
   flags["stderr"].description("Log to stderr");
   flags["nolog"].description("No logging");
+  flags["log_categories"].type(po::string).description("Comma separated list of logged categories: " +
+      DebugLog::getCategoryNames());
   flags["free_mode"].description("Run in free ascii mode");
 #ifndef RELEASE
   flags["quick_game"].description("Skip main menu and load the last save file or start a single map game");
   flags["max_turns"].type(po::i32).description("Quit the game after a given max number of turns");
 #endif
   flags["seed"].type(po::i32).description("Use given seed");
+#ifndef EASY_PROFILER
+  flags["profile"].description("Enable the built-in profiler and write profile.json and profile.txt on exit");
+#endif
+#ifndef RELEASE
+  flags["track_allocations"].description("Count allocations per profiler scope and add them to the memory report");
+#endif
+  flags["check_caches"].description("Verify cached game summaries against a full recomputation");
   flags["record"].type(po::string).description("Record game to file");
   flags["replay"].type(po::string).description("Replay game from file");
   return flags;
@@ -287,6 +303,20 @@ static int keeperMain(po::parser& commandLineFlags) {
     std::cout << commandLineFlags << endl;
     return 0;
   }
+  if (commandLineFlags["check_caches"].was_set())
+    DebugChecks::setEnabled(true);
+#ifndef RELEASE
+  if (commandLineFlags["track_allocations"].was_set())
+    AllocationTracker::setEnabled(true);
+#endif
+#ifndef EASY_PROFILER
+  if (commandLineFlags["profile"].was_set())
+    Profiler::setEnabled(true);
+  DestructorFunction dumpProfileData([] {
+    if (Profiler::isEnabled())
+      Profiler::dumpToFiles();
+  });
+#endif
   bool useSingleThread =
 #ifndef RELEASE
       true;
@@ -307,11 +337,25 @@ static int keeperMain(po::parser& commandLineFlags) {
       [](const string& s) { ofstream("stacktrace.out") << s << "\n" << std::flush; } ));
   if (commandLineFlags["stderr"].was_set() || commandLineFlags["run_tests"].was_set())
     InfoLog.addOutput(DebugOutput::toStream(std::cerr));
+  if (commandLineFlags["log_categories"].was_set()) {
+    auto categories = commandLineFlags["log_categories"].get().string;
+    USER_CHECK(InfoLog.setEnabledCategories(categories)) << "Unknown log category in " << categories;
+  }
+  InfoLog.startAsyncWriter();
+  DestructorFunction stopLogWriter([] { InfoLog.stopAsyncWriter(); });
   Skill::init();
   if (commandLineFlags["run_tests"].was_set()) {
     testAll();
     return 0;
   }
+  if (commandLineFlags["neighbor_benchmark"].was_set()) {
+    neighborBenchmark();
+    return 0;
+  }
+  if (commandLineFlags["event_upload_test"].was_set()) {
+    eventUploadTest(commandLineFlags["event_upload_test"].get().string);
+    return 0;
+  }
   DirectoryPath dataPath([&]() -> string {
     if (commandLineFlags["data_dir"].was_set())
       return commandLineFlags["data_dir"].get().string;
@@ -383,7 +427,7 @@ static int keeperMain(po::parser& commandLineFlags) {
   AppConfig appConfig(dataPath.file("appconfig-dev.txt"));
 #endif
   string uploadUrl = appConfig.get<string>("upload_url");
-  FileSharing fileSharing(uploadUrl, options, installId);
+  FileSharing fileSharing(uploadUrl, options, installId, userPath.file("game_events.txt"));
   Highscores highscores(userPath.file("highscores.dat"), fileSharing, &options);
   if (commandLineFlags["worldgen_test"].was_set()) {
     MainLoop loop(nullptr, &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox, &sokobanInput, nullptr,
@@ -394,22 +438,35 @@ static int keeperMain(po::parser& commandLineFlags) {
     loop.modelGenTest(commandLineFlags["worldgen_test"].get().i32, types, Random, &options);
     return 0;
   }
+  if (commandLineFlags["replay"].was_set()) {
+    MainLoop loop(new DummyView(&clock), &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox,
+        &sokobanInput, nullptr, useSingleThread, appConfig.get<int>("save_version"));
+    try {
+      loop.replayGame(FilePath::fromFullPath(commandLineFlags["replay"].get().string));
+    } catch (GameExitException) {}
+    return 0;
+  }
   auto battleTest = [&] (View* view, TileSet* tileSet) {
     MainLoop loop(view, &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox, &sokobanInput, tileSet,
         useSingleThread, 0);
     auto level = commandLineFlags["battle_level"].get().string;
     auto info = commandLineFlags["battle_info"].get().string;
     auto numRounds = commandLineFlags["battle_rounds"].get().i32;
+    auto numThreads = commandLineFlags["battle_threads"].was_set() ? commandLineFlags["battle_threads"].get().i32 : 1;
     try {
-      if (commandLineFlags["endless_enemy"].was_set()) {
+      if (commandLineFlags["battle_thread_test"].was_set())
+        battleThreadsTest(loop, FilePath::fromFullPath(level), commandLineFlags["battle_thread_test"].get().i32);
+      else if (commandLineFlags["endless_enemy"].was_set()) {
         auto enemy = commandLineFlags["endless_enemy"].get().string;
         optional<int> chosenEnemy;
         if (enemy != "all")
           chosenEnemy = fromString<int>(enemy);
-        loop.endlessTest(numRounds, FilePath::fromFullPath(level), FilePath::fromFullPath(info), Random, chosenEnemy);
+        loop.endlessTest(numRounds, FilePath::fromFullPath(level), FilePath::fromFullPath(info), Random, chosenEnemy,
+            numThreads);
       } else {
         auto enemyId = commandLineFlags["battle_enemy"].get().string;
-        loop.battleTest(numRounds, FilePath::fromFullPath(level), FilePath::fromFullPath(info), enemyId, Random);
+        loop.battleTest(numRounds, FilePath::fromFullPath(level), FilePath::fromFullPath(info), enemyId, Random,
+            numThreads);
       }
     } catch (GameExitException) {}
   };
@@ -445,7 +502,7 @@ static int keeperMain(po::parser& commandLineFlags) {
   }
   if (tilesPresent)
     initializeRendererTiles(renderer, paidDataPath.subdirectory("images"));
-  TileSet tileSet(paidDataPath.subdirectory("images"), freeDataPath.subdirectory(gameConfigSubdir));
+  TileSet tileSet(paidDataPath.subdirectory("images"), freeDataPath.subdirectory(gameConfigSubdir), userPath);
   renderer.setTileSet(&tileSet);
   FileSharing bugreportSharing("http://retired.keeperrl.com/~bugreports", options, installId);
   unique_ptr<View> view;
@@ -453,6 +510,8 @@ static int keeperMain(po::parser& commandLineFlags) {
       {renderer, guiFactory, tilesPresent, &options, &clock, soundLibrary, &bugreportSharing, userPath, installId}));
 #ifndef RELEASE
   InfoLog.addOutput(DebugOutput::toString([&view](const string& s) { view->logMessage(s);}));
+  // Write the buffered lines while the view still exists.
+  DestructorFunction flushLog([] { InfoLog.flush(); });
 #endif
   unique_ptr<fx::FXManager> fxManager;
   unique_ptr<fx::FXRenderer> fxRenderer;
@@ -474,6 +533,8 @@ static int keeperMain(po::parser& commandLineFlags) {
   }
   MainLoop loop(view.get(), &highscores, &fileSharing, freeDataPath, userPath, &options, &jukebox, &sokobanInput, &tileSet,
       useSingleThread, appConfig.get<int>("save_version"));
+  if (commandLineFlags["record"].was_set())
+    loop.setInputRecording(FilePath::fromFullPath(commandLineFlags["record"].get().string), seed);
   try {
     if (audioError)
       view->presentText("Failed to initialize audio. The game will be started without sound.", *audioError);
@@ -41,6 +41,12 @@
 #include "scroll_position.h"
 #include "miniunz.h"
 #include "external_enemies_type.h"
+#include "input_recording.h"
+#include "perf_counters.h"
+#include "version.h"
+#include "content_hash.h"
+#include "item_attributes.h"
+#include "dummy_view.h"
 
 MainLoop::MainLoop(View* v, Highscores* h, FileSharing* fSharing, const DirectoryPath& freePath,
     const DirectoryPath& uPath, Options* o, Jukebox* j, SokobanInput* soko, TileSet* tileSet, bool singleThread, int sv)
@@ -85,6 +91,25 @@ static string getSaveSuffix(GameSaveType t) {
   }
 }
 
+// Versions from 4000 on belong to the development series, the others to the release series.
+static bool isAtLeast(int saveVersion, int releaseVersion, int devVersion) {
+  if (saveVersion >= 4000)
+    return saveVersion >= devVersion;
+  return saveVersion >= releaseVersion;
+}
+
+// Binds the tables that compact the part of a save that follows the header, as far as its version supports them.
+struct SaveTables {
+  SaveTables(const void* archive, int saveVersion) {
+    if (isAtLeast(saveVersion, 3401, 4001))
+      contentIds = unique<ContentIdTable>(archive);
+    if (isAtLeast(saveVersion, 3402, 4002))
+      itemAttributes = unique<ItemAttributesTable>(archive);
+  }
+  unique_ptr<ContentIdTable> contentIds;
+  unique_ptr<ItemAttributesTable> itemAttributes;
+};
+
 template <typename T>
 static optional<T> loadFromFile(const FilePath& filename, bool failSilently) {
   try {
@@ -94,6 +119,7 @@ static optional<T> loadFromFile(const FilePath& filename, bool failSilently) {
     SavedGameInfo discard2;
     int version;
     input.getArchive() >> version >> discard >> discard2;
+    SaveTables tables(&input.getArchive(), version);
     input.getArchive() >> obj;
     return std::move(obj);
   } catch (std::exception& ex) {
@@ -114,11 +140,13 @@ static string stripFilename(string s) {
 }
 
 void MainLoop::saveGame(PGame& game, const FilePath& path) {
+  PerfTimer timer(PerfCounter::SAVE_TIME);
   CompressedOutput out(path.getPath());
   string name = game->getGameDisplayName();
   SavedGameInfo savedInfo = game->getSavedGameInfo();
   savedInfo.spriteMods = tileSet->getSpriteMods();
   out.getArchive() << saveVersion << name << savedInfo;
+  SaveTables tables(&out.getArchive(), saveVersion);
   out.getArchive() << game;
 }
 
@@ -129,11 +157,13 @@ struct RetiredModelInfo {
 };
 
 void MainLoop::saveMainModel(PGame& game, const FilePath& path) {
+  PerfTimer timer(PerfCounter::SAVE_TIME);
   CompressedOutput out(path.getPath());
   string name = game->getGameDisplayName();
   SavedGameInfo savedInfo = game->getSavedGameInfo();
   savedInfo.spriteMods = tileSet->getSpriteMods();
   out.getArchive() << saveVersion << name << savedInfo;
+  SaveTables tables(&out.getArchive(), saveVersion);
   RetiredModelInfo info {
     std::move(game->getMainModel()),
     game->removeContentFactory()
@@ -241,13 +271,22 @@ void MainLoop::bugReportSave(PGame& game, FilePath path) {
 }
 
 MainLoop::ExitCondition MainLoop::playGame(PGame game, bool withMusic, bool noAutoSave,
-    function<optional<ExitCondition>(WGame)> exitCondition, milliseconds stepTimeMilli, optional<int> maxTurns) {
-  tileSet->setTilePaths(game->getContentFactory()->tilePaths);
+    function<optional<ExitCondition>(WGame)> exitCondition, milliseconds stepTimeMilli, optional<int> maxTurns,
+    bool fixedStep) {
+  if (tileSet)
+    tileSet->setTilePaths(game->getContentFactory()->tilePaths);
   view->reset();
   if (!noAutoSave)
     view->setBugReportSaveCallback([&] (FilePath path) { bugReportSave(game, path); });
   DestructorFunction removeCallback([&] { view->setBugReportSaveCallback(nullptr); });
+  unique_ptr<InputRecorder> inputRecorder;
+  // Only the first game is recorded, so that a later one doesn't overwrite its recording.
+  if (inputRecordingPath) {
+    inputRecorder = startInputRecording(game);
+    inputRecordingPath = none;
+  }
   game->initialize(options, highscores, view, fileSharing);
+  game->setInputRecorder(inputRecorder.get());
   Intervalometer meter(stepTimeMilli);
   Intervalometer pausingMeter(stepTimeMilli);
   auto lastMusicUpdate = GlobalTime(-1000);
@@ -265,7 +304,7 @@ MainLoop::ExitCondition MainLoop::playGame(PGame game, bool withMusic, bool noAu
       double count = meter.getCount(timeMilli);
       //INFO << "Intervalometer " << timeMilli << " " << count;
       step = min(1.0, double(count) * gameTimeStep);
-      if (maxTurns)
+      if (maxTurns || fixedStep)
         step = 1;
       if (view->isClockStopped()) {
         // Advance the clock a little more until the local time reaches 0.99,
@@ -279,6 +318,8 @@ MainLoop::ExitCondition MainLoop::playGame(PGame game, bool withMusic, bool noAu
         pausingMeter.clear();
     }
     INFO << "Time step " << step;
+    if (inputRecorder)
+      inputRecorder->startFrame(game->getGlobalTimeDouble(), step);
     if (auto exitInfo = game->update(step)) {
       exitInfo->visit(
           [&](ExitAndQuit) {
@@ -312,9 +353,63 @@ MainLoop::ExitCondition MainLoop::playGame(PGame game, bool withMusic, bool noAu
       lastAutoSave = gameTime;
     }
     view->refreshView();
+    PROFILE_END_FRAME;
   }
 }
 
+void MainLoop::setInputRecording(const FilePath& path, int seed) {
+  inputRecordingPath = path;
+  inputRecordingSeed = seed;
+}
+
+unique_ptr<InputRecorder> MainLoop::startInputRecording(PGame& game) {
+  // Continue playing a deserialized copy of the game, so that the recording and the replay start from identical state.
+  std::stringstream state;
+  {
+    OutputArchive output(state);
+    output << game;
+  }
+  {
+    InputArchive input(state);
+    input >> game;
+  }
+  Random.init(inputRecordingSeed);
+  INFO << "Recording input to " << *inputRecordingPath;
+  return unique<InputRecorder>(*inputRecordingPath, inputRecordingSeed, saveVersion, state.str());
+}
+
+void MainLoop::replayGame(const FilePath& path) {
+  InputReplay replay(path);
+  USER_CHECK(isCompatible(replay.getSaveVersion())) << "Replay " << path << " was recorded with an incompatible version";
+  PGame game;
+  {
+    std::istringstream state(replay.getGameState());
+    InputArchive input(state);
+    input >> game;
+  }
+  Random.init(replay.getSeed());
+  game->initialize(options, highscores, view, fileSharing);
+  game->setInputReplay(&replay);
+  auto startTime = steady_clock::now();
+  int numFrames = 0;
+  try {
+    while (auto frame = replay.nextFrame()) {
+      if (frame->time != game->getGlobalTimeDouble()) {
+        std::cout << "Replay desynchronized in frame " << numFrames << ": recorded time " << frame->time
+            << ", actual time " << game->getGlobalTimeDouble() << std::endl;
+        break;
+      }
+      ++numFrames;
+      if (game->update(frame->step))
+        break;
+    }
+  } catch (GameExitException) {}
+  auto totalTime = duration_cast<milliseconds>(steady_clock::now() - startTime).count();
+  std::cout << "Replayed " << numFrames << " frames up to turn " << game->getGlobalTime().getVisibleInt()
+      << " in " << totalTime << "ms, " << replay.getNumDesyncs() << " frames with unconsumed input, "
+      << InfoLog.getNumLines() << " lines logged" << std::endl;
+}
+
 void MainLoop::eraseAllSavesExcept(const PGame& game, optional<GameSaveType> except) {
   for (auto erasedType : ENUM_ALL(GameSaveType))
     if (erasedType != except)
@@ -566,11 +661,85 @@ void MainLoop::considerFreeVersionText(bool tilesPresent) {
         "More information on the website.");
 }
 
+/* Parsing the text config is slow, so after a successful parse the resulting ContentFactory is stored in
+   the user directory. The cache key covers every input file and the build, so any change to the data causes
+   a reparse. Only release builds use the cache, because during development the serialized classes change
+   without a change of the build version. The keys of the parsed data are cached too, so that the ids used in
+   the code are verified against it on every load. The NameGenerator is always created anew, because it
+   shuffles the names using Random, and the games must not depend on whether the cache was there. */
+optional<string> MainLoop::readContentFactory(ContentFactory& ret, const string& modName) const {
+  auto startTime = steady_clock::now();
+  auto getElapsedMillis = [&] {
+    return duration_cast<milliseconds>(steady_clock::now() - startTime).count();
+  };
+  auto configPath = dataFreePath.subdirectory(gameConfigSubdir);
+  auto namesPath = dataFreePath.subdirectory("names");
+#ifdef RELEASE
+  ContentHash contentHash;
+  contentHash.add(BUILD_VERSION);
+  contentHash.add(BUILD_DATE);
+  contentHash.add(toString(saveVersion));
+  contentHash.add(modName);
+  contentHash.addDirectory(configPath.subdirectory(modName));
+  contentHash.addDirectory(namesPath);
+  auto hash = contentHash.get();
+  auto cachePath = userPath.file("content_cache_" + modName + ".dat");
+  {
+    StreamCombiner<ifstream, InputArchive> input(cachePath.getPath(), std::ios::binary);
+    if (input.getStream().good())
+      try {
+        unsigned long long cachedHash;
+        input.getArchive() >> cachedHash;
+        if (cachedHash == hash) {
+          map<string, set<string>> keys;
+          ContentFactory cached;
+          input.getArchive() >> keys >> cached;
+          auto errors = ContentIdLiterals::verify(keys);
+          if (!errors.empty())
+            return errors.front();
+          *cached.getCreatures().getNameGenerator() = NameGenerator(namesPath);
+          ret = std::move(cached);
+          INFO << "Loaded cached game data of \"" << modName << "\" in " << getElapsedMillis() << " ms";
+          return none;
+        }
+      } catch (std::exception& e) {
+        INFO << "Error reading " << cachePath << ": " << e.what();
+      }
+  }
+#endif
+  GameConfig config(configPath, modName);
+  map<string, set<string>> keys;
+  if (auto err = ret.readData(NameGenerator(namesPath), &config, &keys))
+    return err;
+  INFO << "Parsed game data of \"" << modName << "\" in " << getElapsedMillis() << " ms";
+#ifdef RELEASE
+  // The cache is written to a temporary file first and then renamed, so that a crash never leaves a partially
+  // written one. The temporary name is unique to the writing thread, because another instance may be writing
+  // the same cache at the same time.
+  string tmpPath = cachePath.getPath() + "."_s + toString(currentThreadId()) + "."_s +
+      toString(steady_clock::now().time_since_epoch().count()) + ".tmp"_s;
+  try {
+    {
+      StreamCombiner<ofstream, OutputArchive> output(tmpPath, std::ios::binary);
+      output.getArchive() << hash << keys << ret;
+    }
+    // rename replaces the old file atomically on POSIX, but fails if it exists on Windows.
+    if (rename(tmpPath.c_str(), cachePath.getPath()) != 0) {
+      remove(cachePath.getPath());
+      rename(tmpPath.c_str(), cachePath.getPath());
+    }
+  } catch (std::exception& e) {
+    INFO << "Error writing " << cachePath << ": " << e.what();
+    remove(tmpPath.c_str());
+  }
+#endif
+  return none;
+}
+
 ContentFactory MainLoop::createContentFactory(bool vanillaOnly) const {
   ContentFactory ret;
   auto tryConfig = [this, &ret](const string& modName) {
-    GameConfig config(dataFreePath.subdirectory(gameConfigSubdir), modName);
-    return ret.readData(NameGenerator(dataFreePath.subdirectory("names")), &config);
+    return readContentFactory(ret, modName);
   };
   if (vanillaOnly) {
 #ifdef RELEASE
@@ -714,7 +883,7 @@ static CreatureList readAlly(ifstream& input) {
 }
 
 void MainLoop::battleTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, string enemy,
-    RandomGen& random) {
+    RandomGen& random, int numThreads) {
   ifstream input(battleInfoPath.getPath());
   CreatureList enemies;
   for (auto& elem : split(enemy, {','})) {
@@ -730,12 +899,12 @@ void MainLoop::battleTest(int numTries, const FilePath& levelPath, const FilePat
   for (int i : Range(cnt)) {
     auto allies = readAlly(input);
     std::cout << allies.getSummary(&contentFactory.getCreatures()) << ": ";
-    battleTest(numTries, levelPath, allies, enemies, random);
+    battleTest(numTries, levelPath, allies, enemies, random, numThreads);
   }
 }
 
 void MainLoop::endlessTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath,
-    RandomGen& random, optional<int> numEnemy) {
+    RandomGen& random, optional<int> numEnemy, int numThreads) {
   ifstream input(battleInfoPath.getPath());
   int cnt = 0;
   input >> cnt;
@@ -752,7 +921,7 @@ void MainLoop::endlessTest(int numTries, const FilePath& levelPath, const FilePa
       int totalWins = 0;
       for (auto& allyInfo : allies) {
         std::cerr << allyInfo.getSummary(&contentFactory.getCreatures()) << ": ";
-        int numWins = battleTest(numTries, levelPath, allyInfo, wave->enemy.creatures, random);
+        int numWins = battleTest(numTries, levelPath, allyInfo, wave->enemy.creatures, random, numThreads);
         totalWins += numWins;
       }
       std::cerr << totalWins << " wins\n";
@@ -779,65 +948,160 @@ optional<string> MainLoop::verifyMod(const string& path) {
   return "Failed to load any mod"_s;
 }
 
-int MainLoop::battleTest(int numTries, const FilePath& levelPath, CreatureList ally, CreatureList enemies,
-    RandomGen& random) {
+// Plays a round with its own random generator, so that the result depends only on the seed, and not on the
+// thread or the order in which the rounds are played. The game data is parsed once by the caller and every
+// round gets its own copy.
+MainLoop::ExitCondition MainLoop::playBattleRound(const FilePath& levelPath, const CreatureList& ally,
+    const CreatureList& enemies, const string& serializedContent, int seed, bool showInView) {
+  RandomGen random;
+  random.init(seed);
+  RandomGen::ThreadOverride randomOverride(random);
   ProgressMeter meter(1);
-  int numAllies = 0;
-  int numEnemies = 0;
-  int numUnknown = 0;
+  ContentFactory contentFactory;
+  {
+    StreamCombiner<istringstream, InputArchive> input(serializedContent);
+    input.getArchive() >> contentFactory;
+  }
+  *contentFactory.getCreatures().getNameGenerator() = NameGenerator(dataFreePath.subdirectory("names"));
+  EnemyFactory enemyFactory(Random, contentFactory.getCreatures().getNameGenerator(), contentFactory.enemies,
+      contentFactory.externalEnemies);
+  auto model = ModelBuilder(&meter, Random, options, sokobanInput,
+      &contentFactory, std::move(enemyFactory)).battleModel(levelPath, ally, enemies);
+  auto game = Game::splashScreen(std::move(model), CampaignBuilder::getEmptyCampaign(), std::move(contentFactory));
   auto allyTribe = TribeId::getDarkKeeper();
-  std::cout.flush();
-  for (int i : Range(numTries)) {
-    std::cout << "Creating level" << std::endl;
-    auto contentFactory = createContentFactory(false);
-    EnemyFactory enemyFactory(Random, contentFactory.getCreatures().getNameGenerator(), contentFactory.enemies,
-        contentFactory.externalEnemies);
-    auto model = ModelBuilder(&meter, Random, options, sokobanInput,
-        &contentFactory, std::move(enemyFactory)).battleModel(levelPath, ally, enemies);
-    auto game = Game::splashScreen(std::move(model), CampaignBuilder::getEmptyCampaign(), std::move(contentFactory));
-    std::cout << "Done" << std::endl;
-    auto exitCondition = [&](WGame game) -> optional<ExitCondition> {
-      unordered_set<TribeId, CustomHash<TribeId>> tribes;
-      for (auto& m : game->getAllModels())
-        for (auto c : m->getAllCreatures())
-          tribes.insert(c->getTribeId());
-      if (tribes.size() == 1) {
-        if (*tribes.begin() == allyTribe)
-          return ExitCondition::ALLIES_WON;
-        else
-          return ExitCondition::ENEMIES_WON;
-      }
-      if (game->getGlobalTime().getVisibleInt() > 200)
-        return ExitCondition::TIMEOUT;
-      if (tribes.empty())
-        return ExitCondition::UNKNOWN;
+  auto exitCondition = [&](WGame game) -> optional<ExitCondition> {
+    unordered_set<TribeId, CustomHash<TribeId>> tribes;
+    for (auto& m : game->getAllModels())
+      for (auto c : m->getAllCreatures())
+        tribes.insert(c->getTribeId());
+    if (tribes.size() == 1) {
+      if (*tribes.begin() == allyTribe)
+        return ExitCondition::ALLIES_WON;
       else
-        return none;
-    };
-    auto result = playGame(std::move(game), false, true, exitCondition, milliseconds{3});
-    switch (result) {
+        return ExitCondition::ENEMIES_WON;
+    }
+    if (game->getGlobalTime().getVisibleInt() > 200)
+      return ExitCondition::TIMEOUT;
+    if (tribes.empty())
+      return ExitCondition::UNKNOWN;
+    else
+      return none;
+  };
+  // Both paths advance the game by a whole turn per update, so watching a round doesn't change its result.
+  if (showInView)
+    return playGame(std::move(game), false, true, exitCondition, milliseconds{3}, none, true);
+  Clock clock;
+  DummyView dummyView(&clock);
+  game->initialize(options, highscores, &dummyView, fileSharing);
+  while (true) {
+    if (game->update(1))
+      return ExitCondition::UNKNOWN;
+    if (auto result = exitCondition(game.get()))
+      return *result;
+  }
+}
+
+string MainLoop::playBattleRounds(const FilePath& levelPath, const CreatureList& ally, const CreatureList& enemies,
+    const vector<int>& seeds, int numThreads, function<void(char, milliseconds)> onResult) {
+  // The window can only show one battle at a time.
+  bool showInView = !!tileSet;
+  if (showInView)
+    numThreads = 1;
+  string serializedContent;
+  {
+    StreamCombiner<ostringstream, OutputArchive> output;
+    output.getArchive() << createContentFactory(false);
+    serializedContent = output.getStream().str();
+  }
+  auto getResultLetter = [] (ExitCondition condition) {
+    switch (condition) {
       case ExitCondition::ALLIES_WON:
-        ++numAllies;
-        std::cerr << "a";
-        break;
+        return 'a';
       case ExitCondition::ENEMIES_WON:
-        ++numEnemies;
-        std::cerr << "e";
-        break;
+        return 'e';
       case ExitCondition::TIMEOUT:
-        ++numUnknown;
-        std::cerr << "t";
-        break;
-      case ExitCondition::UNKNOWN:
-        ++numUnknown;
-        std::cerr << "u";
-        break;
+        return 't';
+      default:
+        return 'u';
     }
-    std::cerr.flush();
-  }
+  };
+  struct RoundResult {
+    char letter;
+    milliseconds time;
+  };
+  int numRounds = seeds.size();
+  vector<optional<RoundResult>> results(numRounds);
+  std::mutex resultsMutex;
+  int numReported = 0;
+  atomic<int> nextRound(0);
+  auto playRounds = [&] {
+    for (int i = nextRound++; i < numRounds; i = nextRound++) {
+      auto startTime = steady_clock::now();
+      auto condition = playBattleRound(levelPath, ally, enemies, serializedContent, seeds[i], showInView);
+      std::lock_guard<std::mutex> lock(resultsMutex);
+      results[i] = RoundResult{getResultLetter(condition),
+          duration_cast<milliseconds>(steady_clock::now() - startTime)};
+      // The rounds are reported in order, so the output is the same for any number of threads.
+      for (; numReported < numRounds && results[numReported]; ++numReported)
+        if (onResult)
+          onResult(results[numReported]->letter, results[numReported]->time);
+    }
+  };
+  vector<thread> threads;
+  for (int i : Range(numThreads - 1))
+    threads.push_back(makeThread(playRounds));
+  playRounds();
+  for (auto& t : threads)
+    t.join();
+  string ret;
+  for (auto& result : results)
+    ret += result->letter;
+  return ret;
+}
+
+// Returns the 95% Wilson score interval of the probability of success.
+static pair<double, double> getConfidenceInterval(int numSuccesses, int numTries) {
+  const double z = 1.96;
+  double p = double(numSuccesses) / numTries;
+  double denominator = 1 + z * z / numTries;
+  double center = (p + z * z / (2 * numTries)) / denominator;
+  double margin = z * sqrt(p * (1 - p) / numTries + z * z / (4 * numTries * numTries)) / denominator;
+  return {max(0.0, center - margin), min(1.0, center + margin)};
+}
+
+static string formatPercent(double value) {
+  return toString(round(value * 1000) / 10) + "%";
+}
+
+int MainLoop::battleTest(int numTries, const FilePath& levelPath, CreatureList ally, CreatureList enemies,
+    RandomGen& random, int numThreads) {
+  vector<int> seeds;
+  for (int i : Range(numTries))
+    seeds.push_back(random.get(1 << 30));
+  milliseconds roundTime(0);
+  milliseconds maxRoundTime(0);
+  auto startTime = steady_clock::now();
+  auto results = playBattleRounds(levelPath, ally, enemies, seeds, numThreads,
+      [&] (char letter, milliseconds time) {
+        std::cerr << letter;
+        std::cerr.flush();
+        roundTime += time;
+        maxRoundTime = max(maxRoundTime, time);
+      });
+  auto totalTime = duration_cast<milliseconds>(steady_clock::now() - startTime);
+  int numAllies = std::count(results.begin(), results.end(), 'a');
+  int numEnemies = std::count(results.begin(), results.end(), 'e');
+  int numUnknown = numTries - numAllies - numEnemies;
   std::cerr << " " << numAllies << ":" << numEnemies;
   if (numUnknown > 0)
     std::cerr << " (" << numUnknown << ") unknown";
+  if (numTries > 0) {
+    auto interval = getConfidenceInterval(numAllies, numTries);
+    std::cerr << ", allies won " << formatPercent(double(numAllies) / numTries) << " (95% CI " <<
+        formatPercent(interval.first) << " - " << formatPercent(interval.second) << "), " <<
+        roundTime.count() / numTries << " ms per round (max " << maxRoundTime.count() << " ms), " <<
+        totalTime.count() << " ms total";
+  }
   std::cerr << "\n";
   return numAllies;
 }
@@ -29,6 +29,7 @@ struct ModelTable;
 class TileSet;
 class ContentFactory;
 class TilePaths;
+class InputRecorder;
 
 class MainLoop {
   public:
@@ -37,11 +38,23 @@ class MainLoop {
 
   void start(bool tilesPresent);
   void modelGenTest(int numTries, const vector<std::string>& types, RandomGen&, Options*);
-  void battleTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, string enemyId, RandomGen&);
-  int battleTest(int numTries, const FilePath& levelPath, CreatureList ally, CreatureList enemyId, RandomGen&);
-  void endlessTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, RandomGen&, optional<int> numEnemy);
+  // The rounds are played by numThreads threads. Every round gets its own seed from the RandomGen, so the results
+  // don't depend on the number of threads.
+  void battleTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, string enemyId, RandomGen&,
+      int numThreads);
+  int battleTest(int numTries, const FilePath& levelPath, CreatureList ally, CreatureList enemyId, RandomGen&,
+      int numThreads);
+  // Plays a round for every seed on numThreads threads and returns the results in the order of the seeds,
+  // one letter per round: a - allies won, e - enemies won, t - timeout, u - unknown. onResult is called in the
+  // same order as soon as a round's result is known.
+  string playBattleRounds(const FilePath& levelPath, const CreatureList& ally, const CreatureList& enemies,
+      const vector<int>& seeds, int numThreads, function<void(char, milliseconds)> onResult = nullptr);
+  void endlessTest(int numTries, const FilePath& levelPath, const FilePath& battleInfoPath, RandomGen&,
+      optional<int> numEnemy, int numThreads);
   optional<string> verifyMod(const string& path);
   void launchQuickGame(optional<int> maxTurns);
+  void setInputRecording(const FilePath&, int seed);
+  void replayGame(const FilePath&);
 
   static TimeInterval getAutosaveFreq();
 
@@ -65,7 +78,10 @@ class MainLoop {
   PGame prepareCampaign(RandomGen&);
   enum class ExitCondition;
   ExitCondition playGame(PGame, bool withMusic, bool noAutoSave,
-      function<optional<ExitCondition> (WGame)> = nullptr, milliseconds stepTimeMilli = milliseconds{3}, optional<int> maxTurns = none);
+      function<optional<ExitCondition> (WGame)> = nullptr, milliseconds stepTimeMilli = milliseconds{3}, optional<int> maxTurns = none,
+      bool fixedStep = false);
+  ExitCondition playBattleRound(const FilePath& levelPath, const CreatureList& ally, const CreatureList& enemies,
+      const string& serializedContent, int seed, bool showInView);
   void splashScreen();
   void showCredits(const FilePath& path);
   void showMods();
@@ -103,7 +119,11 @@ class MainLoop {
   int saveVersion;
   void saveGame(PGame&, const FilePath&);
   void saveMainModel(PGame&, const FilePath&);
+  unique_ptr<InputRecorder> startInputRecording(PGame&);
+  optional<FilePath> inputRecordingPath;
+  int inputRecordingSeed = 0;
   ContentFactory createContentFactory(bool vanillaOnly) const;
+  optional<string> readContentFactory(ContentFactory&, const string& modName) const;
   TilePaths getTilePathsForAllMods() const;
   int getLocalVersion(const string& mod);
   void updateLocalVersion(const string& mod, int version);
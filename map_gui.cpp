@@ -37,6 +37,7 @@
 #include "fx_manager.h"
 #include "fx_view_manager.h"
 #include "fx_renderer.h"
+#include "perf_counters.h"
 
 using SDL::SDL_Keysym;
 using SDL::SDL_Keycode;
@@ -45,7 +46,7 @@ MapGui::MapGui(Callbacks call, SyncQueue<UserInput>& inputQueue, Clock* c, Optio
     unique_ptr<fx::FXRenderer> fxRenderer, unique_ptr<FXViewManager> fxViewManager)
     : objects(Level::getMaxBounds()), callbacks(call), inputQueue(inputQueue),
     clock(c), options(o), fogOfWar(Level::getMaxBounds(), false), extraBorderPos(Level::getMaxBounds(), {}),
-    lastSquareUpdate(Level::getMaxBounds()), connectionMap(Level::getMaxBounds()), guiFactory(f),
+    objectUpToDate(Level::getMaxBounds(), false), connectionMap(Level::getMaxBounds()), guiFactory(f),
     fxRenderer(std::move(fxRenderer)), fxViewManager(std::move(fxViewManager)) {
   clearCenter();
 }
@@ -54,8 +55,8 @@ MapGui::~MapGui() = default;
 
 constexpr int fireVar = 50;
 
-static Color getFireColor() {
-  return Color(200 + Random.get(-fireVar, fireVar), Random.get(fireVar), Random.get(fireVar), 150);
+static Color getFireColor(RandomGen& random) {
+  return Color(200 + random.get(-fireVar, fireVar), random.get(fireVar), random.get(fireVar), 150);
 }
 
 void MapGui::setButtonViewId(ViewId id) {
@@ -709,7 +710,7 @@ void MapGui::drawObjectAbs(Renderer& renderer, Vec2 pos, const ViewObject& objec
     renderer.drawText(tile.symFont ? Renderer::SYMBOL_FONT : Renderer::TILE_FONT, size.y,
         blendNightColor(color, index), tilePos, tile.text, Renderer::HOR);
     if (object.hasModifier(ViewObject::Modifier::BURNING))
-      renderer.drawText(Renderer::SYMBOL_FONT, size.y, getFireColor(),
+      renderer.drawText(Renderer::SYMBOL_FONT, size.y, getFireColor(random),
           pos + Vec2(size.x / 2, -3), u8"Ѡ", Renderer::HOR);
     if (object.hasModifier(ViewObject::Modifier::LOCKED))
       renderer.drawText(blendNightColor(Color::YELLOW, index), pos + size / 2, "*", Renderer::CenterType::HOR_VER, size.y);
@@ -1227,7 +1228,7 @@ bool MapGui::onClick(GuiElem::ClickButton b, Vec2 v) {
   }
 }
 
-void MapGui::updateObject(Vec2 pos, CreatureView* view, Renderer& renderer, milliseconds currentTime) {
+void MapGui::updateObject(Vec2 pos, CreatureView* view, Renderer& renderer) {
   auto level = view->getCreatureViewLevel();
   objects[pos].emplace();
   auto& index = *objects[pos];
@@ -1235,7 +1236,7 @@ void MapGui::updateObject(Vec2 pos, CreatureView* view, Renderer& renderer, mill
   level->setNeedsRenderUpdate(pos, false);
   if (index.hasObject(ViewLayer::FLOOR) || index.hasObject(ViewLayer::FLOOR_BACKGROUND))
     index.setGradient(GradientType::NIGHT, 1.0 - level->getLight(pos));
-  lastSquareUpdate[pos] = currentTime;
+  objectUpToDate[pos] = true;
   connectionMap[pos].clear();
   shadowed.erase(pos + Vec2(0, 1));
   if (index.hasObject(ViewLayer::FLOOR)) {
@@ -1270,6 +1271,11 @@ double MapGui::getDistanceToEdgeRatio(Vec2 pos) {
   return ret;
 }
 
+void MapGui::invalidateObjects(Rectangle bounds) {
+  for (Vec2 pos : bounds)
+    objectUpToDate[pos] = false;
+}
+
 void MapGui::updateObjects(CreatureView* view, Renderer& renderer, MapLayout* mapLayout, bool smoothMovement, bool ui,
     const optional<TutorialInfo>& tutorial) {
   if (tutorial) {
@@ -1283,18 +1289,35 @@ void MapGui::updateObjects(CreatureView* view, Renderer& renderer, MapLayout* ma
   levelBounds = level->getBounds();
   mouseUI = ui;
   layout = mapLayout;
-  auto currentTimeReal = clock->getRealMillis();
   // hacky way to detect that we're switching between real-time and turn-based and not between
   // team members in turn-based mode.
   bool newView = (view->getCenterType() != previousView);
-  if (newView || level != previousLevel)
-    for (Vec2 pos : level->getBounds())
-      level->setNeedsRenderUpdate(pos, true);
-  else
-    for (Vec2 pos : mapLayout->getAllTiles(getBounds(), Level::getMaxBounds(), getScreenPos()))
-      if (level->needsRenderUpdate(pos) ||
-          !lastSquareUpdate[pos] || *lastSquareUpdate[pos] < currentTimeReal - milliseconds{1000})
-        updateObject(pos, view, renderer, currentTimeReal);
+  // Sunlight changes the night gradient of every tile, so quantize it to avoid refreshing the map every turn.
+  int sunlight = int(level->getGame()->getSunlightInfo().getLightAmount() * 64);
+  auto changedTiles = level->popRenderUpdates();
+  auto visibleTiles = mapLayout->getAllTiles(getBounds(), Level::getMaxBounds(), getScreenPos());
+  int numUpdated = 0;
+  if (newView || level != previousLevel || sunlight != previousSunlight) {
+    invalidateObjects(level->getBounds());
+    previousVisibleTiles = none;
+  } else
+    for (Vec2 pos : changedTiles)
+      if (pos.inRectangle(visibleTiles)) {
+        updateObject(pos, view, renderer);
+        ++numUpdated;
+      } else
+        objectUpToDate[pos] = false;
+  // Tiles that scrolled into view may have changed since they were last displayed.
+  if (!previousVisibleTiles || *previousVisibleTiles != visibleTiles) {
+    for (Vec2 pos : visibleTiles)
+      if (!objectUpToDate[pos]) {
+        updateObject(pos, view, renderer);
+        ++numUpdated;
+      }
+    previousVisibleTiles = visibleTiles;
+  }
+  previousSunlight = sunlight;
+  PerfCounters::add(PerfCounter::TILE_UPDATES, numUpdated);
   previousView = view->getCenterType();
   if (previousLevel != level) {
     screenMovement = none;
@@ -95,7 +95,8 @@ class MapGui : public GuiElem {
   bool onLeftClick(Vec2);
   bool onRightClick(Vec2);
   bool onMiddleClick(Vec2);
-  void updateObject(Vec2, CreatureView*, Renderer&, milliseconds currentTime);
+  void updateObject(Vec2, CreatureView*, Renderer&);
+  void invalidateObjects(Rectangle bounds);
   void drawObjectAbs(Renderer&, Vec2 pos, const ViewObject&, Vec2 size, Vec2 movement, Vec2 tilePos,
       milliseconds currentTimeReal, const ViewIndex&);
   void drawCreatureHighlights(Renderer&, const ViewObject&, const ViewIndex&, Vec2 pos, Vec2 sz,
@@ -153,7 +154,9 @@ class MapGui : public GuiElem {
   } mouseOffset, center;
   WConstLevel previousLevel = nullptr;
   optional<CreatureViewCenterType> previousView;
-  Table<optional<milliseconds>> lastSquareUpdate;
+  Table<bool> objectUpToDate;
+  optional<Rectangle> previousVisibleTiles;
+  optional<int> previousSunlight;
   optional<Coords> softCenter;
   Vec2 lastMousePos;
   optional<Vec2> lastMouseMove;
@@ -207,6 +210,8 @@ class MapGui : public GuiElem {
   //double lastFxTimeReal = -1.0, lastFxTimeTurn = -1.0;
   unique_ptr<fx::FXRenderer> fxRenderer;
   unique_ptr<FXViewManager> fxViewManager;
+  // Used only on the render thread, so that the UI doesn't take numbers from the game's Random.
+  RandomGen random;
   void updateFX(milliseconds currentTimeReal);
   void drawFurnitureCracks(Renderer&, Vec2 tilePos, float state, Vec2 pos, Vec2 size, const ViewIndex& index);
 };
@@ -19,34 +19,141 @@
 #include "level.h"
 #include "view_object.h"
 #include "view_index.h"
+#include "memory_report.h"
+
+template <class Archive>
+void MapMemory::serialize(Archive& ar, const unsigned int version) {
+  if (Archive::is_loading::value) {
+    vector<ViewIndex> indexes;
+    if (version == 0) {
+      // Older saves stored a full ViewIndex for every tile.
+      HeapAllocated<PositionMap<ViewIndex>> oldTable;
+      ar(oldTable);
+      table = oldTable->transform<int>([&](const ViewIndex& index) { return addToPool(index); });
+    } else {
+      ar(indexes, table);
+      table = table.transform<int>([&](int id) { return addToPool(indexes[id]); });
+    }
+  } else {
+    // Write the pool without the free slots, renumbering the tiles accordingly.
+    vector<ViewIndex> indexes;
+    vector<int> newIds(poolById.size(), -1);
+    auto newTable = table.transform<int>([&](int id) {
+      if (newIds[id] == -1) {
+        newIds[id] = indexes.size();
+        indexes.push_back(*poolById[id]);
+      }
+      return newIds[id];
+    });
+    ar(indexes, newTable);
+  }
+}
 
-SERIALIZE_DEF(MapMemory, table)
+SERIALIZABLE(MapMemory)
 
 MapMemory::MapMemory() {}
 
+MapMemory::~MapMemory() {}
+
+int MapMemory::addToPool(ViewIndex index) {
+  auto it = pool.find(index);
+  if (it == pool.end()) {
+    int id;
+    if (!freeIds.empty()) {
+      id = freeIds.back();
+      freeIds.pop_back();
+    } else {
+      id = poolById.size();
+      poolById.push_back(nullptr);
+    }
+    it = pool.insert(make_pair(std::move(index), PoolEntry{id, 0})).first;
+    poolById[id] = &it->first;
+  }
+  ++it->second.refCount;
+  return it->second.id;
+}
+
+void MapMemory::removeFromPool(int id) {
+  auto it = pool.find(*poolById[id]);
+  if (--it->second.refCount == 0) {
+    poolById[id] = nullptr;
+    freeIds.push_back(id);
+    pool.erase(it);
+  }
+}
+
+static const GenericId furnitureIdPlaceholder = -1;
+
+ViewIndex MapMemory::toPooled(Position pos, ViewIndex index) {
+  auto furnitureId = pos.getFurnitureGenericId();
+  for (auto& obj : index.getAllObjects())
+    if (obj.getGenericId() == furnitureId)
+      obj.setGenericId(furnitureIdPlaceholder);
+  return index;
+}
+
+void MapMemory::set(Position pos, ViewIndex index) {
+  // The new index is added before the old one is removed, so that an unchanged tile keeps its pool entry.
+  int id = addToPool(std::move(index));
+  if (auto oldId = table.getValueMaybe(pos))
+    removeFromPool(*oldId);
+  table.set(pos, id);
+}
+
+int MapMemory::getPoolSize() const {
+  return pool.size();
+}
+
+long long MapMemory::getMemoryUsage() const {
+  long long ret = table.getMemoryUsage() + getNodeMemoryUsage(pool) + ::getMemoryUsage(poolById) +
+      ::getMemoryUsage(freeIds) + getNodeMemoryUsage(updated);
+  for (auto& elem : updated)
+    ret += getNodeMemoryUsage(elem.second);
+  return ret;
+}
+
 void MapMemory::addObject(Position pos, const ViewObject& obj) {
   CHECK(pos.isValid());
-  auto& index = table->getOrInit(pos);
+  ViewIndex index;
+  if (auto current = getPooled(pos))
+    index = *current;
   index.insert(obj);
   index.setHighlight(HighlightType::MEMORY);
+  set(pos, toPooled(pos, std::move(index)));
   updateUpdated(pos);
 }
 
-optional<ViewIndex&> MapMemory::getViewIndex(Position pos) {
-  return table->getReferenceMaybe(pos);
+optional<const ViewIndex&> MapMemory::getPooled(Position pos) const {
+  if (auto id = table.getValueMaybe(pos))
+    return *poolById[*id];
+  return none;
+}
+
+optional<ViewIndex> MapMemory::getViewIndex(Position pos) const {
+  if (auto pooled = getPooled(pos)) {
+    ViewIndex ret = *pooled;
+    for (auto& obj : ret.getAllObjects())
+      if (obj.getGenericId() == furnitureIdPlaceholder)
+        obj.setGenericId(pos.getFurnitureGenericId());
+    return ret;
+  }
+  return none;
 }
 
-optional<const ViewIndex&> MapMemory::getViewIndex(Position pos) const {
-  return table->getReferenceMaybe(pos);
+bool MapMemory::hasViewIndex(Position pos) const {
+  return !!table.getValueMaybe(pos);
 }
 
 void MapMemory::update(Position pos, const ViewIndex& index1) {
-  auto& index = table->getOrInit(pos);
-  index = index1;
+  ViewIndex index = toPooled(pos, index1);
   index.setHighlight(HighlightType::MEMORY);
   if (index.hasObject(ViewLayer::CREATURE) &&
       !index.getObject(ViewLayer::CREATURE).hasModifier(ViewObjectModifier::REMEMBER))
     index.removeObject(ViewLayer::CREATURE);
+  if (auto current = getPooled(pos))
+    if (*current == index)
+      return;
+  set(pos, std::move(index));
   updateUpdated(pos);
 }
 
@@ -56,7 +163,10 @@ void MapMemory::updateUpdated(Position pos) {
 }
 
 void MapMemory::clearSquare(Position pos) {
-  getViewIndex(pos) = none;
+  if (auto id = table.getValueMaybe(pos)) {
+    removeFromPool(*id);
+    table.erase(pos);
+  }
 }
 
 const MapMemory& MapMemory::empty() {
@@ -23,23 +23,46 @@
 class ViewObject;
 class ViewIndex;
 
+/* Most remembered tiles look exactly the same, so every distinct ViewIndex is stored once in a reference counted
+   pool and the tiles only keep an index into it. The furniture objects carry an id derived from the position,
+   which is replaced by a placeholder in the pool and put back by getViewIndex. */
 class MapMemory {
   public:
   MapMemory();
+  MapMemory(const MapMemory&) = delete;
+  MapMemory& operator = (const MapMemory&) = delete;
+  ~MapMemory();
   void addObject(Position, const ViewObject&);
   void update(Position, const ViewIndex&);
   const unordered_set<Position, CustomHash<Position>>& getUpdated(WConstLevel) const;
   void clearUpdated(WConstLevel) const;
   void clearSquare(Position pos);
   static const MapMemory& empty();
-  optional<const ViewIndex&> getViewIndex(Position) const;
+  optional<ViewIndex> getViewIndex(Position) const;
+  bool hasViewIndex(Position) const;
+  // Number of distinct ViewIndexes currently stored.
+  int getPoolSize() const;
+  long long getMemoryUsage() const;
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
   private:
   void updateUpdated(Position);
-  optional<ViewIndex&> getViewIndex(Position);
-  HeapAllocated<PositionMap<ViewIndex>> SERIAL(table);
+  optional<const ViewIndex&> getPooled(Position) const;
+  static ViewIndex toPooled(Position, ViewIndex);
+  void set(Position, ViewIndex);
+  int addToPool(ViewIndex);
+  void removeFromPool(int);
+  PositionMap<int> SERIAL(table);
+  struct PoolEntry {
+    int id;
+    int refCount;
+  };
+  unordered_map<ViewIndex, PoolEntry, CustomHash<ViewIndex>> pool;
+  vector<const ViewIndex*> poolById;
+  vector<int> freeIds;
   mutable map<int, PositionSet> updated;
 };
+
+CEREAL_CLASS_VERSION(MapMemory, 1);
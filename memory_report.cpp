@@ -0,0 +1,26 @@
+#include "stdafx.h"
+#include "memory_report.h"
+
+void MemoryReport::add(const string& name, long long bytes) {
+  entries.push_back(make_pair(prefix + name, bytes));
+}
+
+void MemoryReport::addGroup(const string& name, function<void()> fun) {
+  auto previous = prefix;
+  prefix += name + "/";
+  fun();
+  prefix = previous;
+}
+
+long long MemoryReport::getTotal() const {
+  long long ret = 0;
+  for (auto& entry : entries)
+    ret += entry.second;
+  return ret;
+}
+
+void MemoryReport::write(ostream& out) const {
+  for (auto& entry : entries)
+    out << entry.first << "\t" << entry.second << "\n";
+  out << "total\t" << getTotal() << "\n";
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "util.h"
+
+/* Estimated memory used by the parts of a game, gathered by walking the game state. Entries are named by the path
+   of the groups they were added in, such as "model 3,2/level 1/squares", and written one per line as
+   "<path><TAB><bytes>" in a fixed order, so that the reports of two runs can be compared with diff. A container
+   counts the memory of its elements, but not what they point to, unless the owner adds that too. */
+class MemoryReport {
+  public:
+  void add(const string& name, long long bytes);
+  // Puts the entries added by the function under the group.
+  void addGroup(const string& name, function<void()>);
+  long long getTotal() const;
+  void write(ostream&) const;
+
+  private:
+  string prefix;
+  vector<pair<string, long long>> entries;
+};
+
+template <typename T>
+long long getMemoryUsage(const vector<T>& v) {
+  return (long long) v.capacity() * sizeof(T);
+}
+
+template <typename T>
+long long getMemoryUsage(const Table<T>& t) {
+  return (long long) t.getBounds().width() * t.getBounds().height() * sizeof(T);
+}
+
+// Counts the nodes of node-based containers, such as maps and sets, plus two pointers of overhead for each.
+template <typename Container>
+long long getNodeMemoryUsage(const Container& c) {
+  return (long long) c.size() * (sizeof(typename Container::value_type) + 2 * sizeof(void*));
+}
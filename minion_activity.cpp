@@ -29,8 +29,7 @@ static bool betterPos(Position from, Position current, Position candidate) {
 
 static optional<Position> getTileToExplore(WCollective collective, const Creature* c, MinionActivity task) {
   auto& borderTiles = collective->getKnownTiles().getBorderTiles();
-  auto blockName = "get tile to explore " + toString(borderTiles.size());
-  PROFILE_BLOCK(blockName.data());
+  PROFILE_BLOCK("get tile to explore");
   auto movementType = c->getMovementType();
   optional<Position> caveTile;
   optional<Position> outdoorTile;
@@ -162,7 +161,7 @@ MinionActivities::MinionActivities(const ContentFactory* contentFactory) {
     auto& taskInfo = CollectiveConfig::getActivityInfo(minionTask);
     switch (taskInfo.type) {
       case MinionActivityInfo::ARCHERY:
-        allFurniture[minionTask].push_back(FurnitureType("ARCHERY_RANGE"));
+        allFurniture[minionTask].push_back(CONTENT_ID(FurnitureType, "ARCHERY_RANGE"));
         break;
       case MinionActivityInfo::FURNITURE:
         for (auto furnitureType : contentFactory->furniture.getAllFurnitureType())
@@ -237,7 +236,7 @@ PTask MinionActivities::generate(WCollective collective, Creature* c, MinionActi
         else
           return Task::idle();
       }
-      auto& pigstyPos = collective->getConstructions().getBuiltPositions(FurnitureType("PIGSTY"));
+      auto& pigstyPos = collective->getConstructions().getBuiltPositions(CONTENT_ID(FurnitureType, "PIGSTY"));
       if (pigstyPos.count(c->getPosition()) && !myTerritory.empty()) {
         PROFILE_BLOCK("Leave pigsty");
         return Task::doneWhen(Task::goTo(Random.choose(myTerritory)),
@@ -265,7 +264,7 @@ PTask MinionActivities::generate(WCollective collective, Creature* c, MinionActi
     }
     case MinionActivityInfo::ARCHERY: {
       PROFILE_BLOCK("Archery");
-      auto pos = collective->getConstructions().getBuiltPositions(FurnitureType("ARCHERY_RANGE"));
+      auto pos = collective->getConstructions().getBuiltPositions(CONTENT_ID(FurnitureType, "ARCHERY_RANGE"));
       if (!pos.empty())
         return Task::archeryRange(collective, tryInQuarters(vector<Position>(pos.begin(), pos.end()), collective, c));
       else
@@ -285,7 +284,7 @@ PTask MinionActivities::generate(WCollective collective, Creature* c, MinionActi
     }
     case MinionActivityInfo::EAT: {
       PROFILE_BLOCK("Eat");
-      const auto& hatchery = collective->getConstructions().getBuiltPositions(FurnitureType("PIGSTY"));
+      const auto& hatchery = collective->getConstructions().getBuiltPositions(CONTENT_ID(FurnitureType, "PIGSTY"));
       if (!hatchery.empty())
         return Task::eat(tryInQuarters(vector<Position>(hatchery.begin(), hatchery.end()), collective, c));
       break;
@@ -55,6 +55,7 @@
 #include "unknown_locations.h"
 #include "avatar_info.h"
 #include "collective_config.h"
+#include "memory_report.h"
 
 template <class Archive> 
 void Model::serialize(Archive& ar, const unsigned int version) {
@@ -89,6 +90,14 @@ int Model::getWoodCount() const {
   return woodCount;
 }
 
+void Model::onItemsChanged() {
+  ++itemsVersion;
+}
+
+int Model::getItemsVersion() const {
+  return itemsVersion;
+}
+
 int Model::getSaveProgressCount() const {
   int ret = 0;
   for (const PLevel& l : levels)
@@ -133,7 +142,7 @@ bool Model::update(double totalTime) {
     CHECK(creature->getLevel() != nullptr) << "Creature misplaced before moving: " << creature->getName().bare() <<
         ". Any idea why this happened?";
     if (!creature->isDead()) {
-      INFO << "Turn " << totalTime << " " << creature->getName().bare() << " moving now";
+      INFO_IN(CREATURES) << "Turn " << totalTime << " " << creature->getName().bare() << " moving now";
       creature->makeMove();
     }
     CHECK(creature->getLevel() != nullptr) << "Creature misplaced after moving: " << creature->getName().bare() <<
@@ -273,6 +282,16 @@ vector<WLevel> Model::getLevels() const {
   return getWeakPointers(levels);
 }
 
+void Model::addMemoryUsage(MemoryReport& report) const {
+  for (auto& level : levels)
+    report.addGroup("level " + toString(level->getUniqueId()), [&] { level->addMemoryUsage(report); });
+  if (cemetery)
+    report.addGroup("cemetery", [&] { cemetery->addMemoryUsage(report); });
+  for (int i : All(collectives))
+    report.addGroup("collective " + toString(i), [&] { collectives[i]->addMemoryUsage(report); });
+  report.add("dead creatures", getMemoryUsage(deadCreatures) + deadCreatures.size() * sizeof(Creature));
+}
+
 const vector<WLevel>& Model::getMainLevels() const {
   return mainLevels;
 }
@@ -36,6 +36,7 @@ class Options;
 class AvatarInfo;
 class GameConfig;
 class ContentFactory;
+class MemoryReport;
 
 /**
   * Main class that holds all game logic.
@@ -74,6 +75,7 @@ class Model : public OwnedObject<Model> {
   vector<Creature*> getAllCreatures() const;
   const vector<PCreature>& getDeadCreatures() const;
   vector<WLevel> getLevels() const;
+  void addMemoryUsage(MemoryReport&) const;
   const vector<WLevel>& getMainLevels() const;
   void addCollective(PCollective);
 
@@ -83,6 +85,11 @@ class Model : public OwnedObject<Model> {
   void addWoodCount(int);
   int getWoodCount() const;
 
+  // Incremented whenever items are added to or removed from a square of this model, so that summaries of
+  // stored items can be cached.
+  void onItemsChanged();
+  int getItemsVersion() const;
+
   int getSaveProgressCount() const;
 
   void killCreature(Creature* victim);
@@ -126,6 +133,7 @@ class Model : public OwnedObject<Model> {
   vector<PCreature> SERIAL(deadCreatures);
   double SERIAL(currentTime) = 0;
   int SERIAL(woodCount) = 0;
+  int itemsVersion = 0;
   optional<StairKey> getStairsBetween(WConstLevel from, WConstLevel to) const;
   map<pair<LevelId, LevelId>, StairKey> SERIAL(stairNavigation);
   bool serializationLocked = false;
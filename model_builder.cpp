@@ -348,7 +348,7 @@ PModel ModelBuilder::tryBuilding(int numTries, function<PModel()> buildFun, cons
         meter->reset();
       return buildFun();
     } catch (LevelGenException) {
-      INFO << "Retrying level gen";
+      INFO_IN(LEVEL_GEN) << "Retrying level gen";
     }
   }
   FATAL << "Couldn't generate a level: " << name;
@@ -405,6 +405,7 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
   int maxT = 0;
   int minT = 1000000;
   double sumT = 0;
+  int numLocalRetries = LevelBuilder::getNumLocalRetries();
   std::cout << name;
   for (int i : Range(numTries)) {
 #ifndef OSX // this triggers some compiler errors OSX, I don't need it there anyway.
@@ -427,7 +428,8 @@ void ModelBuilder::measureModelGen(const string& name, int numTries, function<vo
 #endif
   }
   std::cout << std::endl << numSuccess << " / " << numTries << ". MinT: " <<
-    minT << ". MaxT: " << maxT << ". AvgT: " << sumT / numTries << std::endl;
+    minT << ". MaxT: " << maxT << ". AvgT: " << sumT / numTries << ". Local retries per model: " <<
+    double(LevelBuilder::getNumLocalRetries() - numLocalRetries) / numTries << std::endl;
 }
 
 static optional<CreatureGroup> getWildlife(BiomeId id) {
@@ -479,13 +479,11 @@ class Fighter : public Behaviour {
 
   MoveInfo considerBreakingChokePoint(Creature* other) {
   PROFILE;
-    unordered_set<Position, CustomHash<Position>> myNeighbors;
-    for (auto pos : creature->getPosition().neighbors8(Random))
-      myNeighbors.insert(pos);
+    auto myNeighbors = creature->getPosition().fixedNeighbors8(Random);
     MoveInfo destroyMove = NoMove;
     bool isFriendBetween = false;
-    for (auto pos : other->getPosition().neighbors8())
-      if (myNeighbors.count(pos)) {
+    for (auto pos : other->getPosition().fixedNeighbors8())
+      if (myNeighbors.contains(pos)) {
         if (pos.canEnter(creature))
           return NoMove;
         if (auto c = pos.getCreature())
@@ -626,7 +624,7 @@ class Fighter : public Behaviour {
       return move;
     if (other->getAttributes().isBoulder())
       return NoMove;
-    INFO << creature->getName().bare() << " enemy " << other->getName().bare();
+    INFO_IN(CREATURES) << creature->getName().bare() << " enemy " << other->getName().bare();
     auto myPosition = creature->getPosition();
     Vec2 enemyDir = myPosition.getDir(other->getPosition());
     auto distance = enemyDir.length8();
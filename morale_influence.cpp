@@ -0,0 +1,38 @@
+#include "stdafx.h"
+#include "morale_influence.h"
+#include "position.h"
+#include "furniture.h"
+#include "item.h"
+#include "item_class.h"
+#include "corpse_info.h"
+#include "perf_counters.h"
+#include "memory_report.h"
+
+MoraleInfluenceCache::MoraleInfluenceCache(Rectangle bounds) : stale(bounds, true), influences(bounds) {
+}
+
+void MoraleInfluenceCache::invalidate(Vec2 pos) {
+  if (pos.inRectangle(stale.getBounds()))
+    stale[pos] = true;
+}
+
+long long MoraleInfluenceCache::getMemoryUsage() const {
+  return ::getMemoryUsage(stale) + ::getMemoryUsage(influences);
+}
+
+const MoraleInfluence& MoraleInfluenceCache::get(Position pos) {
+  auto coord = pos.getCoord();
+  auto& ret = influences[coord];
+  if (stale[coord]) {
+    PerfCounters::add(PerfCounter::MORALE_TILE_UPDATES);
+    ret = MoraleInfluence{};
+    for (auto& f : pos.getFurniture())
+      ret.luxury[ret.numLuxury++] = f->getLuxuryInfo().luxury;
+    for (auto& it : pos.getItems())
+      if (auto info = it->getCorpseInfo())
+        if (!info->isSkeleton && it->getClass() != ItemClass::FOOD)
+          ++ret.numCorpses;
+    stale[coord] = false;
+  }
+  return ret;
+}
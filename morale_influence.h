@@ -0,0 +1,29 @@
+#pragma once
+
+#include "util.h"
+#include "furniture_layer.h"
+
+class Position;
+
+/* What a tile contributes to the morale of the creatures standing on it or next to it: the luxury of every
+   piece of furniture, in layer order, and the number of corpses that haven't rotted to a skeleton yet. */
+struct MoraleInfluence {
+  std::array<double, EnumInfo<FurnitureLayer>::size> luxury = {};
+  int numLuxury = 0;
+  int numCorpses = 0;
+};
+
+/* Keeps the MoraleInfluence of every tile of a level, so that creatures don't have to look through the furniture
+   and items around them on every turn. A tile is marked as stale whenever its furniture or items change, and is
+   recomputed the next time it's read. */
+class MoraleInfluenceCache {
+  public:
+  MoraleInfluenceCache(Rectangle bounds);
+  void invalidate(Vec2);
+  const MoraleInfluence& get(Position);
+  long long getMemoryUsage() const;
+
+  private:
+  Table<bool> stale;
+  Table<MoraleInfluence> influences;
+};
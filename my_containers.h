@@ -3,6 +3,7 @@
 #include <vector>
 #include <set>
 #include <type_traits>
+#include <new>
 #include "extern/optional.h"
 #include "debug.h"
 
@@ -108,6 +109,10 @@ class vector {
     ++modCounter;
   }
 
+  int capacity() const {
+    return (int) impl.capacity();
+  }
+
   auto data() {
     return impl.data();
   }
@@ -441,6 +446,105 @@ class unordered_set : public std::unordered_set<T, Hash> {
   }
 };
 
+/* A vector with a fixed capacity that keeps its elements in place, so it never allocates. Meant for short lists
+   with a known bound that are built in hot loops, such as the neighbors of a tile. */
+template <typename T, int N>
+class StaticVector {
+  public:
+  using value_type = T;
+
+  StaticVector() {}
+
+  StaticVector(const StaticVector& other) {
+    for (auto& elem : other)
+      push_back(elem);
+  }
+
+  StaticVector& operator = (const StaticVector& other) {
+    if (this != &other) {
+      clear();
+      for (auto& elem : other)
+        push_back(elem);
+    }
+    return *this;
+  }
+
+  ~StaticVector() {
+    clear();
+  }
+
+  int size() const {
+    return num;
+  }
+
+  bool empty() const {
+    return num == 0;
+  }
+
+  static constexpr int capacity() {
+    return N;
+  }
+
+  void push_back(T t) {
+    CHECK(num < N);
+    new (getData() + num) T(std::move(t));
+    ++num;
+  }
+
+  void clear() {
+    for (int i = 0; i < num; ++i)
+      getData()[i].~T();
+    num = 0;
+  }
+
+  T& operator[] (int index) {
+    return getData()[index];
+  }
+
+  const T& operator[] (int index) const {
+    return getData()[index];
+  }
+
+  bool contains(const T& t) const {
+    for (auto& elem : *this)
+      if (elem == t)
+        return true;
+    return false;
+  }
+
+  T* begin() {
+    return getData();
+  }
+
+  T* end() {
+    return getData() + num;
+  }
+
+  const T* begin() const {
+    return getData();
+  }
+
+  const T* end() const {
+    return getData() + num;
+  }
+
+  vector<T> asVector() const {
+    return vector<T>(begin(), end());
+  }
+
+  private:
+  T* getData() {
+    return reinterpret_cast<T*>(storage);
+  }
+
+  const T* getData() const {
+    return reinterpret_cast<const T*>(storage);
+  }
+
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[N];
+  int num = 0;
+};
+
 template<class T>
 std::ostream& operator<<(std::ostream& d, const vector<T>& container){
   d << "{";
@@ -45,6 +45,7 @@ class NameGenerator {
   vector<string> getAll(NameGeneratorId);
   NameGenerator(const NameGenerator&) = delete;
   NameGenerator(NameGenerator&&) = default;
+  NameGenerator& operator = (NameGenerator&&) = default;
 
   SERIALIZATION_DECL(NameGenerator)
 
@@ -49,6 +49,7 @@ const EnumMap<OptionId, Options::Value> defaults {
   {OptionId::CURRENT_MOD, 0},
   {OptionId::ENDLESS_ENEMIES, 2},
   {OptionId::ENEMY_AGGRESSION, 1},
+  {OptionId::BACKGROUND_SIMULATION, 0},
 };
 
 const map<OptionId, string> names {
@@ -82,6 +83,7 @@ const map<OptionId, string> names {
   {OptionId::CURRENT_MOD, "Current mod"},
   {OptionId::ENDLESS_ENEMIES, "Start endless enemy waves"},
   {OptionId::ENEMY_AGGRESSION, "Enemy aggression"},
+  {OptionId::BACKGROUND_SIMULATION, "Simulate sites in the background"},
 };
 
 const map<OptionId, string> hints {
@@ -102,6 +104,8 @@ const map<OptionId, string> hints {
   {OptionId::GENERATE_MANA, "Your minions will generate mana while working in the library."},
   {OptionId::ENDLESS_ENEMIES, "Turn on recurrent enemy waves that attack your dungeon."},
   {OptionId::ENEMY_AGGRESSION, "The chance of your dungeon being attacked by enemies"},
+  {OptionId::BACKGROUND_SIMULATION, "Villains in your influence zone keep developing while you are away from their "
+    "site. Uses more CPU."},
 };
 
 const map<OptionSet, vector<OptionId>> optionSets {
@@ -156,6 +160,7 @@ Options::Type Options::getType(OptionId id) {
     case OptionId::KEEPER_SEED:
       return Options::STRING;
     case OptionId::GENERATE_MANA:
+    case OptionId::BACKGROUND_SIMULATION:
       return Options::BOOL;
     default:
       return Options::INT;
@@ -243,6 +248,7 @@ string Options::getValueString(OptionId id) {
     case OptionId::DISABLE_CURSOR:
     case OptionId::GENERATE_MANA:
     case OptionId::START_WITH_NIGHT:
+    case OptionId::BACKGROUND_SIMULATION:
       return getYesNo(value);
     case OptionId::PLAYER_NAME:
     case OptionId::KEEPER_SEED:
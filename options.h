@@ -51,7 +51,8 @@ RICH_ENUM(OptionId,
   GENERATE_MANA,
   CURRENT_MOD,
   ENDLESS_ENEMIES,
-  ENEMY_AGGRESSION
+  ENEMY_AGGRESSION,
+  BACKGROUND_SIMULATION
 );
 
 enum class OptionSet {
@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "perf_counters.h"
+
+namespace {
+
+enum class SamplePeriod { CALL, FRAME, TURN };
+
+SamplePeriod getSamplePeriod(PerfCounter c) {
+  switch (c) {
+    case PerfCounter::RENDER_TIME:
+    case PerfCounter::GAME_UPDATE_TIME:
+    case PerfCounter::BACKGROUND_SIMULATION_TIME:
+    case PerfCounter::GUI_UPDATE_TIME:
+    case PerfCounter::SAVE_TIME:
+      return SamplePeriod::CALL;
+    case PerfCounter::BACKGROUND_MOVES:
+    case PerfCounter::TILE_UPDATES:
+    case PerfCounter::VIEW_INDEX_CACHE_HITS:
+    case PerfCounter::VIEW_INDEX_CACHE_MISSES:
+    case PerfCounter::DRAW_CALLS:
+    case PerfCounter::SPRITE_VERTICES:
+    case PerfCounter::GUI_PANEL_REBUILDS:
+      return SamplePeriod::FRAME;
+    case PerfCounter::CREATURE_MOVE_TIME:
+    case PerfCounter::PATH_SEARCHES:
+    case PerfCounter::FOV_COMPUTATIONS:
+    case PerfCounter::MORALE_TILE_UPDATES:
+      return SamplePeriod::TURN;
+  }
+}
+
+struct CounterState {
+  atomic<long long> current{0};
+  std::deque<long long> history;
+};
+
+struct PerfCountersState {
+  std::mutex mutex;
+  CounterState counters[EnumInfo<PerfCounter>::size];
+};
+
+PerfCountersState& getState() {
+  static PerfCountersState state;
+  return state;
+}
+
+void addSample(CounterState& counter, long long value) {
+  counter.history.push_back(value);
+  if (counter.history.size() > PerfCounters::historySize)
+    counter.history.pop_front();
+}
+
+void endPeriod(SamplePeriod period) {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  for (auto c : ENUM_ALL(PerfCounter))
+    if (getSamplePeriod(c) == period) {
+      auto& counter = state.counters[int(c)];
+      addSample(counter, counter.current.exchange(0));
+    }
+}
+
+}
+
+void PerfCounters::add(PerfCounter c, long long value) {
+  auto& state = getState();
+  auto& counter = state.counters[int(c)];
+  if (getSamplePeriod(c) == SamplePeriod::CALL) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    addSample(counter, value);
+  } else
+    counter.current += value;
+}
+
+void PerfCounters::endFrame() {
+  endPeriod(SamplePeriod::FRAME);
+}
+
+void PerfCounters::endTurn() {
+  endPeriod(SamplePeriod::TURN);
+}
+
+vector<long long> PerfCounters::getHistory(PerfCounter c) {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  auto& history = state.counters[int(c)].history;
+  return vector<long long>(history.begin(), history.end());
+}
+
+const char* PerfCounters::getName(PerfCounter c) {
+  switch (c) {
+    case PerfCounter::RENDER_TIME: return "Render";
+    case PerfCounter::GAME_UPDATE_TIME: return "Game update";
+    case PerfCounter::BACKGROUND_SIMULATION_TIME: return "Background sites";
+    case PerfCounter::BACKGROUND_MOVES: return "Background creature moves per frame";
+    case PerfCounter::CREATURE_MOVE_TIME: return "Creature moves per turn";
+    case PerfCounter::PATH_SEARCHES: return "Path searches per turn";
+    case PerfCounter::FOV_COMPUTATIONS: return "FOV computations per turn";
+    case PerfCounter::MORALE_TILE_UPDATES: return "Morale tile updates per turn";
+    case PerfCounter::TILE_UPDATES: return "Tile updates per frame";
+    case PerfCounter::VIEW_INDEX_CACHE_HITS: return "Tile view cache hits per frame";
+    case PerfCounter::VIEW_INDEX_CACHE_MISSES: return "Tile view cache misses per frame";
+    case PerfCounter::DRAW_CALLS: return "Sprite draw calls per frame";
+    case PerfCounter::SPRITE_VERTICES: return "Sprite vertices per frame";
+    case PerfCounter::GUI_UPDATE_TIME: return "UI update";
+    case PerfCounter::GUI_PANEL_REBUILDS: return "UI panel rebuilds per frame";
+    case PerfCounter::SAVE_TIME: return "Save";
+  }
+}
+
+bool PerfCounters::isTime(PerfCounter c) {
+  switch (c) {
+    case PerfCounter::RENDER_TIME:
+    case PerfCounter::GAME_UPDATE_TIME:
+    case PerfCounter::BACKGROUND_SIMULATION_TIME:
+    case PerfCounter::CREATURE_MOVE_TIME:
+    case PerfCounter::GUI_UPDATE_TIME:
+    case PerfCounter::SAVE_TIME:
+      return true;
+    default:
+      return false;
+  }
+}
+
+PerfTimer::PerfTimer(PerfCounter c) : counter(c), begin(steady_clock::now()) {
+}
+
+PerfTimer::~PerfTimer() {
+  PerfCounters::add(counter, duration_cast<microseconds>(steady_clock::now() - begin).count());
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "util.h"
+
+RICH_ENUM(PerfCounter,
+  RENDER_TIME,
+  GAME_UPDATE_TIME,
+  BACKGROUND_SIMULATION_TIME,
+  BACKGROUND_MOVES,
+  CREATURE_MOVE_TIME,
+  PATH_SEARCHES,
+  FOV_COMPUTATIONS,
+  MORALE_TILE_UPDATES,
+  TILE_UPDATES,
+  VIEW_INDEX_CACHE_HITS,
+  VIEW_INDEX_CACHE_MISSES,
+  DRAW_CALLS,
+  SPRITE_VERTICES,
+  GUI_UPDATE_TIME,
+  GUI_PANEL_REBUILDS,
+  SAVE_TIME
+);
+
+/* Counters for the performance overlay. Values are accumulated from any thread and moved into a rolling
+   history either on every call to add(), at the end of a rendered frame or at the end of a game turn,
+   depending on the counter. Times are measured in microseconds. */
+class PerfCounters {
+  public:
+  static void add(PerfCounter, long long value = 1);
+  static void endFrame();
+  static void endTurn();
+  static vector<long long> getHistory(PerfCounter);
+  static const char* getName(PerfCounter);
+  static bool isTime(PerfCounter);
+  static const int historySize = 120;
+};
+
+class PerfTimer {
+  public:
+  PerfTimer(PerfCounter);
+  ~PerfTimer();
+
+  private:
+  PerfCounter counter;
+  steady_clock::time_point begin;
+};
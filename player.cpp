@@ -224,7 +224,7 @@ void Player::throwItem(Item* item, optional<Position> target) {
           PassableInfo::PASSABLE);
       for (auto v : passable.getBounds()) {
         Position pos(v, getLevel());
-        if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+        if (!creature->canSee(pos) && !getMemory().hasViewIndex(pos))
           passable[v] = PassableInfo::UNKNOWN;
         else if (pos.stopsProjectiles(creature->getVision().getId()))
           passable[v] = PassableInfo::NON_PASSABLE;
@@ -429,7 +429,7 @@ void Player::fireAction() {
         PassableInfo::PASSABLE);
     for (auto v : passable.getBounds()) {
       Position pos(v, getLevel());
-      if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+      if (!creature->canSee(pos) && !getMemory().hasViewIndex(pos))
         passable[v] = PassableInfo::UNKNOWN;
       else if (pos.stopsProjectiles(creature->getVision().getId()))
         passable[v] = PassableInfo::NON_PASSABLE;
@@ -454,7 +454,7 @@ void Player::spellAction(int id) {
       Table<PassableInfo> passable(Rectangle::centered(origin, range), PassableInfo::PASSABLE);
       for (auto v : passable.getBounds()) {
         Position pos(v, getLevel());
-        if (!creature->canSee(pos) && !getMemory().getViewIndex(pos))
+        if (!creature->canSee(pos) && !getMemory().hasViewIndex(pos))
           passable[v] = PassableInfo::UNKNOWN;
         if (pos.isDirEffectBlocked())
           passable[v] = PassableInfo::STOPS_HERE;
@@ -605,7 +605,7 @@ void Player::updateUnknownLocations() {
   for (auto col : getModel()->getCollectives())
     if (!col->isConquered())
       if (auto& pos = col->getTerritory().getCentralPoint())
-        if (pos->isSameLevel(getLevel()) && !getMemory().getViewIndex(*pos))
+        if (pos->isSameLevel(getLevel()) && !getMemory().hasViewIndex(*pos))
           locations.push_back(*pos);
   unknownLocations->update(locations);
 }
@@ -663,7 +663,7 @@ void Player::makeMove() {
     displayGreeting = false;
     getView()->updateView(this, false);
   }
-  UserInput action = getView()->getAction();
+  UserInput action = getGame()->getUserInput();
   if (travelling && action.getId() == UserInputId::IDLE)
     travelAction();
   else if (target && action.getId() == UserInputId::IDLE)
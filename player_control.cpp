@@ -91,6 +91,7 @@
 #include "content_factory.h"
 #include "tech_id.h"
 #include "pretty_printing.h"
+#include "debug_checks.h"
 
 template <class Archive>
 void PlayerControl::serialize(Archive& ar, const unsigned int version) {
@@ -941,7 +942,7 @@ vector<CollectiveInfo::CreatureGroup> PlayerControl::getEnemyGroups() const {
   return getCreatureGroups(enemies);
 }
 
-void PlayerControl::fillMinions(CollectiveInfo& info) const {
+vector<Creature*> PlayerControl::getMinionsForUI() const {
   vector<Creature*> minions;
   for (auto trait : {MinionTrait::FIGHTER, MinionTrait::PRISONER, MinionTrait::WORKER, MinionTrait::INCREASE_POPULATION})
     for (Creature* c : collective->getCreatures(trait))
@@ -949,6 +950,16 @@ void PlayerControl::fillMinions(CollectiveInfo& info) const {
         minions.push_back(c);
   if (auto leader = collective->getLeader())
     minions.push_back(leader);
+  return minions;
+}
+
+void PlayerControl::fillMinions(CollectiveInfo& info) const {
+  auto version = collective->getCreaturesVersion();
+  if (!minionsCache || minionsCache->version != version)
+    minionsCache = MinionsCache{version, getMinionsForUI()};
+  else if (DebugChecks::isEnabled())
+    CHECK(minionsCache->minions == getMinionsForUI()) << "Cached minion list is out of date";
+  auto& minions = minionsCache->minions;
   info.minionGroups = getCreatureGroups(minions);
   info.minions = minions.transform([](const Creature* c) { return CreatureInfo(c) ;});
   info.minionCount = collective->getPopulationSize();
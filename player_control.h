@@ -165,6 +165,12 @@ class PlayerControl : public CreatureView, public CollectiveControl, public Even
   void minionTaskAction(const TaskActionInfo&);
   void minionDragAndDrop(const CreatureDropInfo&);
   void fillMinions(CollectiveInfo&) const;
+  vector<Creature*> getMinionsForUI() const;
+  struct MinionsCache {
+    int version;
+    vector<Creature*> minions;
+  };
+  mutable optional<MinionsCache> minionsCache;
   vector<Creature*> getMinionsLike(Creature*) const;
   vector<PlayerInfo> getPlayerInfos(vector<Creature*>, UniqueEntity<Creature>::Id chosenId) const;
   void sortMinionsForUI(vector<Creature*>&) const;
@@ -16,37 +16,14 @@
 #include "stdafx.h"
 
 #include "poison_gas.h"
-#include "level.h"
 
 SERIALIZE_DEF(PoisonGas, amount)
 
-void PoisonGas::addAmount(double a) {
-  CHECK(a > 0);
-  amount = min(1., a + amount);
-}
-
-const double decrease = 0.98;
-const double spread = 0.10;
-
-void PoisonGas::tick(Position pos) {
-  PROFILE;
-  if (amount < 0.01) {
-    amount = 0;
-    return;
-  }
-  for (Position v : pos.neighbors8(Random)) {
-    if (v.canSeeThru(VisionId::NORMAL) && amount > 0 && v.getPoisonGasAmount() < amount) {
-      double transfer = pos.getDir(v).isCardinal4() ? spread : spread / 2;
-      transfer = min(amount, transfer);
-      transfer = min((amount - v.getPoisonGasAmount()) / 2, transfer);
-      amount -= transfer;
-      v.addPoisonGas(transfer);
-    }
-  }
-  amount = max(0.0, amount * decrease);
-}
-
 double PoisonGas::getAmount() const {
   return amount;
 }
 
+unordered_map<const Square*, double>& PoisonGas::getLoadedAmounts() {
+  static thread_local unordered_map<const Square*, double> ret;
+  return ret;
+}
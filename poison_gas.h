@@ -18,13 +18,15 @@
 #include "util.h"
 #include "position.h"
 
-class Level;
+class Square;
 
+// Poison gas used to be stored in every Square. This class only remains for loading older saves, the gas now lives
+// in a DiffusionField of the Level.
 class PoisonGas {
   public:
-  void addAmount(double amount);
-  void tick(Position);
   double getAmount() const;
+  // Amounts read from the squares of an older save, waiting for Level::serialize to move them to the level.
+  static unordered_map<const Square*, double>& getLoadedAmounts();
 
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
@@ -32,5 +34,3 @@ class PoisonGas {
   private:
   double SERIAL(amount) = 0;
 };
-
-
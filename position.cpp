@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include "position.h"
 #include "level.h"
+#include "diffusion_field.h"
+#include "view_index_cache.h"
+#include "morale_influence.h"
 #include "square.h"
 #include "creature.h"
 #include "item.h"
@@ -140,9 +143,13 @@ WConstSquare Position::getSquare() const {
 
 WFurniture Position::modFurniture(FurnitureLayer layer) const {
   PROFILE;
-  if (isValid())
+  if (isValid()) {
+    // The caller may change how the furniture looks.
+    if (level->viewIndexCache)
+      level->viewIndexCache->invalidate(coord);
+    updateMoraleInfluence();
     return level->furniture->getBuilt(layer).getWritable(coord);
-  else
+  } else
     return nullptr;
 }
 
@@ -287,40 +294,48 @@ void Position::globalMessage(const PlayerMessage& msg) const {
 
 vector<Position> Position::neighbors8() const {
   //PROFILE;
-  vector<Position> ret;
-  ret.reserve(8);
-  for (Vec2 v : coord.neighbors8())
-    ret.push_back(Position(v, level));
-  return ret;
+  return fixedNeighbors8().asVector();
 }
 
 vector<Position> Position::neighbors4() const {
   //PROFILE;
-  vector<Position> ret;
-  ret.reserve(4);
-  for (Vec2 v : coord.neighbors4())
-    ret.push_back(Position(v, level));
-  return ret;
+  return fixedNeighbors4().asVector();
 }
 
 vector<Position> Position::neighbors8(RandomGen& random) const {
   //PROFILE;
-  vector<Position> ret;
-  ret.reserve(8);
-  for (Vec2 v : coord.neighbors8(random))
-    ret.push_back(Position(v, level));
-  return ret;
+  return fixedNeighbors8(random).asVector();
 }
 
 vector<Position> Position::neighbors4(RandomGen& random) const {
   //PROFILE;
-  vector<Position> ret;
-  ret.reserve(4);
-  for (Vec2 v : coord.neighbors4(random))
+  return fixedNeighbors4(random).asVector();
+}
+
+template <int N>
+static StaticVector<Position, N> toPositions(const StaticVector<Vec2, N>& coords, WLevel level) {
+  StaticVector<Position, N> ret;
+  for (Vec2 v : coords)
     ret.push_back(Position(v, level));
   return ret;
 }
 
+StaticVector<Position, 8> Position::fixedNeighbors8() const {
+  return toPositions(coord.fixedNeighbors8(), level);
+}
+
+StaticVector<Position, 4> Position::fixedNeighbors4() const {
+  return toPositions(coord.fixedNeighbors4(), level);
+}
+
+StaticVector<Position, 8> Position::fixedNeighbors8(RandomGen& random) const {
+  return toPositions(coord.fixedNeighbors8(random), level);
+}
+
+StaticVector<Position, 4> Position::fixedNeighbors4(RandomGen& random) const {
+  return toPositions(coord.fixedNeighbors4(random), level);
+}
+
 vector<Position> Position::getRectangle(Rectangle rect) const {
   PROFILE;
   vector<Position> ret;
@@ -389,22 +404,49 @@ string Position::getName() const {
 void Position::getViewIndex(ViewIndex& index, const Creature* viewer) const {
   PROFILE;
   if (isValid()) {
-    getSquare()->getViewIndex(index, viewer);
+    auto& cache = level->getViewIndexCache();
+    // Traps can become visible or hidden while the tile stays the same, for example when the viewer learns to
+    // disarm them or when the owner's tribe becomes hostile.
+    auto getViewerStamp = [&] {
+      unsigned ret = 0;
+      for (auto layer : ENUM_ALL(FurnitureLayer))
+        if (auto furniture = getFurniture(layer))
+          if (!furniture->isVisibleToEveryone() && furniture->isVisibleTo(viewer))
+            ret |= 1u << int(layer);
+      return ret;
+    };
+    if (auto cached = cache.get(coord, viewer, getViewerStamp))
+      index = *cached;
+    else {
+      getSquare()->getViewIndex(index);
+      bool dependsOnViewer = false;
+      for (auto furniture : getFurniture()) {
+        dependsOnViewer |= !furniture->isVisibleToEveryone();
+        if (furniture->isVisibleTo(viewer) && furniture->getViewObject()) {
+          auto obj = *furniture->getViewObject();
+          obj.setGenericId(getFurnitureGenericId());
+          index.insert(std::move(obj));
+        }
+      }
+      if (index.noObjects())
+        index.insert(ViewObject(CONTENT_ID(ViewId, "empty"), ViewLayer::FLOOR_BACKGROUND));
+      cache.set(coord, viewer, dependsOnViewer ? optional<unsigned>(getViewerStamp()) : none, index);
+    }
+    // Gas spreads every turn without marking the tiles as changed, so it's never cached.
+    auto poisonGas = level->poisonGas->get(coord);
+    if (poisonGas > 0)
+      index.setGradient(GradientType::POISON_GAS, min(1.0f, poisonGas));
     if (isUnavailable())
       index.setHighlight(HighlightType::UNAVAILABLE);
     if (isCovered() > 0)
       index.setHighlight(HighlightType::INDOORS);
-    for (auto furniture : getFurniture())
-      if (furniture->isVisibleTo(viewer) && furniture->getViewObject()) {
-        auto obj = *furniture->getViewObject();
-        obj.setGenericId(level->getUniqueId() + coord.x * 2000 + coord.y);
-        index.insert(std::move(obj));
-      }
-    if (index.noObjects())
-      index.insert(ViewObject(ViewId("empty"), ViewLayer::FLOOR_BACKGROUND));
   }
 }
 
+GenericId Position::getFurnitureGenericId() const {
+  return level->getUniqueId() + coord.x * 2000 + coord.y;
+}
+
 const vector<Item*>& Position::getItems() const {
   PROFILE;
   if (isValid())
@@ -561,6 +603,7 @@ void Position::addFurnitureImpl(PFurniture f) const {
   level->addLightSource(coord, furniture->getLightEmission());
   updateSupportViewId(furniture);
   setNeedsRenderAndMemoryUpdate(true);
+  updateMoraleInfluence();
   if (auto& effect = furniture->getLastingEffectInfo())
     addFurnitureEffect(furniture->getTribe(), *effect);
 }
@@ -620,6 +663,18 @@ void Position::removeCreatureLight(bool darkness) {
   }
 }
 
+const MoraleInfluence& Position::getMoraleInfluence() const {
+  static const MoraleInfluence empty;
+  if (!isValid())
+    return empty;
+  return level->getMoraleInfluenceCache().get(*this);
+}
+
+void Position::updateMoraleInfluence() const {
+  if (isValid() && level->moraleInfluenceCache)
+    level->moraleInfluenceCache->invalidate(coord);
+}
+
 void Position::removeFurniture(FurnitureLayer layer) const {
   if (auto f = getFurniture(layer))
     removeFurniture(f);
@@ -656,6 +711,7 @@ void Position::removeFurniture(WConstFurniture f, PFurniture replace) const {
       replacePtr->onEnter(c);
   }
   setNeedsRenderAndMemoryUpdate(true);
+  updateMoraleInfluence();
 }
 
 bool Position::canConstruct(FurnitureType type) const {
@@ -803,7 +859,7 @@ ViewId Position::getTopViewId() const {
     if (auto furniture = getFurniture(layer))
       if (auto& obj = furniture->getViewObject())
         return obj->id();
-  return ViewId("empty");
+  return CONTENT_ID(ViewId, "empty");
 }
 
 void Position::forbidMovementForTribe(TribeId t) {
@@ -841,14 +897,16 @@ vector<Position> Position::getVisibleTiles(const Vision& vision) {
 
 void Position::addPoisonGas(double amount) {
   PROFILE;
-  if (isValid())
-    modSquare()->addPoisonGas(*this, amount);
+  if (isValid() && canSeeThru(VisionId::NORMAL)) {
+    level->poisonGas->add(coord, amount);
+    setNeedsRenderAndMemoryUpdate(true);
+  }
 }
 
 double Position::getPoisonGasAmount() const {
   PROFILE;
   if (isValid())
-    return getSquare()->getPoisonGasAmount();
+    return level->poisonGas->get(coord);
   else
     return 0;
 }
@@ -1016,7 +1074,7 @@ double Position::getNavigationCost(const MovementType& movement, const Sectors&
   }
   if (auto destroyAction = getBestDestroyAction(movement))
     return 1.0 + *getFurniture(FurnitureLayer::MIDDLE)->getStrength(*destroyAction) / 10;
-  if (movement.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (movement.canBuildBridge() && canConstruct(CONTENT_ID(FurnitureType, "BRIDGE")) &&
       !movement.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return 10;
   return ShortestPath::infinity;
@@ -1034,7 +1092,7 @@ bool Position::canNavigateCalc(const MovementType& type) const {
     for (DestroyAction action : type.getDestroyActions())
       if (furniture->canDestroy(type, action))
         ignore = FurnitureLayer::MIDDLE;
-  if (type.canBuildBridge() && canConstruct(FurnitureType("BRIDGE")) &&
+  if (type.canBuildBridge() && canConstruct(CONTENT_ID(FurnitureType, "BRIDGE")) &&
       !type.isCompatible(getFurniture(FurnitureLayer::GROUND)->getTribe()))
     return true;
   return canEnterEmptyCalc(type, ignore);
@@ -1067,7 +1125,7 @@ bool Position::isVisibleBy(const Creature* c) const {
 void Position::clearItemIndex(ItemIndex index) const {
   PROFILE;
   if (isValid())
-    modSquare()->clearItemIndex(index);
+    modSquare()->clearItemIndex(*this, index);
 }
 
 bool Position::isChokePoint(const MovementType& movement) const {
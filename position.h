@@ -18,6 +18,7 @@ class Sound;
 class Fire;
 class DestroyAction;
 class Inventory;
+struct MoraleInfluence;
 class Vision;
 class Sectors;
 class FurnitureEffectInfo;
@@ -58,6 +59,11 @@ class Position {
   vector<Position> neighbors4() const;
   vector<Position> neighbors8(RandomGen&) const;
   vector<Position> neighbors4(RandomGen&) const;
+  // Same as above, but without allocating.
+  StaticVector<Position, 8> fixedNeighbors8() const;
+  StaticVector<Position, 4> fixedNeighbors4() const;
+  StaticVector<Position, 8> fixedNeighbors8(RandomGen&) const;
+  StaticVector<Position, 4> fixedNeighbors4(RandomGen&) const;
   vector<Position> getRectangle(Rectangle) const;
   void addCreature(PCreature, TimeInterval delay);
   // will crash if it's not possible to place creature here
@@ -73,6 +79,8 @@ class Position {
   optional<FurnitureClickType> getClickType() const;
   void addSound(const Sound&) const;
   void getViewIndex(ViewIndex&, const Creature* viewer) const;
+  // The id given to the view objects of the furniture on this tile.
+  GenericId getFurnitureGenericId() const;
   const vector<Item*>& getItems() const;
   const vector<Item*>& getItems(ItemIndex) const;
   PItem removeItem(Item*) const;
@@ -121,6 +129,9 @@ class Position {
   vector<Position> getVisibleTiles(const Vision&);
   void updateConnectivity() const;
   void updateVisibility() const;
+  const MoraleInfluence& getMoraleInfluence() const;
+  // Call when something that affects the morale of nearby creatures changes on this tile.
+  void updateMoraleInfluence() const;
   bool canSeeThru(VisionId) const;
   bool stopsProjectiles(VisionId) const;
   bool isVisibleBy(const Creature*) const;
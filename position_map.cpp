@@ -9,6 +9,7 @@
 #include "furniture_layer.h"
 #include "construction_map.h"
 #include "zones.h"
+#include "memory_report.h"
 
 template <typename T>
 static optional<T&> getReferenceOptional(optional<T>& t) {
@@ -143,8 +144,7 @@ void PositionMap<T>::erase(Position pos) {
     if (pos.getCoord().inRectangle(table->getBounds()))
       (*table)[pos.getCoord()] = none;
   if (auto out = ::getReferenceMaybe(outliers, levelId))
-    if (auto elem = ::getReferenceMaybe(*out, pos.getCoord()))
-      elem = none;
+    out->erase(pos.getCoord());
 
 }
 
@@ -161,6 +161,16 @@ void PositionMap<T>::limitToModel(const WModel m) {
       outliers.erase(elem.first);
 }
 
+template <class T>
+long long PositionMap<T>::getMemoryUsage() const {
+  long long ret = getNodeMemoryUsage(tables) + getNodeMemoryUsage(outliers);
+  for (auto& table : tables)
+    ret += ::getMemoryUsage(table.second);
+  for (auto& level : outliers)
+    ret += getNodeMemoryUsage(level.second);
+  return ret;
+}
+
 template <class T>
 template <class Archive> 
 void PositionMap<T>::serialize(Archive& ar, const unsigned int version) {
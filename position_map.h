@@ -18,10 +18,28 @@ class PositionMap {
   void set(Position, const T&);
   void erase(Position);
   void limitToModel(const WModel);
+  long long getMemoryUsage() const;
+
+  template <typename U, typename Fun>
+  PositionMap<U> transform(Fun f) const {
+    PositionMap<U> ret;
+    for (auto& table : tables) {
+      auto& retTable = ret.tables.insert(make_pair(table.first, Table<optional<U>>(table.second.getBounds()))).first->second;
+      for (auto v : table.second.getBounds())
+        if (auto& elem = table.second[v])
+          retTable[v] = f(*elem);
+    }
+    for (auto& level : outliers)
+      for (auto& elem : level.second)
+        ret.outliers[level.first].insert(make_pair(elem.first, f(elem.second)));
+    return ret;
+  }
 
   SERIALIZATION_DECL(PositionMap);
 
   private:
+  template <typename>
+  friend class PositionMap;
   Table<optional<T>>& getTable(Position);
   map<LevelId, Table<optional<T>>> SERIAL(tables);
   map<LevelId, map<Vec2, T>> SERIAL(outliers);
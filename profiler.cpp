@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "util.h"
+#include "profiler.h"
+
+#ifndef EASY_PROFILER
+
+atomic<bool> Profiler::enabled(false);
+
+namespace {
+
+struct ProfilerEvent {
+  const char* name;
+  long long begin;
+  long long end;
+  int depth;
+};
+
+// Written only by its owning thread. Readers use writeIndex to find the entries that are safe to read.
+struct ThreadBuffer {
+  static constexpr int capacity = 1 << 16;
+  ThreadBuffer(int index) : events(capacity), threadIndex(index) {}
+  std::vector<ProfilerEvent> events;
+  atomic<long long> writeIndex{0};
+  long long frameStart = 0;
+  int depth = 0;
+  const int threadIndex;
+};
+
+struct CallTreeNode {
+  long long totalTime = 0;
+  long long maxFrameTime = 0;
+  long long frameTime = 0;
+  int count = 0;
+  map<string, unique_ptr<CallTreeNode>> children;
+};
+
+struct ProfilerState {
+  std::mutex mutex;
+  vector<shared_ptr<ThreadBuffer>> threads;
+  CallTreeNode callTree;
+  int numFrames = 0;
+  const steady_clock::time_point startTime = steady_clock::now();
+};
+
+ProfilerState& getState() {
+  static ProfilerState state;
+  return state;
+}
+
+long long getTimeNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - getState().startTime).count();
+}
+
+ThreadBuffer& getThreadBuffer() {
+  thread_local shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    buffer = make_shared<ThreadBuffer>(state.threads.size());
+    state.threads.push_back(buffer);
+  }
+  return *buffer;
+}
+
+std::vector<ProfilerEvent> getEvents(const ThreadBuffer& buffer, long long from) {
+  long long to = buffer.writeIndex.load(std::memory_order_acquire);
+  from = max(from, to - ThreadBuffer::capacity);
+  std::vector<ProfilerEvent> ret;
+  ret.reserve(to - from);
+  for (long long i = from; i < to; ++i)
+    ret.push_back(buffer.events[i % ThreadBuffer::capacity]);
+  // Drop the events that the owning thread overwrote while they were being copied.
+  long long overwritten = buffer.writeIndex.load(std::memory_order_acquire) - ThreadBuffer::capacity - from;
+  if (overwritten > 0)
+    ret.erase(ret.begin(), ret.begin() + min<long long>(overwritten, ret.size()));
+  return ret;
+}
+
+void finishFrame(CallTreeNode& node) {
+  node.maxFrameTime = max(node.maxFrameTime, node.frameTime);
+  node.frameTime = 0;
+  for (auto& child : node.children)
+    finishFrame(*child.second);
+}
+
+void printNode(ostream& out, const string& name, const CallTreeNode& node, long long parentTime, int numFrames,
+    int indent) {
+  out << string(indent * 2, ' ') << name << ": " << node.count << " calls, "
+      << double(node.totalTime) / 1000000 << " ms total, "
+      << double(node.totalTime) / 1000000 / max(1, numFrames) << " ms per frame, "
+      << double(node.maxFrameTime) / 1000000 << " ms max frame";
+  if (parentTime > 0)
+    out << ", " << 100 * node.totalTime / parentTime << "% of parent";
+  out << "\n";
+  vector<pair<string, const CallTreeNode*>> children;
+  for (auto& child : node.children)
+    children.push_back(make_pair(child.first, child.second.get()));
+  sort(children.begin(), children.end(),
+      [](const auto& c1, const auto& c2) { return c1.second->totalTime > c2.second->totalTime; });
+  for (auto& child : children)
+    printNode(out, child.first, *child.second, node.totalTime, numFrames, indent + 1);
+}
+
+void writeJsonString(ostream& out, const char* s) {
+  out << '"';
+  for (; *s; ++s)
+    switch (*s) {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      default:
+        if (*s >= 0 && *s < 0x20)
+          out << ' ';
+        else
+          out << *s;
+        break;
+    }
+  out << '"';
+}
+
+}
+
+void Profiler::setEnabled(bool e) {
+  enabled.store(e, std::memory_order_relaxed);
+}
+
+void Profiler::clear() {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.callTree = CallTreeNode();
+  state.numFrames = 0;
+  for (auto& buffer : state.threads)
+    buffer->frameStart = buffer->writeIndex.load();
+}
+
+void Profiler::Scope::begin(const char* n) {
+  name = n;
+  ++getThreadBuffer().depth;
+  beginTime = getTimeNanos();
+}
+
+void Profiler::Scope::end() {
+  auto endTime = getTimeNanos();
+  auto& buffer = getThreadBuffer();
+  --buffer.depth;
+  auto index = buffer.writeIndex.load(std::memory_order_relaxed);
+  buffer.events[index % ThreadBuffer::capacity] = ProfilerEvent{name, beginTime, endTime, buffer.depth};
+  buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame() {
+  if (!isEnabled())
+    return;
+  auto& buffer = getThreadBuffer();
+  auto events = getEvents(buffer, buffer.frameStart);
+  buffer.frameStart = buffer.writeIndex.load(std::memory_order_relaxed);
+  // Events are recorded when a scope finishes, so parents come after their children.
+  sort(events.begin(), events.end(), [](const ProfilerEvent& e1, const ProfilerEvent& e2) {
+      return e1.begin < e2.begin || (e1.begin == e2.begin && e1.depth < e2.depth); });
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  vector<pair<CallTreeNode*, int>> stack;
+  for (auto& event : events) {
+    while (!stack.empty() && stack.back().second >= event.depth)
+      stack.pop_back();
+    auto& parent = stack.empty() ? state.callTree : *stack.back().first;
+    auto& node = parent.children[event.name];
+    if (!node)
+      node = unique<CallTreeNode>();
+    auto time = event.end - event.begin;
+    node->totalTime += time;
+    node->frameTime += time;
+    ++node->count;
+    if (stack.empty())
+      state.callTree.totalTime += time;
+    stack.push_back(make_pair(node.get(), event.depth));
+  }
+  finishFrame(state.callTree);
+  ++state.numFrames;
+}
+
+string Profiler::getCallTreeReport() {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  stringstream ss;
+  ss << state.numFrames << " frames\n";
+  printNode(ss, "All", state.callTree, 0, state.numFrames, 0);
+  return ss.str();
+}
+
+void Profiler::writeChromeTrace(ostream& out) {
+  auto& state = getState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  out << "{\"traceEvents\":[\n";
+  bool first = true;
+  for (auto& buffer : state.threads)
+    for (auto& event : getEvents(*buffer, 0)) {
+      if (!first)
+        out << ",\n";
+      first = false;
+      out << "{\"name\":";
+      writeJsonString(out, event.name);
+      out << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadIndex
+          << ",\"ts\":" << double(event.begin) / 1000 << ",\"dur\":" << double(event.end - event.begin) / 1000 << "}";
+    }
+  out << "\n]}\n";
+}
+
+void Profiler::dumpToFiles() {
+  ofstream trace("profile.json");
+  writeChromeTrace(trace);
+  ofstream("profile.txt") << getCallTreeReport();
+}
+
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util.h"
+#include "memory_report.h"
 
 template <typename Type, typename Param>
 class ReadWriteArray {
@@ -52,6 +53,24 @@ class ReadWriteArray {
     readonly[pos] = -1;
   }
 
+  // Describes what is stored at one position. Elements are never removed from the array, so setting a previously
+  // saved state brings back the element it referred to.
+  struct ElemState {
+    short modified;
+    short readonly;
+    optional<Param> type;
+  };
+
+  ElemState getElemState(Vec2 pos) const {
+    return ElemState{modified[pos], readonly[pos], types[pos]};
+  }
+
+  void setElemState(Vec2 pos, const ElemState& state) {
+    modified[pos] = state.modified;
+    readonly[pos] = state.readonly;
+    types[pos] = state.type;
+  }
+
   void clearElem(Vec2 pos) {
     types[pos] = none;
     modified[pos] = -1;
@@ -66,6 +85,12 @@ class ReadWriteArray {
     return 0;
   }
 
+  long long getMemoryUsage() const {
+    return (allModified.size() + allReadonly.size()) * sizeof(Type) + ::getMemoryUsage(allModified) +
+        ::getMemoryUsage(allReadonly) + ::getMemoryUsage(modified) + ::getMemoryUsage(readonly) +
+        ::getMemoryUsage(types) + getNodeMemoryUsage(readonlyMap);
+  }
+
   SERIALIZE_ALL(modified, allModified, allReadonly, readonly, types, readonlyMap, numTotal)
   SERIALIZATION_CONSTRUCTOR(ReadWriteArray)
 
@@ -25,58 +25,36 @@
 #include "clock.h"
 #include "gzstream.h"
 #include "opengl.h"
+#include "perf_counters.h"
 #include "tileset.h"
 
 void Renderer::renderDeferredSprites() {
-  static vector<SDL::GLfloat> vertices;
-  static vector<SDL::GLfloat> texCoords;
-  static vector<SDL::GLfloat> colors;
-  vertices.clear();
-  texCoords.clear();
-  colors.clear();
-  auto addVertex = [&](Vec2 v, int texX, int texY, Vec2 texSize, Color color) {
-    vertices.push_back(v.x);
-    vertices.push_back(v.y);
-    texCoords.push_back(((float)texX) / texSize.x);
-    texCoords.push_back(((float)texY) / texSize.y);
-    colors.push_back(((float) color.r) / 255);
-    colors.push_back(((float) color.g) / 255);
-    colors.push_back(((float) color.b) / 255);
-    colors.push_back(((float) color.a) / 255);
-  };
-  for (auto& elem : deferredSprites) {
-    auto add = [&](Vec2 v, int texX, int texY, const DeferredSprite& draw) {
-      addVertex(v, texX, texY, draw.realSize, draw.color.value_or(Color::WHITE));
-    };
-    add(elem.a, elem.p.x, elem.p.y, elem);
-    add(elem.b, elem.k.x, elem.p.y, elem);
-    add(elem.c, elem.k.x, elem.k.y, elem);
-    add(elem.a, elem.p.x, elem.p.y, elem);
-    add(elem.c, elem.k.x, elem.k.y, elem);
-    add(elem.d, elem.p.x, elem.k.y, elem);
-  }
-  if (!vertices.empty()) {
-    CHECK_OPENGL_ERROR();
-    SDL::glBindTexture(GL_TEXTURE_2D, *currentTexture);
-    SDL::glEnable(GL_TEXTURE_2D);
-    SDL::glEnableClientState(GL_VERTEX_ARRAY);
-    SDL::glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    SDL::glEnableClientState(GL_COLOR_ARRAY);
-    SDL::glColorPointer(4, GL_FLOAT, 0, colors.data());
-    SDL::glVertexPointer(2, GL_FLOAT, 0, vertices.data());
-    SDL::glTexCoordPointer(2, GL_FLOAT, 0, texCoords.data());
-    SDL::glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 2);
-    vertices.clear();
-    texCoords.clear();
-    colors.clear();
-
-    SDL::glDisableClientState(GL_VERTEX_ARRAY);
-    SDL::glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    SDL::glDisableClientState(GL_COLOR_ARRAY);
-    SDL::glDisable(GL_TEXTURE_2D);
-    CHECK_OPENGL_ERROR();
+  if (spriteBatcher.isEmpty())
+    return;
+  spriteBatcher.finish();
+  auto& vertices = spriteBatcher.getVertices();
+  auto& batches = spriteBatcher.getBatches();
+  PerfCounters::add(PerfCounter::DRAW_CALLS, batches.size());
+  PerfCounters::add(PerfCounter::SPRITE_VERTICES, vertices.size());
+  CHECK_OPENGL_ERROR();
+  SDL::glEnable(GL_TEXTURE_2D);
+  SDL::glEnableClientState(GL_VERTEX_ARRAY);
+  SDL::glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  SDL::glEnableClientState(GL_COLOR_ARRAY);
+  const int stride = sizeof(SpriteBatcher::Vertex);
+  SDL::glVertexPointer(2, GL_FLOAT, stride, &vertices[0].x);
+  SDL::glTexCoordPointer(2, GL_FLOAT, stride, &vertices[0].u);
+  SDL::glColorPointer(4, GL_FLOAT, stride, &vertices[0].r);
+  for (auto& batch : batches) {
+    SDL::glBindTexture(GL_TEXTURE_2D, batch.texture);
+    SDL::glDrawArrays(GL_TRIANGLES, batch.firstVertex, batch.numVertices);
   }
-  deferredSprites.clear();
+  SDL::glDisableClientState(GL_VERTEX_ARRAY);
+  SDL::glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  SDL::glDisableClientState(GL_COLOR_ARRAY);
+  SDL::glDisable(GL_TEXTURE_2D);
+  CHECK_OPENGL_ERROR();
+  spriteBatcher.clear();
 }
 
 void Renderer::drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2 p, Vec2 k, optional<Color> color) {
@@ -84,11 +62,8 @@ void Renderer::drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2
 }
 
 void Renderer::drawSprite(const Texture& t, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, optional<Color> color) {
-  if (currentTexture && currentTexture != t.getTexId())
-    renderDeferredSprites();
-  currentTexture = t.getTexId();
-  CHECK(currentTexture);
-  deferredSprites.push_back({a, b, c, d, p, k, t.getRealSize(), color});
+  CHECK(t.getTexId());
+  spriteBatcher.add(*t.getTexId(), a, b, c, d, p, k, t.getRealSize(), color.value_or(Color::WHITE));
 }
 
 static float sizeConv(int size) {
@@ -452,7 +427,7 @@ void Renderer::drawTile(Vec2 pos, const vector<TileCoord>& coords, Vec2 size, Co
     Vec2 tileSize = scale ? coord.size * *scale : coord.size.mult(size) / nominalSize;
     if (coord.size.y > nominalSize)
       off.y *= 2;
-    drawSprite(pos + off, coord.pos.mult(coord.size), coord.size, *coord.texture, tileSize, color, orientation);
+    drawSprite(pos + off, coord.pos, coord.size, *coord.texture, tileSize, color, orientation);
   };
   if (secondColor && coords.size() > 1) {
     drawCoord(coords[0], color);
@@ -566,9 +541,9 @@ void Renderer::considerMouseMoveEvent(Event& ev) {
 bool Renderer::pollEvent(Event& ev) {
   CHECK(currentThreadId() == *renderThreadId);
   if (monkey) {
-    if (Random.roll(2))
+    if (random.roll(2))
       return pollEventOrFromQueue(ev);
-    ev = SdlEventGenerator::getRandom(Random, getSize());
+    ev = SdlEventGenerator::getRandom(random, getSize());
     return true;
   } else
     return pollEventOrFromQueue(ev);
@@ -607,7 +582,7 @@ void Renderer::zoomMousePos(Event& ev) {
 
 void Renderer::waitEvent(Event& ev) {
   if (monkey) {
-    ev = SdlEventGenerator::getRandom(Random, getSize());
+    ev = SdlEventGenerator::getRandom(random, getSize());
     return;
   } else {
     if (!eventQueue.empty()) {
@@ -623,7 +598,7 @@ void Renderer::waitEvent(Event& ev) {
 
 Vec2 Renderer::getMousePos() {
   if (monkey)
-    return Vec2(Random.get(getSize().x), Random.get(getSize().y));
+    return Vec2(random.get(getSize().x), random.get(getSize().y));
   else
     return mousePos;
 }
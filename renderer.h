@@ -22,6 +22,7 @@
 #include "animation_id.h"
 #include "color.h"
 #include "texture.h"
+#include "sprite_batcher.h"
 
 enum class SpriteId {
   BUILDINGS,
@@ -140,6 +141,8 @@ class Renderer {
   SDL::SDL_Window* window;
   int width, height;
   bool monkey = false;
+  // Used only on the render thread, so that the UI doesn't take numbers from the game's Random.
+  RandomGen random;
   deque<Event> eventQueue;
   bool genReleaseEvent = false;
   Vec2 mousePos;
@@ -163,16 +166,9 @@ class Renderer {
   SDL::SDL_Cursor* cursor;
   SDL::SDL_Cursor* cursorClicked;
   SDL::SDL_Surface* loadScaledSurface(const FilePath& path, double scale);
-  optional<SDL::GLuint> currentTexture;
   void drawSprite(const Texture& t, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, optional<Color> color);
   void drawSprite(const Texture& t, Vec2 topLeft, Vec2 bottomRight, Vec2 p, Vec2 k, optional<Color> color);
-  struct DeferredSprite {
-    Vec2 a, b, c, d;
-    Vec2 p, k;
-    Vec2 realSize;
-    optional<Color> color;
-  };
-  vector<DeferredSprite> deferredSprites;
+  SpriteBatcher spriteBatcher;
   vector<Rectangle> scissorStack;
   void loadTilesFromDir(const DirectoryPath&, Vec2 size, int setWidth);
   struct TileDirectory {
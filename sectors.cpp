@@ -17,6 +17,7 @@
 #include "sectors.h"
 #include "level.h"
 #include <limits>
+#include "memory_report.h"
 
 Sectors::Sectors(Rectangle b, ExtraConnections con) : bounds(b), sectors(bounds, -1), extraConnections(std::move(con)) {
 }
@@ -88,7 +89,7 @@ void Sectors::join(Vec2 pos1, SectorId sector) {
   }
 }
 
-static DirtyTable<int> bfsTable(Level::getMaxBounds(), -1);
+static thread_local DirtyTable<int> bfsTable(Level::getMaxBounds(), -1);
 
 vector<Vec2> Sectors::getDisjoint(Vec2 pos) const {
   vector<queue<Vec2>> queues;
@@ -139,8 +140,10 @@ bool Sectors::isChokePoint(Vec2 pos) const {
   return !getDisjoint(pos).empty();
 }
 
-vector<Vec2> Sectors::getNeighbors(Vec2 pos) const {
-  auto ret = pos.neighbors8();
+StaticVector<Vec2, 9> Sectors::getNeighbors(Vec2 pos) const {
+  StaticVector<Vec2, 9> ret;
+  for (Vec2 v : pos.fixedNeighbors8())
+    ret.push_back(v);
   if (auto con = extraConnections[pos])
     ret.push_back(*con);
   return ret;
@@ -173,6 +176,10 @@ const Sectors::ExtraConnections Sectors::getExtraConnections() const {
   return extraConnections;
 }
 
+long long Sectors::getMemoryUsage() const {
+  return ::getMemoryUsage(sectors) + ::getMemoryUsage(sizes) + ::getMemoryUsage(extraConnections);
+}
+
 bool Sectors::remove(Vec2 pos) {
   if (!contains(pos))
     return false;
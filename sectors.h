@@ -32,10 +32,11 @@ class Sectors {
   void addExtraConnection(Vec2, Vec2);
   void removeExtraConnection(Vec2, Vec2);
   const ExtraConnections getExtraConnections() const;
+  long long getMemoryUsage() const;
 
   private:
   using SectorId = short;
-  vector<Vec2> getNeighbors(Vec2) const;
+  StaticVector<Vec2, 9> getNeighbors(Vec2) const;
   void setSector(Vec2, SectorId);
   SectorId getNewSector();
   void join(Vec2, SectorId);
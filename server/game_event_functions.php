@@ -0,0 +1,55 @@
+<?php
+
+include 'db.php';
+
+function addRetiredConquered($gameId, $retired_id, $player_name) {
+  global $conn;
+  $sql = $conn->prepare("INSERT INTO event_retired_conquered (game_id, retired_id, player_name) VALUES (?, ?, ?)");
+  $sql->bind_param("sss", $gameId, $retired_id, $player_name);
+  executeSql($sql, $conn);
+}
+
+function addRetiredLoaded($gameId, $retired_id, $player_name) {
+  global $conn;
+  $sql = $conn->prepare("INSERT INTO event_retired_loaded (game_id, retired_id, player_name) VALUES (?, ?, ?)");
+  $sql->bind_param("sss", $gameId, $retired_id, $player_name);
+  executeSql($sql, $conn);
+}
+
+function addTurn($params) {
+  global $conn;
+  $sql = $conn->prepare("INSERT INTO event_turn (game_id, turn) VALUES (?, ?)");
+  $sql->bind_param("si", $params["gameId"], $params["turn"]);
+  executeSql($sql, $conn);
+}
+
+function addCampaignStarted($params) {
+  global $conn;
+  $sql = $conn->prepare("INSERT INTO event_campaign_started (game_id, main, lesser, allies, retired, install_id, game_type, player_role, current_mod, version) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+  $sql->bind_param("siiiisssss", $params["gameId"], $params["main"], $params["lesser"], $params["allies"],
+      $params["retired"], $params["installId"], $params["game_type"], $params["player_role"], $params["current_mod"], $params["version"]);
+  executeSql($sql, $conn);
+}
+
+function addMessage($params) {
+  global $conn;
+  $sql = $conn->prepare("INSERT INTO event_message (game_id, board_id, author, text) VALUES (?, ?, ?, ?)");
+  $sql->bind_param("siss", $params["gameId"], $params["boardId"], $params["author"], $params["text"]);
+  executeSql($sql, $conn);
+}
+
+function addGameEvent($params) {
+  $eventType = $params["eventType"];
+  if ($eventType == "retiredConquered")
+    addRetiredConquered($params["gameId"], $params["retiredId"], $params["playerName"]);
+  if ($eventType == "retiredLoaded")
+    addRetiredLoaded($params["gameId"], $params["retiredId"], $params["playerName"]);
+  if ($eventType == "turn")
+    addTurn($params);
+  if ($eventType == "boardMessage")
+    addMessage($params);
+  if ($eventType == "campaignStarted")
+    addCampaignStarted($params);
+}
+
+?>
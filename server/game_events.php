@@ -0,0 +1,25 @@
+<?php
+
+// Receives a batch of game events. The request body is compressed with zlib and contains one event per line,
+// encoded the same way as the parameters posted to game_event.php.
+
+include 'game_event_functions.php';
+
+$lines = gzuncompress(file_get_contents("php://input"));
+if ($lines === false) {
+  http_response_code(400);
+  die("Bad batch");
+}
+$conn = getDBConn();
+$count = 0;
+foreach (explode("\n", $lines) as $line) {
+  if ($line == "")
+    continue;
+  parse_str($line, $params);
+  addGameEvent($params);
+  $count++;
+}
+$conn->close();
+// The game only removes the events from its spool after seeing this.
+echo "OK " . $count;
+?>
@@ -0,0 +1,50 @@
+<?php
+
+// Stands in for game_event.php and game_events.php when testing the game's uploads without a database.
+// Run it with PHP's built-in server:
+//   STAND_IN_FAILURES=3 php -S localhost:8000 server/stand_in.php
+// and point upload_url in appconfig-dev.txt at http://localhost:8000, or run keeper with
+// --event_upload_test http://localhost:8000. Every received event is appended to stand_in_events.txt.
+// If STAND_IN_FAILURES is set to n then every n-th request fails, to exercise the retries.
+
+function logEvent($params) {
+  file_put_contents("stand_in_events.txt", http_build_query($params) . "\n", FILE_APPEND);
+}
+
+function shouldFail() {
+  $every = intval(getenv("STAND_IN_FAILURES"));
+  if ($every <= 0)
+    return false;
+  $count = intval(@file_get_contents("stand_in_requests.txt")) + 1;
+  file_put_contents("stand_in_requests.txt", $count);
+  return $count % $every == 0;
+}
+
+$path = parse_url($_SERVER["REQUEST_URI"], PHP_URL_PATH);
+
+if (shouldFail()) {
+  http_response_code(503);
+  die("Simulated failure");
+}
+
+if ($path == "/game_event.php") {
+  logEvent($_POST);
+} else if ($path == "/game_events.php") {
+  $lines = gzuncompress(file_get_contents("php://input"));
+  if ($lines === false) {
+    http_response_code(400);
+    die("Bad batch");
+  }
+  $count = 0;
+  foreach (explode("\n", $lines) as $line) {
+    if ($line == "")
+      continue;
+    parse_str($line, $params);
+    logEvent($params);
+    $count++;
+  }
+  echo "OK " . $count;
+} else {
+  http_response_code(404);
+}
+?>
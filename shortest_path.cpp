@@ -21,6 +21,7 @@
 #include "lasting_effect.h"
 #include "furniture.h"
 #include "furniture_usage.h"
+#include "perf_counters.h"
 
 SERIALIZE_DEF(ShortestPath, path, target, bounds, reversed)
 SERIALIZATION_CONSTRUCTOR_IMPL(ShortestPath)
@@ -53,8 +54,9 @@ class DistanceTable {
   int counter = 1;
 };
 
-static DistanceTable distanceTable(Level::getMaxBounds());
-static DirtyTable<double> navigationCostCache(Level::getMaxBounds(), 0);
+// Every thread gets its own tables, so that games simulated in parallel can search for paths at the same time.
+static thread_local DistanceTable distanceTable(Level::getMaxBounds());
+static thread_local DirtyTable<double> navigationCostCache(Level::getMaxBounds(), 0);
 
 template <typename Fun>
 static auto getCached(Fun fun) {
@@ -92,8 +94,8 @@ ShortestPath::ShortestPath(TemplateConstr, Rectangle a, EntryFun entryFun, Lengt
 }
 
 ShortestPath::ShortestPath(Rectangle area, function<double (Vec2)> entryFun, function<double(Vec2)> lengthFun,
-    vector<Vec2> directions, Vec2 target, Vec2 from, double mult) : ShortestPath(area, entryFun, lengthFun,
-    [directions](Vec2) { return directions; }, target, from, mult)
+    vector<Vec2> directions, Vec2 target, Vec2 from, double mult) : ShortestPath(TemplateConstr{}, area, entryFun,
+    lengthFun, [directions](Vec2) -> const vector<Vec2>& { return directions; }, target, from, mult)
 {
 }
 
@@ -110,6 +112,7 @@ template <typename EntryFun, typename LengthFun, typename DirectionsFun>
 void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun directions,
     Vec2 target, optional<Vec2> from, optional<int> limit) {
   PROFILE;
+  PerfCounters::add(PerfCounter::PATH_SEARCHES);
   reversed = false;
   distanceTable.clear();
   function<QueueElem(Vec2)> makeElem;
@@ -127,7 +130,7 @@ void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun di
     double posDist = distanceTable.getDistance(pos);
    // INFO << "Popping " << pos << " " << distance[pos]  << " " << (from ? (*from - pos).length4() : 0);
     if (from == pos || (limit && distanceTable.getDistance(pos) >= *limit)) {
-      INFO << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
+      INFO_IN(PATHFINDING) << "Shortest path from " << (from ? *from : Vec2(-1, -1)) << " to " << target << " " << numPopped
         << " visited distance " << distanceTable.getDistance(pos);
       constructPath(pos, directions);
       return;
@@ -153,10 +156,11 @@ void ShortestPath::init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun di
       }
     }
   }
-  INFO << "Shortest path exhausted, " << numPopped << " visited";
+  INFO_IN(PATHFINDING) << "Shortest path exhausted, " << numPopped << " visited";
 }
 
-void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, function<vector<Vec2>(Vec2)> directions,
+template <typename DirectionsFun>
+void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, DirectionsFun directions,
     double mult, Vec2 from, int limit) {
   PROFILE;
   reversed = true;
@@ -174,7 +178,7 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
     ++numPopped;
     Vec2 pos = q.top().pos;
     if (from == pos) {
-      INFO << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+      INFO_IN(PATHFINDING) << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
       constructPath(pos, directions, true);
       return;
     }
@@ -188,10 +192,11 @@ void ShortestPath::reverse(function<double(Vec2)> entryFun, function<double(Vec2
         }
       }
   }
-  INFO << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
+  INFO_IN(PATHFINDING) << "Rev shortest path from " << " from " << target << " " << numPopped << " visited";
 }
 
-void ShortestPath::constructPath(Vec2 pos, function<vector<Vec2>(Vec2)> directions, bool reversed) {
+template <typename DirectionsFun>
+void ShortestPath::constructPath(Vec2 pos, DirectionsFun directions, bool reversed) {
   vector<Vec2> ret;
   auto origPos = pos;
   while (pos != target) {
@@ -274,7 +279,9 @@ ShortestPath LevelShortestPath::makeShortestPath(const Creature* creature, Posit
   };
   auto directionsFun = [=] (Vec2 v) {
     Position pos(v, level);
-    vector<Vec2> ret = Vec2::directions8();
+    StaticVector<Vec2, 9> ret;
+    for (Vec2 dir : Vec2::directions8())
+      ret.push_back(dir);
     if (auto f = pos.getFurniture(FurnitureLayer::MIDDLE))
       if (f->getUsageType() == FurnitureUsageType::PORTAL)
         if (auto otherPos = pos.getOtherPortal())
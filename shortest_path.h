@@ -62,8 +62,10 @@ class ShortestPath {
   template <typename EntryFun, typename LengthFun, typename DirectionsFun>
   void init(EntryFun entryFun, LengthFun lengthFun, DirectionsFun directions,
       Vec2 target, optional<Vec2> from, optional<int> limit = none);
-  void reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, function<vector<Vec2>(Vec2)> directions, double mult, Vec2 from, int limit);
-  void constructPath(Vec2 start, function<vector<Vec2>(Vec2)> directions, bool reversed = false);
+  template <typename DirectionsFun>
+  void reverse(function<double(Vec2)> entryFun, function<double(Vec2)> lengthFun, DirectionsFun directions, double mult, Vec2 from, int limit);
+  template <typename DirectionsFun>
+  void constructPath(Vec2 start, DirectionsFun directions, bool reversed = false);
   vector<Vec2> SERIAL(path);
   Vec2 SERIAL(target);
   Rectangle SERIAL(bounds);
@@ -0,0 +1,77 @@
+#include "stdafx.h"
+#include "sprite_batcher.h"
+
+// Limits the cost of finding a batch for a quad when there are many textures on screen.
+static const int maxBatchLookback = 64;
+
+void SpriteBatcher::add(unsigned texture, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, Vec2 textureSize,
+    Color color) {
+  Rectangle bounds(
+      min(min(a.x, b.x), min(c.x, d.x)), min(min(a.y, b.y), min(c.y, d.y)),
+      max(max(a.x, b.x), max(c.x, d.x)), max(max(a.y, b.y), max(c.y, d.y)));
+  optional<int> batch;
+  for (int i = pendingBatches.size() - 1; i >= max(0, pendingBatches.size() - maxBatchLookback); --i) {
+    auto& pending = pendingBatches[i];
+    if (pending.texture == texture) {
+      batch = i;
+      break;
+    }
+    if (pending.bounds.intersects(bounds))
+      break;
+  }
+  if (!batch) {
+    batch = pendingBatches.size();
+    pendingBatches.push_back(PendingBatch{texture, bounds, 0});
+  }
+  auto& pending = pendingBatches[*batch];
+  pending.bounds = Rectangle(
+      min(pending.bounds.left(), bounds.left()), min(pending.bounds.top(), bounds.top()),
+      max(pending.bounds.right(), bounds.right()), max(pending.bounds.bottom(), bounds.bottom()));
+  ++pending.numQuads;
+  quads.push_back(Quad{{a, b, c, d}, float(p.x) / textureSize.x, float(p.y) / textureSize.y,
+      float(k.x) / textureSize.x, float(k.y) / textureSize.y, color, *batch});
+}
+
+bool SpriteBatcher::isEmpty() const {
+  return quads.empty();
+}
+
+void SpriteBatcher::finish() {
+  batches.clear();
+  int numVertices = 0;
+  for (auto& pending : pendingBatches) {
+    batches.push_back(Batch{pending.texture, numVertices, 6 * pending.numQuads});
+    numVertices += 6 * pending.numQuads;
+  }
+  vertices.resize(numVertices);
+  vector<int> nextVertex = batches.transform([](const Batch& b) { return b.firstVertex; });
+  for (auto& quad : quads) {
+    auto makeVertex = [&](int corner, float u, float v) {
+      return Vertex{float(quad.corners[corner].x), float(quad.corners[corner].y), u, v,
+          float(quad.color.r) / 255, float(quad.color.g) / 255, float(quad.color.b) / 255, float(quad.color.a) / 255};
+    };
+    int out = nextVertex[quad.batch];
+    vertices[out] = makeVertex(0, quad.u1, quad.v1);
+    vertices[out + 1] = makeVertex(1, quad.u2, quad.v1);
+    vertices[out + 2] = makeVertex(2, quad.u2, quad.v2);
+    vertices[out + 3] = vertices[out];
+    vertices[out + 4] = vertices[out + 2];
+    vertices[out + 5] = makeVertex(3, quad.u1, quad.v2);
+    nextVertex[quad.batch] += 6;
+  }
+}
+
+const vector<SpriteBatcher::Batch>& SpriteBatcher::getBatches() const {
+  return batches;
+}
+
+const vector<SpriteBatcher::Vertex>& SpriteBatcher::getVertices() const {
+  return vertices;
+}
+
+void SpriteBatcher::clear() {
+  quads.clear();
+  pendingBatches.clear();
+  batches.clear();
+  vertices.clear();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "util.h"
+#include "color.h"
+
+/* Groups textured quads into as few draw calls as possible. A quad may join an earlier batch with the same
+   texture only if it doesn't overlap any of the batches drawn after it, so the result looks the same as drawing
+   the quads in order. Doesn't call OpenGL, so the produced command stream can be checked in tests. */
+class SpriteBatcher {
+  public:
+  struct Vertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+  };
+  struct Batch {
+    unsigned texture;
+    int firstVertex;
+    int numVertices;
+  };
+
+  // Corners a, b, c, d go clockwise from the top left. p and k are the texel coordinates of the top left
+  // and bottom right corner in a texture of the given size.
+  void add(unsigned texture, Vec2 a, Vec2 b, Vec2 c, Vec2 d, Vec2 p, Vec2 k, Vec2 textureSize, Color);
+  bool isEmpty() const;
+  // Fills the vertex buffer, with the vertices of every batch stored contiguously, two triangles per quad.
+  void finish();
+  const vector<Batch>& getBatches() const;
+  const vector<Vertex>& getVertices() const;
+  // Keeps the allocated buffers for the next frame.
+  void clear();
+
+  private:
+  struct Quad {
+    Vec2 corners[4];
+    float u1, v1, u2, v2;
+    Color color;
+    int batch;
+  };
+  struct PendingBatch {
+    unsigned texture;
+    Rectangle bounds;
+    int numQuads;
+  };
+  vector<Quad> quads;
+  vector<PendingBatch> pendingBatches;
+  vector<Batch> batches;
+  vector<Vertex> vertices;
+};
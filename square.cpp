@@ -30,13 +30,24 @@
 #include "view.h"
 #include "game_event.h"
 #include "fire.h"
+#include "model.h"
 
 template <class Archive> 
 void Square::serialize(Archive& ar, const unsigned int version) { 
   ar & SUBCLASS(OwnedObject<Square>);
   ar(inventory, onFire);
-  ar(creature, landingLink, poisonGas);
-  ar(lastViewer, viewIndex);
+  ar(creature, landingLink);
+  if (version == 0) {
+    HeapAllocated<PoisonGas> poisonGas;
+    ar(poisonGas);
+    if (poisonGas->getAmount() > 0)
+      PoisonGas::getLoadedAmounts()[this] = poisonGas->getAmount();
+  }
+  if (version < 2) {
+    optional<UniqueEntity<Creature>::Id> lastViewer;
+    unique_ptr<ViewIndex> viewIndex;
+    ar(lastViewer, viewIndex);
+  }
   ar(forbiddenTribe);
   if (progressMeter)
     progressMeter->addProgress();
@@ -46,7 +57,7 @@ ProgressMeter* Square::progressMeter = nullptr;
 
 SERIALIZABLE(Square);
 
-Square::Square() : viewIndex(new ViewIndex()) {
+Square::Square() {
 }
 
 Square::~Square() {
@@ -84,7 +95,9 @@ void Square::tick(Position pos) {
   PROFILE_BLOCK("Square::tick");
   setDirty(pos);
   if (!inventory->isEmpty()) {
-    inventory->tick(pos);
+    // Items may also be replaced in place, so a changed look counts as a change too.
+    if (inventory->tick(pos))
+      onItemsChanged(pos);
     if (!pos.canEnterEmpty(MovementType(MovementTrait::WALK).setForced()))
       for (auto neighbor : pos.neighbors8(Random))
         if (neighbor.canEnterEmpty({MovementTrait::WALK})) {
@@ -92,10 +105,6 @@ void Square::tick(Position pos) {
           break;
         }
   }
-  poisonGas->tick(pos);
-  if (creature && poisonGas->getAmount() > 0.2) {
-    creature->poisonWithGas(min(1.0, poisonGas->getAmount()));
-  }
 }
 
 bool Square::itemLands(vector<Item*> item, const Attack& attack) const {
@@ -121,25 +130,7 @@ void Square::onItemLands(Position pos, vector<PItem> item, const Attack& attack)
     pos.dropItems(std::move(item));
 }
 
-void Square::addPoisonGas(Position pos, double amount) {
-  setDirty(pos);
-  if (pos.canSeeThru(VisionId::NORMAL)) {
-    poisonGas->addAmount(amount);
-    pos.getLevel()->addTickingSquare(pos.getCoord());
-  }
-}
-
-double Square::getPoisonGasAmount() const {
-  return poisonGas->getAmount();
-}
-
-void Square::getViewIndex(ViewIndex& ret, const Creature* viewer) const {
-  if ((!viewer && lastViewer) || (viewer && lastViewer == viewer->getUniqueId())) {
-    ret = *viewIndex;
-    return;
-  }
-  // viewer is null only in Spectator mode, so setting a random id to lastViewer is ok
-  lastViewer = viewer ? viewer->getUniqueId() : Creature::Id();
+void Square::getViewIndex(ViewIndex& ret) const {
   ret.modItemCounts() = inventory->getCounts();
   if (Item* it = getTopItem()) {
     auto obj = it->getViewObject();
@@ -150,9 +141,6 @@ void Square::getViewIndex(ViewIndex& ret, const Creature* viewer) const {
       }
     ret.insert(std::move(obj));
   }
-  if (poisonGas->getAmount() > 0)
-    ret.setGradient(GradientType::POISON_GAS, min(1.0, poisonGas->getAmount()));
-  *viewIndex = ret;
 }
 
 void Square::dropItem(Position pos, PItem item) {
@@ -165,6 +153,7 @@ void Square::dropItemsLevelGen(vector<PItem> items) {
 
 void Square::dropItems(Position pos, vector<PItem> items) {
   setDirty(pos);
+  onItemsChanged(pos);
   pos.getLevel()->addTickingSquare(pos.getCoord());
   dropItemsLevelGen(std::move(items));
 }
@@ -190,17 +179,18 @@ Item* Square::getTopItem() const {
 
 PItem Square::removeItem(Position pos, Item* it) {
   setDirty(pos);
+  onItemsChanged(pos);
   return getInventory().removeItem(it);
 }
 
 vector<PItem> Square::removeItems(Position pos, vector<Item*> it) {
   setDirty(pos);
+  onItemsChanged(pos);
   return getInventory().removeItems(it);
 }
 
 void Square::setDirty(Position pos) {
   pos.setNeedsRenderAndMemoryUpdate(true);
-  lastViewer.reset();
 }
 
 void Square::forbidMovementForTribe(Position pos, TribeId tribe) {
@@ -233,6 +223,13 @@ const Inventory& Square::getInventory() const {
   return *inventory;
 }
 
-void Square::clearItemIndex(ItemIndex index) {
+void Square::clearItemIndex(Position pos, ItemIndex index) {
   inventory->clearIndex(index);
+  onItemsChanged(pos);
+}
+
+void Square::onItemsChanged(Position pos) {
+  pos.updateMoraleInfluence();
+  if (auto model = pos.getModel())
+    model->onItemsChanged();
 }
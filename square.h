@@ -23,7 +23,6 @@
 class Creature;
 class Item;
 class ProgressMeter;
-class PoisonGas;
 class Inventory;
 class Position;
 class ViewIndex;
@@ -44,12 +43,6 @@ class Square : public OwnedObject<Square> {
   /** Returns the entry point details. Returns none if square is not entry point. See setLandingLink().*/
   optional<StairKey> getLandingLink() const;
 
-  /** Adds some poison gas to the square.*/
-  void addPoisonGas(Position, double amount);
-
-  /** Returns the amount of poison gas on this square.*/
-  double getPoisonGasAmount() const;
-
   /** Sets the level this square is on.*/
   void onAddedToLevel(Position) const;
 
@@ -76,7 +69,7 @@ class Square : public OwnedObject<Square> {
       For this method to be called, the square coordinates must be added with Level::addTickingSquare().*/
   void tick(Position);
 
-  void getViewIndex(ViewIndex&, const Creature* viewer) const;
+  void getViewIndex(ViewIndex&) const;
 
   bool itemLands(vector<Item*> item, const Attack& attack) const;
   void onItemLands(Position, vector<PItem>, const Attack&);
@@ -93,7 +86,7 @@ class Square : public OwnedObject<Square> {
   bool needsMemoryUpdate() const;
   void setMemoryUpdated();
 
-  void clearItemIndex(ItemIndex);
+  void clearItemIndex(Position, ItemIndex);
   void setDirty(Position);
 
   Inventory& getInventory();
@@ -104,12 +97,12 @@ class Square : public OwnedObject<Square> {
 
   private:
   Item* getTopItem() const;
+  void onItemsChanged(Position);
   HeapAllocated<Inventory> SERIAL(inventory);
   Creature* SERIAL(creature) = nullptr;
   optional<StairKey> SERIAL(landingLink);
-  HeapAllocated<PoisonGas> SERIAL(poisonGas);
-  mutable optional<UniqueEntity<Creature>::Id> SERIAL(lastViewer);
-  unique_ptr<ViewIndex> SERIAL(viewIndex);
   optional<TribeId> SERIAL(forbiddenTribe);
   bool SERIAL(onFire) = false;
 };
+
+CEREAL_CLASS_VERSION(Square, 2);
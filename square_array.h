@@ -2,6 +2,7 @@
 
 #include "util.h"
 #include "square.h"
+#include "memory_report.h"
 
 
 class SquareArray {
@@ -42,4 +43,8 @@ class SquareArray {
     return numModified;
   }
 
+  long long getMemoryUsage() const {
+    return ::getMemoryUsage(modified) + (numModified + 1) * sizeof(Square);
+  }
+
 };
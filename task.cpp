@@ -787,7 +787,7 @@ PTask Task::attackCreatures(vector<Creature*> c) {
 
 PTask Task::stealFrom(WCollective collective) {
   vector<PTask> tasks;
-  for (Position pos : collective->getConstructions().getBuiltPositions(FurnitureType("TREASURE_CHEST"))) {
+  for (Position pos : collective->getConstructions().getBuiltPositions(CONTENT_ID(FurnitureType, "TREASURE_CHEST"))) {
     vector<Item*> gold = pos.getItems().filter(Item::classPredicate(ItemClass::GOLD));
     if (!gold.empty())
       tasks.push_back(pickUpItem(pos, gold));
@@ -1657,10 +1657,10 @@ class Spider : public Task {
       : origin(orig), webPositions(pos) {}
 
   virtual MoveInfo getMove(Creature* c) override {
-    auto layer = origin.getGame()->getContentFactory()->furniture.getData(FurnitureType("SPIDER_WEB")).getLayer();
+    auto layer = origin.getGame()->getContentFactory()->furniture.getData(CONTENT_ID(FurnitureType, "SPIDER_WEB")).getLayer();
     for (auto pos : webPositions)
       if (!pos.getFurniture(layer))
-        pos.addFurniture(origin.getGame()->getContentFactory()->furniture.getFurniture(FurnitureType("SPIDER_WEB"), c->getTribeId()));
+        pos.addFurniture(origin.getGame()->getContentFactory()->furniture.getFurniture(CONTENT_ID(FurnitureType, "SPIDER_WEB"), c->getTribeId()));
     for (auto& pos : Random.permutation(webPositions))
       if (auto victim = pos.getCreature())
         if (victim->isAffected(LastingEffect::ENTANGLED) && victim->isEnemy(c)) {
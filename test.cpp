@@ -44,6 +44,28 @@
 #include "name_generator.h"
 #include "lasting_effect.h"
 #include "test_struct.h"
+#include "sprite_batcher.h"
+#include "texture_atlas.h"
+#include "bit_table.h"
+#include "creature_attributes.h"
+#include "allocation_tracker.h"
+#include "memory_report.h"
+#include "event_uploader.h"
+#include "file_path.h"
+#include "map_memory.h"
+#include "view_index.h"
+#include "view_object.h"
+#include "main_loop.h"
+#include "diffusion_field.h"
+#include "creature_list.h"
+
+// Files written by the tests go to the system's temporary directory rather than to the working directory.
+static FilePath getTempFile(const string& name) {
+  for (auto variable : {"TMPDIR", "TEMP", "TMP"})
+    if (auto dir = getenv(variable))
+      return DirectoryPath(dir).file(name);
+  return DirectoryPath("/tmp").file(name);
+}
 
 class Test {
   public:
@@ -1106,6 +1128,26 @@ class Test {
       t.matching.addTarget(t.get(v.x, v.y));
   }
 
+  void testMapMemoryPool() {
+    MatchingTest t;
+    MapMemory memory;
+    auto pos1 = t.get(3, 3);
+    auto pos2 = t.get(6, 4);
+    for (auto pos : {pos1, pos2}) {
+      t.free(pos);
+      ViewIndex index;
+      pos.getViewIndex(index, nullptr);
+      memory.update(pos, index);
+    }
+    CHECK(memory.getPoolSize() == 1);
+    for (auto pos : {pos1, pos2}) {
+      auto index = memory.getViewIndex(pos);
+      CHECK(!!index && !index->noObjects());
+      for (auto& obj : index->getAllObjects())
+        CHECK(obj.getGenericId() == pos.getFurnitureGenericId());
+    }
+  }
+
   void testDungeonLevel() {
     DungeonLevel level;
     CHECKEQ(level.level, 0);
@@ -1125,6 +1167,58 @@ class Test {
     CHECKEQ(level.progress, 4.5 / 13);
   }
 
+  void checkAmount(const DiffusionField& field, Vec2 v, float expected) {
+    CHECK(fabs(field.get(v) - expected) < 0.00001) << v << " " << field.get(v) << " " << expected;
+  }
+
+  // A unit of gas in the middle of an open 5x5 grid spreads 0.1 of the difference to the cardinal and 0.05 to
+  // the diagonal neighbors, then everything decays by 0.98.
+  void testDiffusionField1() {
+    DiffusionField field(Rectangle(5, 5));
+    field.add(Vec2(2, 2), 1);
+    int numChanged = 0;
+    field.tick([](Vec2) { return true; }, [&](Vec2 v, float previous) {
+      ++numChanged;
+      CHECK(previous == (v == Vec2(2, 2) ? 1 : 0));
+    });
+    CHECKEQ(numChanged, 9);
+    checkAmount(field, Vec2(2, 2), (1 - 0.1 * 4 - 0.05 * 4) * 0.98);
+    for (Vec2 v : {Vec2(2, 1), Vec2(1, 2), Vec2(3, 2), Vec2(2, 3)})
+      checkAmount(field, v, 0.1 * 0.98);
+    for (Vec2 v : {Vec2(1, 1), Vec2(3, 1), Vec2(1, 3), Vec2(3, 3)})
+      checkAmount(field, v, 0.05 * 0.98);
+    for (Vec2 v : {Vec2(0, 2), Vec2(2, 0), Vec2(4, 4), Vec2(0, 0)})
+      checkAmount(field, v, 0);
+    CHECK(field.getActiveArea() == Rectangle(1, 1, 4, 4));
+  }
+
+  // A blocked tile neither takes nor gives anything, but its own gas still decays.
+  void testDiffusionField2() {
+    DiffusionField field(Rectangle(5, 5));
+    field.add(Vec2(2, 2), 1);
+    field.add(Vec2(2, 1), 0.5);
+    field.tick([](Vec2 v) { return v != Vec2(2, 1); }, [](Vec2, float) {});
+    checkAmount(field, Vec2(2, 2), (1 - 0.1 * 3 - 0.05 * 4) * 0.98);
+    checkAmount(field, Vec2(2, 1), 0.5 * 0.98);
+    checkAmount(field, Vec2(2, 0), 0);
+    checkAmount(field, Vec2(1, 1), 0.05 * 0.98);
+    checkAmount(field, Vec2(1, 0), 0);
+    CHECK(field.getActiveArea() == Rectangle(1, 1, 4, 4));
+  }
+
+  // Amounts that drop below 0.01 are cleared, and the active area disappears with the last one.
+  void testDiffusionField3() {
+    DiffusionField field(Rectangle(5, 5));
+    field.add(Vec2(4, 4), 0.01);
+    CHECK(field.getActiveArea() == Rectangle(4, 4, 5, 5));
+    vector<pair<Vec2, float>> changed;
+    field.tick([](Vec2) { return true; }, [&](Vec2 v, float previous) { changed.push_back({v, previous}); });
+    CHECK(changed.size() == 1 && changed[0].first == Vec2(4, 4) && changed[0].second == 0.01f);
+    checkAmount(field, Vec2(4, 4), 0);
+    checkAmount(field, Vec2(3, 3), 0);
+    CHECK(!field.getActiveArea());
+  }
+
   void testRoofSupport1() {
     RoofSupport s(Rectangle(10, 10));
     std::cout << "Testing roof support " << std::endl;
@@ -1201,6 +1295,263 @@ class Test {
     for (auto v : sz)
       CHECKEQ(was[v.x][v.y], s.isRoof(v));
   }
+
+  void testSpriteBatcher() {
+    SpriteBatcher batcher;
+    auto add = [&](unsigned texture, Rectangle r) {
+      batcher.add(texture, r.topLeft(), r.topRight(), r.bottomRight(), r.bottomLeft(), Vec2(0, 0), Vec2(1, 1),
+          Vec2(1, 1), Color::WHITE);
+    };
+    // Two interleaved textures that don't overlap end up in two draw calls.
+    add(1, Rectangle(0, 0, 10, 10));
+    add(2, Rectangle(10, 0, 20, 10));
+    add(1, Rectangle(20, 0, 30, 10));
+    add(2, Rectangle(30, 0, 40, 10));
+    batcher.finish();
+    CHECKEQ(batcher.getBatches().size(), 2);
+    CHECKEQ(batcher.getBatches()[0].texture, 1u);
+    CHECKEQ(batcher.getBatches()[0].numVertices, 12);
+    CHECKEQ(batcher.getBatches()[1].firstVertex, 12);
+    CHECKEQ(batcher.getVertices().size(), 24);
+    CHECKEQ(batcher.getVertices()[6].x, 20);
+    batcher.clear();
+    // A sprite drawn over a sprite of another texture can't join an earlier batch.
+    add(1, Rectangle(0, 0, 10, 10));
+    add(2, Rectangle(5, 5, 15, 15));
+    add(1, Rectangle(10, 10, 20, 20));
+    batcher.finish();
+    CHECKEQ(batcher.getBatches().size(), 3);
+    CHECKEQ(batcher.getBatches()[2].texture, 1u);
+    CHECKEQ(batcher.getVertices()[12].x, 10);
+  }
+
+  void testAtlasPacker() {
+    AtlasPacker packer(64);
+    auto checkAdd = [&](Vec2 size, int page, Vec2 pos) {
+      auto placement = packer.add(size);
+      CHECKEQ(placement.page, page);
+      CHECKEQ(placement.pos, pos);
+    };
+    checkAdd(Vec2(30, 30), 0, Vec2(0, 0));
+    checkAdd(Vec2(30, 30), 0, Vec2(30, 0));
+    checkAdd(Vec2(30, 30), 0, Vec2(0, 30));
+    // Slightly smaller frames share a shelf, much smaller ones start a new one.
+    checkAdd(Vec2(24, 24), 0, Vec2(30, 30));
+    checkAdd(Vec2(16, 16), 1, Vec2(0, 0));
+    checkAdd(Vec2(16, 16), 1, Vec2(16, 0));
+    CHECKEQ(packer.getNumPages(), 2);
+  }
+
+  void testBitTable() {
+    Rectangle bounds(-3, 2, 7, 80);
+    BitTable table(bounds);
+    for (Vec2 v : bounds)
+      if ((v.x * 7 + v.y * 3) % 5 == 0)
+        table.set(v, true);
+    vector<Vec2> expected;
+    for (Vec2 v : bounds)
+      if ((v.x * 7 + v.y * 3) % 5 == 0)
+        expected.push_back(v);
+    CHECK(table.getAllSet() == expected);
+    CHECKEQ(table.count(), expected.size());
+    auto inverted = table;
+    inverted.invert();
+    CHECKEQ(inverted.count(), bounds.width() * bounds.height() - expected.size());
+    Rectangle inside = bounds.minusMargin(1);
+    auto neighbors = Vec2::directions8().transform([&](Vec2 dir) { return table.getShifted(inside, dir); });
+    for (int count : Range(10)) {
+      auto atLeast = BitTable::countAtLeast(neighbors, count);
+      auto equals = BitTable::countEquals(neighbors, count);
+      for (Vec2 v : inside) {
+        int num = 0;
+        for (Vec2 w : v.neighbors8())
+          if (table.get(w))
+            ++num;
+        CHECKEQ(atLeast.get(v), num >= count);
+        CHECKEQ(equals.get(v), num == count);
+      }
+    }
+    auto shifted = table.getShifted(Rectangle(-10, -70, 10, 150), Vec2(1, -65));
+    for (Vec2 v : shifted.getBounds())
+      CHECKEQ(shifted.get(v), (v + Vec2(1, -65)).inRectangle(bounds) && table.get(v + Vec2(1, -65)));
+  }
+
+  void testFixedNeighbors() {
+    Vec2 pos(3, -5);
+    CHECK(pos.fixedNeighbors8().asVector() == pos.neighbors8());
+    CHECK(pos.fixedNeighbors4().asVector() == pos.neighbors4());
+    RandomGen random1;
+    RandomGen random2;
+    random1.init(123);
+    random2.init(123);
+    for (int i : Range(20)) {
+      CHECK(pos.fixedNeighbors8(random1).asVector() == pos.neighbors8(random2));
+      CHECK(pos.fixedNeighbors4(random1).asVector() == pos.neighbors4(random2));
+    }
+    StaticVector<string, 3> v;
+    v.push_back("a");
+    v.push_back("b");
+    auto copy = v;
+    v.clear();
+    CHECK(v.empty());
+    CHECKEQ(copy.size(), 2);
+    CHECK(copy.contains("b") && !copy.contains("c"));
+  }
+
+  void testMemoryReport() {
+    MemoryReport report;
+    report.addGroup("model 0,0", [&] {
+      report.add("map memory", 10);
+      report.addGroup("level 1", [&] { report.add("squares", 5); });
+    });
+    report.add("other", 1);
+    CHECKEQ(report.getTotal(), 16);
+    stringstream ss;
+    report.write(ss);
+    CHECKEQ(ss.str(), "model 0,0/map memory\t10\nmodel 0,0/level 1/squares\t5\nother\t1\ntotal\t16\n");
+    CHECKEQ(getMemoryUsage(Table<int>(3, 4)), 12 * sizeof(int));
+  }
+
+  // Checks that every thread that overrides the global Random gets the same stream as a generator with the same seed,
+  // and that a nested override doesn't disturb it.
+  void testRandomThreadOverride() {
+    RandomGen expectedRandom;
+    expectedRandom.init(5);
+    vector<int> expected;
+    for (int i : Range(100))
+      expected.push_back(expectedRandom.get(1000));
+    auto play = [] {
+      RandomGen random;
+      random.init(5);
+      RandomGen::ThreadOverride randomOverride(random);
+      vector<int> ret;
+      for (int i : Range(50))
+        ret.push_back(Random.get(1000));
+      {
+        RandomGen other;
+        other.init(6);
+        RandomGen::ThreadOverride otherOverride(other);
+        Random.get(1000);
+      }
+      for (int i : Range(50))
+        ret.push_back(Random.get(1000));
+      return ret;
+    };
+    vector<int> fromThread;
+    thread t([&] { fromThread = play(); });
+    auto fromMainThread = play();
+    t.join();
+    CHECK(fromThread == expected);
+    CHECK(fromMainThread == expected);
+  }
+
+  // Fails the uploads of the first uploader and checks that the next one sends the spooled events in batches.
+  void testEventUploader() {
+    auto spool = getTempFile("keeperrl_event_uploader_test.txt");
+    remove(spool.getPath());
+    EventUploader::Params params {milliseconds(10), 3, milliseconds(1), milliseconds(4), 100};
+    EventUploader::Event event {{"eventType", "boardMessage"}, {"text", "a&b=c + 100%\n\xc4\x85"}};
+    CHECK(EventUploader::decodeEvent(EventUploader::encodeEvent(event)) == event);
+    std::mutex mutex;
+    vector<vector<string>> batches;
+    atomic<bool> online(false);
+    auto post = [&](const string& batch) {
+      if (!online)
+        return false;
+      std::unique_lock<std::mutex> lock(mutex);
+      batches.push_back(*EventUploader::decodeBatch(batch));
+      return true;
+    };
+    {
+      EventUploader uploader(post, spool, params);
+      uploader.add(event);
+      CHECKEQ(uploader.getNumPending(), 0);
+      uploader.setEnabled(true);
+      for (int i : Range(5)) {
+        event["turn"] = toString(i);
+        uploader.add(event);
+      }
+      CHECK(!uploader.waitUntilSent(milliseconds(100)));
+      CHECKEQ(uploader.getNumPending(), 5);
+      CHECK(uploader.getNumRequests() > 1);
+    }
+    online = true;
+    {
+      EventUploader uploader(post, spool, params);
+      uploader.removeEvents([](const EventUploader::Event& e) { return e.at("turn") == "4"; });
+      CHECKEQ(uploader.getNumPending(), 4);
+      uploader.setEnabled(true);
+      CHECK(uploader.waitUntilSent(milliseconds(5000)));
+    }
+    CHECKEQ(batches.size(), 2);
+    CHECKEQ(batches[0].size(), 3);
+    CHECKEQ(batches[1].size(), 1);
+    for (int i : Range(4)) {
+      event["turn"] = toString(i);
+      CHECK(EventUploader::decodeEvent(batches[i / 3][i % 3]) == event);
+    }
+    CHECKEQ(spool.readContents().value_or(""), "");
+    remove(spool.getPath());
+  }
+
+  // Checks that ticking only the active effects times out and ticks the same effects as looping over all of them.
+  void testActiveLastingEffects() {
+    RandomGen random;
+    random.init(123);
+    auto attributes = CATTR();
+    auto reference = attributes;
+    auto modify = [&](GlobalTime time) {
+      auto effect = LastingEffect(random.get(EnumInfo<LastingEffect>::size));
+      switch (random.get(4)) {
+        case 0: {
+          auto endTime = time + TimeInterval(random.get(1, 50));
+          attributes.addLastingEffect(effect, endTime);
+          reference.addLastingEffect(effect, endTime);
+          break;
+        }
+        case 1:
+          attributes.clearLastingEffect(effect);
+          reference.clearLastingEffect(effect);
+          break;
+        case 2:
+          attributes.addPermanentEffect(effect, 1);
+          reference.addPermanentEffect(effect, 1);
+          break;
+        case 3:
+          if (reference.isAffectedPermanently(effect)) {
+            attributes.removePermanentEffect(effect, 1);
+            reference.removePermanentEffect(effect, 1);
+          }
+          break;
+      }
+    };
+    for (int turn : Range(1, 5000)) {
+      GlobalTime time(turn);
+      for (int i : Range(random.get(3)))
+        modify(time);
+      vector<pair<LastingEffect, bool>> expected;
+      for (auto effect : ENUM_ALL(LastingEffect)) {
+        if (reference.considerTimeout(effect, time))
+          expected.push_back({effect, false});
+        if (reference.isAffected(effect, time))
+          expected.push_back({effect, true});
+      }
+      vector<pair<LastingEffect, bool>> actual;
+      for (auto effect : attributes.getActiveEffects()) {
+        if (attributes.considerTimeout(effect, time))
+          actual.push_back({effect, false});
+        if (attributes.isAffected(effect, time))
+          actual.push_back({effect, true});
+      }
+      CHECK(expected == actual) << "Turn " << turn;
+      for (auto effect : ENUM_ALL(LastingEffect)) {
+        auto suppressor = LastingEffects::getSuppressor(effect);
+        CHECKEQ(attributes.isAffected(effect, time),
+            (attributes.getTimeOut(effect) > time || attributes.isAffectedPermanently(effect)) &&
+            !(suppressor && attributes.isAffected(*suppressor, time)));
+      }
+    }
+  }
 };
 
 void testAll() {
@@ -1259,7 +1610,11 @@ void testAll() {
   Test().testPositionMatching2();
   Test().testPositionMatching3();
   Test().testPositionMatching4();
+  Test().testMapMemoryPool();
   Test().testDungeonLevel();
+  Test().testDiffusionField1();
+  Test().testDiffusionField2();
+  Test().testDiffusionField3();
   Test().testRoofSupport1();
   Test().testRoofSupport2();
   Test().testRoofSupport3();
@@ -1272,6 +1627,95 @@ void testAll() {
   Test().testPrettyInput5();
   Test().testPrettyInput6();
   Test().testPrettyVector();
+  Test().testSpriteBatcher();
+  Test().testAtlasPacker();
+  Test().testBitTable();
+  Test().testActiveLastingEffects();
+  Test().testFixedNeighbors();
+  Test().testMemoryReport();
+  Test().testEventUploader();
+  Test().testRandomThreadOverride();
   LastingEffects::runTests();
   INFO << "-----===== OK =====-----";
 }
+
+// Iterates over the neighbors of a few hundred positions, like the creatures of a busy level do during a turn,
+// once with the allocating functions and once with the fixed ones.
+void neighborBenchmark() {
+  const int numPositions = 500;
+  const int numTurns = 1000;
+  RandomGen random;
+  random.init(0);
+  vector<Vec2> positions;
+  for (int i : Range(numPositions))
+    positions.push_back(Vec2(random.get(100), random.get(100)));
+  auto measure = [&](const char* name, auto fun) {
+    RandomGen shuffleRandom;
+    shuffleRandom.init(1);
+    long long checksum = 0;
+#ifndef RELEASE
+    auto allocations = AllocationTracker::getCount();
+#endif
+    auto time = steady_clock::now();
+    for (int turn : Range(numTurns))
+      for (Vec2 pos : positions)
+        checksum += fun(pos, shuffleRandom);
+    auto micros = duration_cast<microseconds>(steady_clock::now() - time).count();
+    std::cout << name << ": ";
+    // Release builds don't count the allocations.
+#ifndef RELEASE
+    std::cout << double(AllocationTracker::getCount() - allocations) / numTurns << " allocations and ";
+#endif
+    std::cout << double(micros) / numTurns << " us per turn, checksum " << checksum << std::endl;
+  };
+  measure("vector", [](Vec2 pos, RandomGen& shuffleRandom) {
+    int ret = 0;
+    for (Vec2 v : pos.neighbors8())
+      ret += v.x;
+    for (Vec2 v : pos.neighbors4())
+      ret += v.y;
+    int index = 0;
+    for (Vec2 v : pos.neighbors8(shuffleRandom))
+      ret += v.x * ++index;
+    return ret;
+  });
+  measure("fixed", [](Vec2 pos, RandomGen& shuffleRandom) {
+    int ret = 0;
+    for (Vec2 v : pos.fixedNeighbors8())
+      ret += v.x;
+    for (Vec2 v : pos.fixedNeighbors4())
+      ret += v.y;
+    int index = 0;
+    for (Vec2 v : pos.fixedNeighbors8(shuffleRandom))
+      ret += v.x * ++index;
+    return ret;
+  });
+}
+
+// Sends a few hundred events to a server, e.g. server/stand_in.php, and reports how many requests they took.
+void eventUploadTest(const string& url) {
+  const int numEvents = 250;
+  EventUploader uploader(url + "/game_events.php", getTempFile("keeperrl_event_upload_test.txt"));
+  uploader.setEnabled(true);
+  auto time = steady_clock::now();
+  for (int i : Range(numEvents))
+    uploader.add({{"eventType", "turn"}, {"gameId", "upload_test"}, {"turn", toString(i)}});
+  uploader.flush();
+  bool sent = uploader.waitUntilSent(milliseconds(60000));
+  std::cout << (sent ? "Sent " : "Failed to send ") << numEvents << " events in " << uploader.getNumRequests() <<
+      " requests and " << duration_cast<milliseconds>(steady_clock::now() - time).count() << " ms" << std::endl;
+}
+
+// Plays the same seeds on one and on numThreads threads. Every round has its own random generator and its own copy
+// of the game data, so the results must be identical.
+void battleThreadsTest(MainLoop& loop, const FilePath& levelPath, int numThreads) {
+  CreatureList allies(8, CreatureId("ORC"));
+  CreatureList enemies(8, CreatureId("ZOMBIE"));
+  vector<int> seeds;
+  for (int i : Range(2 * numThreads))
+    seeds.push_back(i * 7919 + 1);
+  auto singleThread = loop.playBattleRounds(levelPath, allies, enemies, seeds, 1);
+  auto multiThread = loop.playBattleRounds(levelPath, allies, enemies, seeds, numThreads);
+  CHECKEQ(singleThread, multiThread);
+  std::cout << "Battle results match on 1 and " << numThreads << " threads" << std::endl;
+}
@@ -16,4 +16,9 @@
 #pragma once
 
 void testAll();
+void neighborBenchmark();
+void eventUploadTest(const string& url);
+class MainLoop;
+class FilePath;
+void battleThreadsTest(MainLoop&, const FilePath& levelPath, int numThreads);
 
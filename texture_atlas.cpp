@@ -0,0 +1,30 @@
+#include "stdafx.h"
+#include "texture_atlas.h"
+
+AtlasPacker::AtlasPacker(int size) : pageSize(size) {
+}
+
+AtlasPacker::Placement AtlasPacker::add(Vec2 size) {
+  CHECK(size.x > 0 && size.y > 0 && size.x <= pageSize && size.y <= pageSize) << "Can't pack " << size;
+  for (auto& shelf : shelves)
+    if (shelf.height >= size.y && shelf.height - size.y <= shelf.height / 4 && shelf.width + size.x <= pageSize) {
+      Placement ret {shelf.page, Vec2(shelf.width, shelf.y)};
+      shelf.width += size.x;
+      return ret;
+    }
+  if (numPages == 0 || pageHeight + size.y > pageSize) {
+    ++numPages;
+    pageHeight = 0;
+  }
+  shelves.push_back(Shelf{numPages - 1, pageHeight, size.y, size.x});
+  pageHeight += size.y;
+  return Placement{numPages - 1, Vec2(0, shelves.back().y)};
+}
+
+int AtlasPacker::getNumPages() const {
+  return numPages;
+}
+
+int AtlasPacker::getPageSize() const {
+  return pageSize;
+}
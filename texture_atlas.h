@@ -0,0 +1,31 @@
+#pragma once
+
+#include "util.h"
+
+/* Places rectangles on square pages of a fixed size. Every page is split into horizontal shelves and a
+   rectangle goes to the first shelf that has room and isn't much taller than it. Adding the rectangles
+   sorted by decreasing height keeps the wasted space small. */
+class AtlasPacker {
+  public:
+  AtlasPacker(int pageSize);
+
+  struct Placement {
+    int page;
+    Vec2 pos;
+  };
+  Placement add(Vec2 size);
+  int getNumPages() const;
+  int getPageSize() const;
+
+  private:
+  struct Shelf {
+    int page;
+    int y;
+    int height;
+    int width;
+  };
+  int pageSize;
+  vector<Shelf> shelves;
+  int numPages = 0;
+  int pageHeight = 0;
+};
@@ -4,6 +4,9 @@
 #include "view_object.h"
 #include "game_config.h"
 #include "tile_info.h"
+#include "content_hash.h"
+#include "texture_atlas.h"
+#include "parse_game.h"
 
 void TileSet::addTile(string id, Tile tile) {
   tiles.insert(make_pair(ViewId(id.data()).getInternalId(), std::move(tile)));
@@ -210,7 +213,8 @@ Tile TileSet::symbol(const string& s, Color id, bool symbol) {
   return Tile::fromString(s, id, symbol);
 }
 
-TileSet::TileSet(const DirectoryPath& defaultDir, const DirectoryPath& modsDir) : defaultDir(defaultDir), modsDir(modsDir) {
+TileSet::TileSet(const DirectoryPath& defaultDir, const DirectoryPath& modsDir, const DirectoryPath& cacheDir)
+    : defaultDir(defaultDir), modsDir(modsDir), cacheDir(cacheDir) {
 }
 
 void TileSet::setTilePaths(const TilePaths& p) {
@@ -218,26 +222,188 @@ void TileSet::setTilePaths(const TilePaths& p) {
   reload();
 }
 
+// All sprite frames of the enabled tile directories are packed into a few textures of this size.
+constexpr int atlasPageSize = 2048;
+
+struct TileAtlasSprite {
+  Vec2 SERIAL(size);
+  Vec2 SERIAL(pos);
+  int SERIAL(page);
+  SERIALIZE_ALL(size, pos, page)
+};
+
+// Stored in the user directory after the content hash of the sprite files, so the images only have to be
+// decoded and packed when they change.
+struct TileAtlasCache {
+  int SERIAL(pageSize);
+  vector<string> SERIAL(pages); // RGBA pixels
+  map<string, vector<TileAtlasSprite>> SERIAL(sprites);
+  SERIALIZE_ALL(pageSize, pages, sprites)
+};
+
+using SpriteFiles = map<string, pair<FilePath, Vec2>>;
+
+static bool addSpriteFiles(const DirectoryPath& path, Vec2 size, bool overwrite, SpriteFiles& spriteFiles,
+    ContentHash& hash) {
+  if (!path.exists())
+    return false;
+  const static string imageSuf = ".png";
+  auto files = path.getFiles().filter([](const FilePath& f) { return f.hasSuffix(imageSuf);});
+  if (files.empty())
+    return false;
+  sort(files.begin(), files.end(),
+      [](const FilePath& f1, const FilePath& f2) { return strcmp(f1.getFileName(), f2.getFileName()) < 0; });
+  hash.add(toString(size) + (overwrite ? " overwrite" : " merge"));
+  for (auto& file : files) {
+    string fileName = file.getFileName();
+    string spriteName = fileName.substr(0, fileName.size() - imageSuf.size());
+    if (spriteFiles.count(spriteName)) {
+      if (overwrite)
+        spriteFiles.erase(spriteName);
+      else
+        continue;
+    }
+    hash.add(file);
+    spriteFiles.emplace(spriteName, make_pair(file, size));
+  }
+  return true;
+}
+
+static TileAtlasCache packAtlas(const SpriteFiles& spriteFiles) {
+  struct Frame {
+    const string* spriteName;
+    SDL::SDL_Surface* image;
+    SDL::SDL_Rect src;
+  };
+  vector<SDL::SDL_Surface*> images;
+  vector<Frame> frames;
+  for (auto& elem : spriteFiles) {
+    auto& file = elem.second.first;
+    auto size = elem.second.second;
+    SDL::SDL_Surface* im = SDL::IMG_Load(file.getPath());
+    CHECK(im) << file << ": "<< SDL::IMG_GetError();
+    SDL::SDL_SetSurfaceBlendMode(im, SDL::SDL_BLENDMODE_NONE);
+    USER_CHECK((im->w % size.x == 0) && im->h == size.y) << file << " has wrong size " << im->w << " " << im->h;
+    images.push_back(im);
+    for (int frame : Range(im->w / size.x))
+      frames.push_back(Frame{&elem.first, im, SDL::SDL_Rect{frame * size.x, 0, size.x, size.y}});
+  }
+  // Frames of one sprite have the same height, so the stable sort keeps them in animation order.
+  stable_sort(frames.begin(), frames.end(), [](const Frame& f1, const Frame& f2) { return f1.src.h > f2.src.h; });
+  AtlasPacker packer(atlasPageSize);
+  vector<SDL::SDL_Surface*> pages;
+  TileAtlasCache ret;
+  ret.pageSize = atlasPageSize;
+  for (auto& frame : frames) {
+    auto placement = packer.add(Vec2(frame.src.w, frame.src.h));
+    while (pages.size() <= placement.page) {
+      pages.push_back(Texture::createSurface(atlasPageSize, atlasPageSize));
+      SDL::SDL_SetSurfaceBlendMode(pages.back(), SDL::SDL_BLENDMODE_NONE);
+    }
+    SDL::SDL_Rect dest {placement.pos.x, placement.pos.y, frame.src.w, frame.src.h};
+    SDL_BlitSurface(frame.image, &frame.src, pages[placement.page], &dest);
+    ret.sprites[*frame.spriteName].push_back(
+        TileAtlasSprite{Vec2(frame.src.w, frame.src.h), placement.pos, placement.page});
+  }
+  for (auto image : images)
+    SDL::SDL_FreeSurface(image);
+  for (auto page : pages) {
+    string pixels(atlasPageSize * atlasPageSize * 4, 0);
+    for (int y : Range(atlasPageSize))
+      memcpy(&pixels[y * atlasPageSize * 4], (char*) page->pixels + y * page->pitch, atlasPageSize * 4);
+    ret.pages.push_back(std::move(pixels));
+    SDL::SDL_FreeSurface(page);
+  }
+  return ret;
+}
+
+static optional<TileAtlasCache> loadAtlasCache(const FilePath& file, unsigned long long hash) {
+  try {
+    CompressedInput input(file.getPath());
+    if (!input.getStream().good())
+      return none;
+    unsigned long long cachedHash;
+    input.getArchive() >> cachedHash;
+    if (cachedHash != hash)
+      return none;
+    TileAtlasCache ret;
+    input.getArchive() >> ret;
+    return std::move(ret);
+  } catch (std::exception&) {
+    return none;
+  }
+}
+
+// The cache is written to a temporary file first and then renamed, so that a crash or another instance writing
+// the same cache never leaves a partially written one.
+static void saveAtlasCache(const FilePath& file, unsigned long long hash, const TileAtlasCache& cache) {
+  string tmpPath = file.getPath() + "."_s + toString(currentThreadId()) + "."_s +
+      toString(steady_clock::now().time_since_epoch().count()) + ".tmp"_s;
+  try {
+    {
+      CompressedOutput output(tmpPath.c_str());
+      output.getArchive() << hash << cache;
+    }
+    // rename replaces the old file atomically on POSIX, but fails if it exists on Windows.
+    if (rename(tmpPath.c_str(), file.getPath()) != 0) {
+      remove(file.getPath());
+      rename(tmpPath.c_str(), file.getPath());
+    }
+  } catch (std::exception& e) {
+    INFO << "Error writing " << file << ": " << e.what();
+    remove(tmpPath.c_str());
+  }
+}
+
+void TileSet::loadAtlas(const TileAtlasCache& atlas) {
+  int pageSize = atlas.pageSize;
+  for (auto& pixels : atlas.pages) {
+    CHECK(pixels.size() == size_t(pageSize * pageSize * 4));
+    SDL::SDL_Surface* page = Texture::createSurface(pageSize, pageSize);
+    for (int y : Range(pageSize))
+      memcpy((char*) page->pixels + y * page->pitch, &pixels[y * pageSize * 4], pageSize * 4);
+    textures.push_back(unique<Texture>(page));
+    SDL::SDL_FreeSurface(page);
+  }
+  for (auto& elem : atlas.sprites)
+    for (auto& sprite : elem.second)
+      tileCoords[elem.first].push_back({sprite.size, sprite.pos, textures[sprite.page].get()});
+}
+
 void TileSet::reload() {
   tiles.clear();
   textures.clear();
   symbols.clear();
   tileCoords.clear();
   spriteMods.clear();
+  auto startTime = steady_clock::now();
+  SpriteFiles spriteFiles;
+  ContentHash hash;
+  hash.add("atlas " + toString(atlasPageSize));
   auto reloadDir = [&] (const DirectoryPath& path, bool overwrite) {
     bool hadTiles = false;
-    hadTiles |= loadTilesFromDir(path.subdirectory("orig16"), Vec2(16, 16), overwrite);
-    hadTiles |= loadTilesFromDir(path.subdirectory("orig24"), Vec2(24, 24), overwrite);
-    hadTiles |= loadTilesFromDir(path.subdirectory("orig30"), Vec2(30, 30), overwrite);
+    hadTiles |= addSpriteFiles(path.subdirectory("orig16"), Vec2(16, 16), overwrite, spriteFiles, hash);
+    hadTiles |= addSpriteFiles(path.subdirectory("orig24"), Vec2(24, 24), overwrite, spriteFiles, hash);
+    hadTiles |= addSpriteFiles(path.subdirectory("orig30"), Vec2(30, 30), overwrite, spriteFiles, hash);
     return hadTiles;
   };
-  reloadDir(defaultDir, true);
-  bool useTiles = !tileCoords.empty();
+  bool useTiles = reloadDir(defaultDir, true);
   if (reloadDir(modsDir.subdirectory(tilePaths->mainMod), true))
     spriteMods.push_back(tilePaths->mainMod);
   for (auto& subdir : tilePaths->mergedMods)
     if (reloadDir(modsDir.subdirectory(subdir), false) && !spriteMods.contains(subdir))
       spriteMods.push_back(subdir);
+  auto cacheFile = cacheDir.file("tile_atlas_" + tilePaths->mainMod + ".dat");
+  auto atlas = loadAtlasCache(cacheFile, hash.get());
+  bool cached = !!atlas;
+  if (!atlas) {
+    atlas = packAtlas(spriteFiles);
+    saveAtlasCache(cacheFile, hash.get(), *atlas);
+  }
+  loadAtlas(*atlas);
+  INFO << "Loaded " << tileCoords.size() << " sprites into " << textures.size() << " textures "
+      << (cached ? "from the atlas cache " : "") << "in "
+      << duration_cast<milliseconds>(steady_clock::now() - startTime).count() << " ms";
   loadUnicode();
   if (useTiles)
     loadTiles();
@@ -255,57 +421,3 @@ const Tile& TileSet::getTile(ViewId viewId, bool sprite) const {
     return unknown;
   }
 }
-
-constexpr int textureWidth = 720;
-
-bool TileSet::loadTilesFromDir(const DirectoryPath& path, Vec2 size, bool overwrite) {
-  if (!path.exists())
-    return false;
-  const static string imageSuf = ".png";
-  auto files = path.getFiles().filter([](const FilePath& f) { return f.hasSuffix(imageSuf);});
-  if (files.empty())
-    return false;
-  int rowLength = textureWidth / size.x;
-  SDL::SDL_Surface* image = Texture::createSurface(textureWidth, textureWidth);
-  SDL::SDL_SetSurfaceBlendMode(image, SDL::SDL_BLENDMODE_NONE);
-  CHECK(image) << SDL::SDL_GetError();
-  int frameCount = 0;
-  vector<pair<string, Vec2>> addedPositions;
-  for (int i : All(files)) {
-    SDL::SDL_Surface* im = SDL::IMG_Load(files[i].getPath());
-    SDL::SDL_SetSurfaceBlendMode(im, SDL::SDL_BLENDMODE_NONE);
-    CHECK(im) << files[i] << ": "<< SDL::IMG_GetError();
-    USER_CHECK((im->w % size.x == 0) && im->h == size.y) << files[i] << " has wrong size " << im->w << " " << im->h;
-    string fileName = files[i].getFileName();
-    string spriteName = fileName.substr(0, fileName.size() - imageSuf.size());
-    if (tileCoords.count(spriteName)) {
-      if (overwrite)
-        tileCoords.erase(spriteName);
-      else
-        continue;
-    }
-    for (int frame : Range(im->w / size.x)) {
-      SDL::SDL_Rect dest;
-      int posX = frameCount % rowLength;
-      int posY = frameCount / rowLength;
-      dest.x = size.x * posX;
-      dest.y = size.y * posY;
-      CHECK(dest.x < textureWidth && dest.y < textureWidth);
-      SDL::SDL_Rect src;
-      src.x = frame * size.x;
-      src.y = 0;
-      src.w = size.x;
-      src.h = size.y;
-      SDL_BlitSurface(im, &src, image, &dest);
-      addedPositions.emplace_back(spriteName, Vec2(posX, posY));
-      INFO << "Loading tile sprite " << fileName << " at " << posX << "," << posY;
-      ++frameCount;
-    }
-    SDL::SDL_FreeSurface(im);
-  }
-  textures.push_back(unique<Texture>(image));
-  for (auto& pos : addedPositions)
-    tileCoords[pos.first].push_back({size, pos.second, textures.back().get()});
-  SDL::SDL_FreeSurface(image);
-  return true;
-}
@@ -9,16 +9,18 @@ class Renderer;
 class GameConfig;
 class Tile;
 struct Color;
+struct TileAtlasCache;
 
 struct TileCoord {
   Vec2 size;
+  // Position of the top left corner in pixels.
   Vec2 pos;
   Texture* texture;
 };
 
 class TileSet {
   public:
-  TileSet(const DirectoryPath& defaultDir, const DirectoryPath& modsDir);
+  TileSet(const DirectoryPath& defaultDir, const DirectoryPath& modsDir, const DirectoryPath& cacheDir);
   void setTilePaths(const TilePaths&);
   const TilePaths& getTilePaths() const;
   void reload();
@@ -31,6 +33,7 @@ class TileSet {
   optional<TilePaths> tilePaths;
   DirectoryPath defaultDir;
   DirectoryPath modsDir;
+  DirectoryPath cacheDir;
   friend class TileCoordLookup;
   void addTile(string, Tile);
   void addSymbol(string, Tile);
@@ -39,7 +42,7 @@ class TileSet {
   vector<unique_ptr<Texture>> textures;
   map<string, vector<TileCoord>> tileCoords;
   vector<string> spriteMods;
-  bool loadTilesFromDir(const DirectoryPath&, Vec2 size, bool overwrite);
+  void loadAtlas(const TileAtlasCache&);
   void loadTiles();
   void loadUnicode();
   const vector<TileCoord>& byName(const string&);
@@ -109,7 +109,8 @@ enum class UserInputId {
     PAY_DEBT,
     APPLY_EFFECT,
     CREATE_ITEM,
-    SUMMON_ENEMY
+    SUMMON_ENEMY,
+    MEMORY_REPORT
 };
 
 struct CreatureDropInfo {
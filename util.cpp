@@ -19,8 +19,24 @@
 #include "position.h"
 #include <time.h>
 
+static thread_local RandomGen* threadRandom = nullptr;
+
+RandomGen::ThreadOverride::ThreadOverride(RandomGen& random) : previous(threadRandom) {
+  threadRandom = &random;
+}
+
+RandomGen::ThreadOverride::~ThreadOverride() {
+  threadRandom = previous;
+}
+
+default_random_engine& RandomGen::getGenerator() {
+  if (threadRandom && this == &Random)
+    return threadRandom->generator;
+  return generator;
+}
+
 void RandomGen::init(int seed) {
-  generator.seed(seed);
+  getGenerator().seed(seed);
 }
 
 int RandomGen::get(int max) {
@@ -28,7 +44,7 @@ int RandomGen::get(int max) {
 }
 
 long long RandomGen::getLL() {
-  return uniform_int_distribution<long long>(-(1LL << 62), 1LL << 62)(generator);
+  return uniform_int_distribution<long long>(-(1LL << 62), 1LL << 62)(getGenerator());
 }
 
 int RandomGen::get(Range r) {
@@ -37,7 +53,7 @@ int RandomGen::get(Range r) {
 
 int RandomGen::get(int min, int max) {
   CHECK(max > min);
-  return uniform_int_distribution<int>(min, max - 1)(generator);
+  return uniform_int_distribution<int>(min, max - 1)(getGenerator());
 }
 
 std::string operator "" _s(const char* str, size_t) { 
@@ -85,11 +101,11 @@ bool RandomGen::chance(float v) {
 }
 
 double RandomGen::getDouble() {
-  return defaultDist(generator);
+  return defaultDist(getGenerator());
 }
 
 double RandomGen::getDouble(double a, double b) {
-  return uniform_real_distribution<double>(a, b)(generator);
+  return uniform_real_distribution<double>(a, b)(getGenerator());
 }
 
 pair<float, float> RandomGen::getFloat2Fast() {
@@ -101,7 +117,7 @@ pair<float, float> RandomGen::getFloat2Fast() {
 }
 
 float RandomGen::getFloat(float a, float b) {
-  return uniform_real_distribution<float>(a, b)(generator);
+  return uniform_real_distribution<float>(a, b)(getGenerator());
 }
 
 float RandomGen::getFloatFast(float a, float b) {
@@ -235,8 +251,15 @@ const vector<Vec2>& Vec2::directions8() {
 }
 
 vector<Vec2> Vec2::neighbors8() const {
-  return {Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y), Vec2(x + 1, y + 1), Vec2(x + 1, y - 1),
-      Vec2(x - 1, y - 1), Vec2(x - 1, y + 1)};
+  return fixedNeighbors8().asVector();
+}
+
+StaticVector<Vec2, 8> Vec2::fixedNeighbors8() const {
+  StaticVector<Vec2, 8> ret;
+  for (Vec2 v : {Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y), Vec2(x + 1, y + 1),
+      Vec2(x + 1, y - 1), Vec2(x - 1, y - 1), Vec2(x - 1, y + 1)})
+    ret.push_back(v);
+  return ret;
 }
 
 static const vector<Vec2> dir4 {
@@ -248,7 +271,14 @@ const vector<Vec2>& Vec2::directions4() {
 }
 
 vector<Vec2> Vec2::neighbors4() const {
-  return { Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y)};
+  return fixedNeighbors4().asVector();
+}
+
+StaticVector<Vec2, 4> Vec2::fixedNeighbors4() const {
+  StaticVector<Vec2, 4> ret;
+  for (Vec2 v : {Vec2(x, y + 1), Vec2(x + 1, y), Vec2(x, y - 1), Vec2(x - 1, y)})
+    ret.push_back(v);
+  return ret;
 }
 
 vector<Vec2> Vec2::directions8(RandomGen& random) {
@@ -256,7 +286,15 @@ vector<Vec2> Vec2::directions8(RandomGen& random) {
 }
 
 vector<Vec2> Vec2::neighbors8(RandomGen& random) const {
-  return random.permutation(neighbors8());
+  return fixedNeighbors8(random).asVector();
+}
+
+// Shuffles in place with the same generator as RandomGen::permutation, so the order is the same as with the
+// allocating versions.
+StaticVector<Vec2, 8> Vec2::fixedNeighbors8(RandomGen& random) const {
+  auto ret = fixedNeighbors8();
+  random.shuffle(ret.begin(), ret.end());
+  return ret;
 }
 
 vector<Vec2> Vec2::directions4(RandomGen& random) {
@@ -264,7 +302,13 @@ vector<Vec2> Vec2::directions4(RandomGen& random) {
 }
 
 vector<Vec2> Vec2::neighbors4(RandomGen& random) const {
-  return random.permutation(neighbors4());
+  return fixedNeighbors4(random).asVector();
+}
+
+StaticVector<Vec2, 4> Vec2::fixedNeighbors4(RandomGen& random) const {
+  auto ret = fixedNeighbors4();
+  random.shuffle(ret.begin(), ret.end());
+  return ret;
 }
 
 bool Vec2::isCardinal4() const {
@@ -171,6 +171,12 @@ class Vec2 {
   static vector<Vec2> corners();
   static vector<set<Vec2>> calculateLayers(set<Vec2>);
 
+  // Same as the functions above, in the same order, but without allocating.
+  StaticVector<Vec2, 8> fixedNeighbors8() const;
+  StaticVector<Vec2, 4> fixedNeighbors4() const;
+  StaticVector<Vec2, 8> fixedNeighbors8(RandomGen&) const;
+  StaticVector<Vec2, 4> fixedNeighbors4(RandomGen&) const;
+
   typedef function<Vec2(Vec2)> LinearMap;
 
   template <class Archive>
@@ -753,13 +759,13 @@ class RandomGen {
 
   template <typename T>
   vector<T> permutation(vector<T> v) {
-    std::shuffle(v.begin(), v.end(), generator);
+    std::shuffle(v.begin(), v.end(), getGenerator());
     return v;
   }
 
   template <typename Iterator>
   void shuffle(Iterator begin, Iterator end) {
-    std::shuffle(begin, end, generator);
+    std::shuffle(begin, end, getGenerator());
   }
 
   template <typename T>
@@ -808,7 +814,22 @@ class RandomGen {
     return chooseImpl(std::forward<T>(first), 2, std::forward<T>(second), std::forward<Args>(rest)...);
   }
 
+  /* While an instance is alive, the global Random uses the given generator in the current thread. Simulations
+     that run in parallel get their own deterministic random streams this way, without passing a generator
+     around. Other generators aren't affected. */
+  class ThreadOverride {
+    public:
+    ThreadOverride(RandomGen&);
+    ~ThreadOverride();
+    ThreadOverride(const ThreadOverride&) = delete;
+    ThreadOverride& operator = (const ThreadOverride&) = delete;
+
+    private:
+    RandomGen* previous;
+  };
+
   private:
+  default_random_engine& getGenerator();
   default_random_engine generator;
   std::uniform_real_distribution<double> defaultDist;
 
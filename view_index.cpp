@@ -28,6 +28,20 @@ ViewIndex::ViewIndex() {
 ViewIndex::~ViewIndex() {
 }
 
+bool ViewIndex::operator == (const ViewIndex& o) const {
+  return objIndex == o.objIndex && objects == o.objects && highlights == o.highlights && gradients == o.gradients &&
+      anyHighlight == o.anyHighlight && hiddenId == o.hiddenId && !itemCounts == !o.itemCounts &&
+      (!itemCounts || *itemCounts == *o.itemCounts);
+}
+
+bool ViewIndex::operator != (const ViewIndex& o) const {
+  return !(*this == o);
+}
+
+size_t ViewIndex::getHash() const {
+  return combineHash(objects, highlights);
+}
+
 void ViewIndex::insert(ViewObject obj) {
   PROFILE;
   int ind = objIndex[int(obj.layer())];
@@ -82,6 +82,10 @@ class ViewIndex {
   ItemCounts& modItemCounts();
   ItemCounts& modEquipmentCounts();
 
+  bool operator == (const ViewIndex&) const;
+  bool operator != (const ViewIndex&) const;
+  size_t getHash() const;
+
   template <class Archive> 
   void serialize(Archive& ar, const unsigned int version);
 
@@ -0,0 +1,59 @@
+#include "stdafx.h"
+#include "view_index_cache.h"
+#include "view_index.h"
+#include "view_object.h"
+#include "creature.h"
+#include "perf_counters.h"
+#include "memory_report.h"
+
+struct ViewIndexCache::Entry {
+  unsigned generation;
+  optional<unsigned> viewerStamp;
+  optional<Creature::Id> viewer;
+  ViewIndex index;
+};
+
+ViewIndexCache::ViewIndexCache(Rectangle bounds) : generations(bounds, 0), entries(bounds) {
+}
+
+ViewIndexCache::~ViewIndexCache() {
+}
+
+void ViewIndexCache::invalidate(Vec2 pos) {
+  if (pos.inRectangle(generations.getBounds()))
+    ++generations[pos];
+}
+
+static optional<Creature::Id> getViewerId(const Creature* viewer) {
+  if (viewer)
+    return viewer->getUniqueId();
+  return none;
+}
+
+const ViewIndex* ViewIndexCache::get(Vec2 pos, const Creature* viewer,
+    const function<unsigned()>& getViewerStamp) const {
+  auto& entry = entries[pos];
+  if (entry && entry->generation == generations[pos] && (!entry->viewerStamp ||
+      (entry->viewer == getViewerId(viewer) && *entry->viewerStamp == getViewerStamp()))) {
+    PerfCounters::add(PerfCounter::VIEW_INDEX_CACHE_HITS);
+    return &entry->index;
+  }
+  PerfCounters::add(PerfCounter::VIEW_INDEX_CACHE_MISSES);
+  return nullptr;
+}
+
+long long ViewIndexCache::getMemoryUsage() const {
+  long long ret = ::getMemoryUsage(generations) + ::getMemoryUsage(entries);
+  for (Vec2 v : entries.getBounds())
+    if (entries[v])
+      ret += sizeof(Entry);
+  return ret;
+}
+
+void ViewIndexCache::set(Vec2 pos, const Creature* viewer, optional<unsigned> viewerStamp, const ViewIndex& index) {
+  auto& entry = entries[pos];
+  if (!entry)
+    entry = unique<Entry>(Entry{generations[pos], viewerStamp, getViewerId(viewer), index});
+  else
+    *entry = Entry{generations[pos], viewerStamp, getViewerId(viewer), index};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "util.h"
+#include "unique_entity.h"
+
+class ViewIndex;
+class Creature;
+
+/* Caches the part of Position::getViewIndex that only changes together with the contents of a tile: the items
+   and the furniture. Every tile has a generation number that is bumped whenever something on it changes, and a
+   cached index is valid as long as it was built at the current generation. Most tiles look the same to every
+   viewer, so their index is shared by all viewers. Tiles with furniture that only some creatures can see,
+   such as traps, are cached for a single viewer together with a stamp of what that viewer could see, because
+   that can change while the tile stays the same. */
+class ViewIndexCache {
+  public:
+  ViewIndexCache(Rectangle bounds);
+  ~ViewIndexCache();
+  void invalidate(Vec2);
+  // getViewerStamp is only called for tiles cached with a stamp, and the entry is used if it returns the same one.
+  const ViewIndex* get(Vec2, const Creature* viewer, const function<unsigned()>& getViewerStamp) const;
+  // The stamp is none if the tile looks the same to every viewer.
+  void set(Vec2, const Creature* viewer, optional<unsigned> viewerStamp, const ViewIndex&);
+  long long getMemoryUsage() const;
+
+  private:
+  struct Entry;
+  Table<unsigned> generations;
+  Table<unique_ptr<Entry>> entries;
+};
@@ -44,6 +44,22 @@ ViewObject::ViewObject(ViewId id, ViewLayer l)
     attributes[a] = noAttributeValue;
 }
 
+bool ViewObject::operator == (const ViewObject& o) const {
+  return resource_id == o.resource_id && viewLayer == o.viewLayer && modifiers == o.modifiers && status == o.status &&
+      attributes == o.attributes && description == o.description && attachmentDir == o.attachmentDir &&
+      genericId == o.genericId && goodAdjectives == o.goodAdjectives && badAdjectives == o.badAdjectives &&
+      creatureAttributes == o.creatureAttributes && clickAction == o.clickAction &&
+      extendedActions == o.extendedActions && particleEffects == o.particleEffects;
+}
+
+bool ViewObject::operator != (const ViewObject& o) const {
+  return !(*this == o);
+}
+
+size_t ViewObject::getHash() const {
+  return combineHash(resource_id, viewLayer, modifiers, genericId, description);
+}
+
 void ViewObject::setGenericId(GenericId id) {
   CHECK(id != 0);
   genericId = id;
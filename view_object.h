@@ -84,6 +84,11 @@ class ViewObject {
   void setExtendedActions(EnumSet<ViewObjectAction>);
   const EnumSet<ViewObjectAction>& getExtendedActions() const;
 
+  // Compares everything except for the movement info.
+  bool operator == (const ViewObject&) const;
+  bool operator != (const ViewObject&) const;
+  size_t getHash() const;
+
   SERIALIZATION_DECL(ViewObject)
 
   EnumSet<FXVariantName> particleEffects;
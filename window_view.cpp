@@ -41,6 +41,7 @@
 #include "draw_line.h"
 #include "tileset.h"
 #include "target_type.h"
+#include "perf_counters.h"
 
 using SDL::SDL_Keysym;
 using SDL::SDL_Keycode;
@@ -373,6 +374,7 @@ void WindowView::rebuildMinimapGui() {
 
 void WindowView::rebuildGui() {
   INFO << "Rebuilding UI";
+  gameInfo.updateChangeStamps();
   rebuildMinimapGui();
   mapGui->setBounds(getMapGuiBounds());
   SGuiElem bottom, right;
@@ -423,7 +425,7 @@ void WindowView::rebuildGui() {
   }
   guiBuilder.drawOverlays(overlays, gameInfo);
   if (rightBarWidth > 0) {
-    overlays.push_back({guiBuilder.drawMessages(gameInfo.messageBuffer, renderer.getSize().x - rightBarWidth),
+    overlays.push_back({guiBuilder.drawMessages(gameInfo, renderer.getSize().x - rightBarWidth),
                        GuiBuilder::OverlayInfo::MESSAGES});
     for (auto& overlay : overlays)
       if (overlay.alignment != GuiBuilder::OverlayInfo::GAME_SPEED) {
@@ -550,6 +552,7 @@ void WindowView::updateView(CreatureView* view, bool noRefresh) {
   ScopeTimer timer("UpdateView timer");
   if (!wasRendered && currentThreadId() != renderThreadId)
     return;
+  PerfTimer perfTimer(PerfCounter::GUI_UPDATE_TIME);
   gameInfo = {};
   view->refreshGameInfo(gameInfo);
   if (gameInfo.infoType != GameInfo::InfoType::BAND)
@@ -639,7 +642,41 @@ static Rectangle getBugReportPos(Renderer& renderer) {
   return Rectangle(renderer.getSize() - Vec2(100, 23), renderer.getSize());
 }
 
+void WindowView::drawPerformanceOverlay() {
+  const int width = 2 * PerfCounters::historySize + 20;
+  const int rowHeight = 44;
+  const int graphHeight = 20;
+  Vec2 origin = renderer.getSize() - Vec2(width + 10, rowHeight * EnumInfo<PerfCounter>::size + 40);
+  renderer.drawFilledRectangle(Rectangle(origin, origin + Vec2(width, rowHeight * EnumInfo<PerfCounter>::size)),
+      Color(0, 0, 0, 200), Color::GRAY);
+  for (auto counter : ENUM_ALL(PerfCounter)) {
+    Vec2 pos = origin + Vec2(10, 4 + rowHeight * int(counter));
+    auto history = PerfCounters::getHistory(counter);
+    long long maxValue = 0;
+    long long total = 0;
+    for (auto value : history) {
+      maxValue = max(maxValue, value);
+      total += value;
+    }
+    double average = history.empty() ? 0 : double(total) / history.size();
+    string text = PerfCounters::getName(counter) + ": "_s;
+    if (PerfCounters::isTime(counter))
+      text += toString(round(average / 100) / 10) + " ms, max " + toString(round(maxValue / 100.0) / 10) + " ms";
+    else
+      text += toString(int(round(average))) + ", max " + toString(maxValue);
+    renderer.drawText(Color::WHITE, pos, text, Renderer::NONE, 14);
+    Vec2 graphPos = pos + Vec2(0, rowHeight - 4 - graphHeight);
+    for (int i : All(history))
+      if (maxValue > 0 && history[i] > 0) {
+        int height = max<int>(1, history[i] * graphHeight / maxValue);
+        renderer.drawFilledRectangle(Rectangle(graphPos + Vec2(2 * i, graphHeight - height),
+            graphPos + Vec2(2 * i + 2, graphHeight)), Color::GREEN);
+      }
+  }
+}
+
 void WindowView::refreshScreen(bool flipBuffer) {
+  PerfTimer timer(PerfCounter::RENDER_TIME);
   {
     if (zoomUI > -1) {
       renderer.setZoom(zoomUI ? 2 : 1);
@@ -656,8 +693,11 @@ void WindowView::refreshScreen(bool flipBuffer) {
   auto bugReportPos = getBugReportPos(renderer);
   renderer.drawFilledRectangle(bugReportPos, Color::TRANSPARENT, Color::RED);
   renderer.drawText(Color::RED, bugReportPos.middle() - Vec2(0, 2), "report bug", Renderer::CenterType::HOR_VER);
+  if (showPerformanceOverlay)
+    drawPerformanceOverlay();
   if (flipBuffer)
     renderer.drawAndClearBuffer();
+  PerfCounters::endFrame();
 }
 
 int indexHeight(const vector<ListElem>& options, int index) {
@@ -1355,6 +1395,9 @@ void WindowView::keyboardAction(const SDL_Keysym& key) {
     case SDL::SDLK_F9:
       inputQueue.push(UserInputId::CHEAT_ATTRIBUTES);
       break;
+    case SDL::SDLK_F5:
+      inputQueue.push(UserInputId::MEMORY_REPORT);
+      break;
     case SDL::SDLK_F8:
       //renderer.startMonkey();
       renderer.loadAnimations();
@@ -1362,12 +1405,27 @@ void WindowView::keyboardAction(const SDL_Keysym& key) {
       fxRenderer->loadTextures();
       gui.loadImages();
       break;
+#ifndef EASY_PROFILER
+    case SDL::SDLK_F6:
+      if (Profiler::isEnabled()) {
+        Profiler::setEnabled(false);
+        Profiler::dumpToFiles();
+        presentText("Profiler", "Profile written to profile.json and profile.txt");
+      } else {
+        Profiler::clear();
+        Profiler::setEnabled(true);
+      }
+      break;
+#endif
     case SDL::SDLK_TAB:
       // TODO: put it under different shortcut?
       inputQueue.push(UserInputId::CHEAT_SPELLS);
       inputQueue.push(UserInputId::CHEAT_POTIONS);
       break;
 #endif
+    case SDL::SDLK_F3:
+      showPerformanceOverlay = !showPerformanceOverlay;
+      break;
     case SDL::SDLK_F7:
       presentList("", ListElem::convert(vector<string>(messageLog.begin(), messageLog.end())), true);
       break;
@@ -125,6 +125,8 @@ class WindowView: public View {
   void rebuildGui();
   int lastGuiHash = 0;
   void drawMap();
+  void drawPerformanceOverlay();
+  bool showPerformanceOverlay = false;
   void propagateEvent(const Event& event, vector<SGuiElem>);
   void keyboardAction(const SDL::SDL_Keysym&);
 
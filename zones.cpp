@@ -28,6 +28,7 @@ void Zones::setZone(Position pos, ZoneId id) {
   PROFILE;
   zones.getOrInit(pos).insert(id);
   positions[id].insert(pos);
+  ++version;
   pos.setNeedsRenderAndMemoryUpdate(true);
 }
 
@@ -35,6 +36,7 @@ void Zones::eraseZone(Position pos, ZoneId id) {
   PROFILE;
   zones.getOrInit(pos).erase(id);
   positions[id].erase(pos);
+  ++version;
   pos.setNeedsRenderAndMemoryUpdate(true);
 }
 
@@ -54,6 +56,10 @@ const PositionSet& Zones::getPositions(ZoneId id) const {
   return positions[id];
 }
 
+int Zones::getVersion() const {
+  return version;
+}
+
 static HighlightType getHighlight(ZoneId id) {
   switch (id) {
     case ZoneId::FETCH_ITEMS:
@@ -28,6 +28,8 @@ class Zones {
   void eraseZone(Position, ZoneId);
   void onDestroyOrder(Position);
   const PositionSet& getPositions(ZoneId) const;
+  // Changes whenever any zone is set or erased.
+  int getVersion() const;
   void setHighlights(Position, ViewIndex&) const;
   bool canSet(Position, ZoneId, WConstCollective) const;
   void tick();
@@ -37,4 +39,5 @@ class Zones {
   private:
   EnumMap<ZoneId, PositionSet> SERIAL(positions);
   PositionMap<EnumSet<ZoneId>> SERIAL(zones);
+  int version = 0;
 };